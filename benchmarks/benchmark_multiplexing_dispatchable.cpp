@@ -72,6 +72,52 @@ private:
 
 thread_local uint64_t TestDispatchable::dispatch_count = 0;
 
+/*
+ * One of many always-ready sources (think input devices or client sockets),
+ * each dispatched sequentially as MultiplexingDispatchable does by default.
+ */
+class SequentialDispatchable : public md::Dispatchable
+{
+public:
+    SequentialDispatchable(uint64_t limit)
+        : dispatch_limit{limit}
+    {
+        int pipefds[2];
+        if (pipe(pipefds) < 0)
+        {
+            throw std::system_error{errno, std::system_category(), "Failed to create pipe"};
+        }
+
+        read_fd = mir::Fd{pipefds[0]};
+        write_fd = mir::Fd{pipefds[1]};
+
+        char dummy{0};
+        if (::write(write_fd, &dummy, sizeof(dummy)) != sizeof(dummy))
+        {
+            throw std::system_error{errno, std::system_category(), "Failed to mark dispatchable"};
+        }
+    }
+
+    mir::Fd watch_fd() const override
+    {
+        return read_fd;
+    }
+    bool dispatch(md::FdEvents) override
+    {
+        ++dispatch_count;
+        return (dispatch_count < dispatch_limit);
+    }
+    md::FdEvents relevant_events() const override
+    {
+        return md::FdEvent::readable;
+    }
+
+private:
+    uint64_t dispatch_count{0};
+    uint64_t const dispatch_limit;
+    mir::Fd read_fd, write_fd;
+};
+
 bool fd_is_readable(int fd)
 {
     struct pollfd poller {
@@ -84,9 +130,10 @@ bool fd_is_readable(int fd)
 
 int main(int argc, char** argv)
 {
-    if (argc != 3)
+    if (argc != 3 && argc != 5)
     {
-        std::cout<<"Usage: "<<argv[0]<<" <number of threads> <dispatch count>"<<std::endl;
+        std::cout<<"Usage: "<<argv[0]<<" <number of threads> <dispatch count> [<number of sources> <events per dispatch>]"<<std::endl;
+        std::cout<<"  With no sources given, a single reentrant source is dispatched from every thread"<<std::endl;
         exit(1);
     }
 
@@ -94,7 +141,20 @@ int main(int argc, char** argv)
     uint64_t const dispatch_count = std::atoll(argv[2]);
 
     auto dispatcher = std::make_shared<md::MultiplexingDispatchable>();
-    dispatcher->add_watch(std::make_shared<TestDispatchable>(dispatch_count / thread_count), md::DispatchReentrancy::reentrant);
+    if (argc == 5)
+    {
+        int const source_count = std::atoi(argv[3]);
+        dispatcher->set_max_events_per_dispatch(std::atoi(argv[4]));
+
+        for (int i = 0; i < source_count; ++i)
+        {
+            dispatcher->add_watch(std::make_shared<SequentialDispatchable>(dispatch_count / source_count));
+        }
+    }
+    else
+    {
+        dispatcher->add_watch(std::make_shared<TestDispatchable>(dispatch_count / thread_count), md::DispatchReentrancy::reentrant);
+    }
 
     auto start = std::chrono::steady_clock::now();
 
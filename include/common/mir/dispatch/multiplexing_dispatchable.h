@@ -22,6 +22,8 @@
 #include "mir/dispatch/dispatchable.h"
 #include "mir/posix_rw_mutex.h"
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <initializer_list>
 #include <list>
@@ -29,6 +31,8 @@
 
 #include <pthread.h>
 
+struct epoll_event;
+
 namespace mir
 {
 namespace dispatch
@@ -94,9 +98,28 @@ public:
      * \param [in] fd   File descriptor of watch to remove.
      */
     void remove_watch(Fd const& fd);
+
+    /**
+     * \brief Set how many ready dispatchees a single dispatch() may service
+     *
+     * Servicing several ready dispatchees per call saves an epoll_wait() and
+     * a trip through the caller's loop for each, at the cost of them being
+     * serviced one after another on the calling thread rather than spread
+     * across all the threads dispatching this adaptor. The default is 1.
+     *
+     * \param [in] max_events  Clamped to [1, max_dispatch_batch]
+     */
+    void set_max_events_per_dispatch(int max_events);
+
+    static int constexpr max_dispatch_batch{64};
 private:
+    bool is_watched(std::shared_ptr<Dispatchable> const& dispatchee);
+    void rearm(std::shared_ptr<Dispatchable> const& dispatchee, epoll_event& event);
+
     PosixRWMutex lifetime_mutex;
     std::list<std::pair<std::shared_ptr<Dispatchable>, bool>> dispatchee_holder;
+    std::atomic<int> max_events_per_dispatch{1};
+    std::atomic<uint64_t> removal_count{0};
 
     Fd epoll_fd;
 };
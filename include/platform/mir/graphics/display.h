@@ -24,6 +24,7 @@
 #include <memory>
 #include <functional>
 #include <chrono>
+#include <thread>
 
 namespace mir
 {
@@ -79,6 +80,25 @@ public:
     virtual std::chrono::milliseconds recommended_sleep() const = 0;
 
     virtual ~DisplaySyncGroup() = default;
+
+    /**
+     * Called by the compositor as it starts on a frame, before it samples
+     * the scene. Platforms that estimate how long frames take to render
+     * (see recommended_sleep()) measure from here.
+     */
+    virtual void begin_frame() {}
+
+    /**
+     * Called by the compositor after post(), and returns when it is time to
+     * start on the next frame. The default sleeps for recommended_sleep();
+     * platforms that know when the posted frame reached the screen can wait
+     * for that, and then until a deadline measured from it.
+     */
+    virtual void wait_for_frame_deadline()
+    {
+        std::this_thread::sleep_for(recommended_sleep());
+    }
+
 protected:
     DisplaySyncGroup() = default;
     DisplaySyncGroup(DisplaySyncGroup const&) = delete;
@@ -49,6 +49,15 @@ protected:
     virtual ~DisplayReport() = default;
     DisplayReport(const DisplayReport&) = delete;
     DisplayReport& operator=(const DisplayReport&) = delete;
+
+public:
+    /**
+     * A frame composited on the calling thread has been submitted to the output, and will be
+     * shown from the next report_vsync() for that output.
+     *
+     * Must be reported before that vsync can be.
+     */
+    virtual void report_frame_posted(unsigned int /*output_id*/) {}
 };
 
 }
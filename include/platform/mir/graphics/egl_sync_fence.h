@@ -0,0 +1,75 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GRAPHICS_EGL_SYNC_FENCE_H_
+#define MIR_GRAPHICS_EGL_SYNC_FENCE_H_
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+namespace mir
+{
+namespace graphics
+{
+/**
+ * A fence after the GL commands issued so far in the current context
+ *
+ * The fence is an EGL_KHR_fence_sync object. Where the implementation has none,
+ * the constructor waits for the commands with glFinish() instead, and every wait
+ * on the fence returns at once.
+ */
+class EGLSyncFence
+{
+public:
+    /**
+     * Fence the commands issued so far, and flush them so that other contexts can wait for them
+     *
+     * \note This must be called with a current GL context
+     */
+    EGLSyncFence();
+    ~EGLSyncFence() noexcept;
+
+    /// Block until the fenced commands have completed
+    void client_wait() const;
+
+    /// Whether the fenced commands have completed, without blocking
+    auto signalled() const -> bool;
+
+    /**
+     * Make the GPU wait for the fenced commands before it runs any issued later in the current context
+     *
+     * Without EGL_KHR_wait_sync this blocks, like client_wait().
+     *
+     * \note This must be called with a current GL context
+     */
+    void server_wait() const;
+
+    EGLSyncFence(EGLSyncFence const&) = delete;
+    EGLSyncFence& operator=(EGLSyncFence const&) = delete;
+
+private:
+    PFNEGLCREATESYNCKHRPROC const eglCreateSyncKHR;
+    PFNEGLDESTROYSYNCKHRPROC const eglDestroySyncKHR;
+    PFNEGLCLIENTWAITSYNCKHRPROC const eglClientWaitSyncKHR;
+    PFNEGLWAITSYNCKHRPROC const eglWaitSyncKHR;
+
+    EGLDisplay const display;
+    EGLSyncKHR const sync;
+};
+}
+}
+
+#endif /* MIR_GRAPHICS_EGL_SYNC_FENCE_H_ */
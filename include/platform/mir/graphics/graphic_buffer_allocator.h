@@ -20,6 +20,7 @@
 #define MIR_GRAPHICS_GRAPHIC_BUFFER_ALLOCATOR_H_
 
 #include "mir/graphics/buffer.h"
+#include "mir/geometry/rectangles.h"
 
 #include <vector>
 #include <memory>
@@ -90,6 +91,23 @@ public:
         std::shared_ptr<mir::Executor> wayland_executor,
         std::function<void()>&& on_consumed) -> std::shared_ptr<Buffer> = 0;
 
+    /**
+     * Import an shm buffer whose content differs from the surface's previous buffer only within \a damage
+     *
+     * Allocators may use the damage to copy less of the buffer ahead of it being rendered. By
+     * default it is ignored.
+     *
+     * \param damage [in] The changed region, in buffer coordinates
+     */
+    virtual auto buffer_from_shm(
+        wl_resource* buffer,
+        std::shared_ptr<mir::Executor> wayland_executor,
+        std::function<void()>&& on_consumed,
+        geometry::Rectangles const& /*damage*/) -> std::shared_ptr<Buffer>
+    {
+        return buffer_from_shm(buffer, std::move(wayland_executor), std::move(on_consumed));
+    }
+
 protected:
     GraphicBufferAllocator() = default;
     GraphicBufferAllocator(const GraphicBufferAllocator&) = delete;
@@ -21,6 +21,8 @@
 
 #include <experimental/optional>
 #include <mir/geometry/rectangle.h>
+#include <mir/geometry/rectangles.h>
+#include <mir/graphics/buffer_id.h>
 #include <glm/glm.hpp>
 #include <memory>
 #include <vector>
@@ -73,6 +75,35 @@ public:
     virtual bool shaped() const = 0;  // meaning the pixel format has alpha
 
     virtual unsigned int swap_interval() const = 0;
+
+    /**
+     * The region of buffer() that has changed since the buffer identified
+     * by \a previous, in buffer coordinates.
+     *
+     * Returns nullopt if this can't be determined (for example because
+     * \a previous is too old to be remembered), in which case the whole
+     * renderable must be treated as damaged. That is also the default.
+     */
+    virtual std::experimental::optional<geometry::Rectangles>
+        buffer_damage_since(BufferID /*previous*/) const
+    {
+        return {};
+    }
+
+    /**
+     * The part of screen_position() the client guarantees is fully opaque,
+     * even if the buffer has an alpha channel, in screen coordinates.
+     *
+     * This says nothing about alpha(); a renderable that is blended with
+     * alpha() < 1 is never opaque.
+     *
+     * By default nothing is promised to be opaque beyond what !shaped()
+     * already implies.
+     */
+    virtual geometry::Rectangles opaque_region() const
+    {
+        return {};
+    }
 protected:
     Renderable() = default;
     Renderable(Renderable const&) = delete;
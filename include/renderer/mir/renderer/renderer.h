@@ -20,6 +20,7 @@
 #define MIR_RENDERER_RENDERER_H_
 
 #include "mir/geometry/rectangle.h"
+#include "mir/geometry/rectangles.h"
 #include "mir/graphics/renderable.h"
 #include "mir_toolkit/common.h"
 #include <glm/glm.hpp>
@@ -36,6 +37,14 @@ public:
 
     virtual void set_viewport(geometry::Rectangle const& rect) = 0;
     virtual void set_output_transform(glm::mat2 const&) = 0;
+    /**
+     * The parts of the viewport that have changed since the previous
+     * render(). This applies to the next render() only; if it is not
+     * called the whole viewport is assumed to have changed.
+     *
+     * Renderers that always redraw the whole viewport can ignore this.
+     */
+    virtual void set_damage(geometry::Rectangles const& /*damage*/) {}
     virtual void render(graphics::RenderableList const&) const = 0;
     virtual void suspend() = 0; // called when render() is skipped
 
@@ -45,6 +45,13 @@ public:
      * in preparation for drawing.
      */
     virtual void bind() = 0;
+    /**
+     * The number of frames since the current back buffer was last drawn
+     * (as for EGL_EXT_buffer_age), or 0 if its contents are undefined.
+     *
+     * Targets that can't tell report 0, forcing a full redraw.
+     */
+    virtual auto buffer_age() const -> int { return 0; }
 
 protected:
     RenderTarget() = default;
@@ -19,6 +19,8 @@
 #ifndef MIR_RENDERER_GL_TEXTURE_SOURCE_H_
 #define MIR_RENDERER_GL_TEXTURE_SOURCE_H_
 
+#include "mir/geometry/rectangles.h"
+
 namespace mir
 {
 namespace renderer
@@ -42,6 +44,10 @@ public:
     //are present during the draw. Will not upload texture.
     //should be called if an already uploaded texture is reused.
     virtual void secure_for_render() = 0;
+    //Uploads at least the damaged region (in buffer coordinates) of the texture.
+    //The bound texture must hold an earlier buffer of the same size and format,
+    //identical to this one outside of the damage.
+    virtual void bind_damaged(geometry::Rectangles const& /*damage*/) { bind(); }
 
 protected:
     TextureSource() = default;
@@ -68,6 +68,11 @@ inline MirEvent const& to_ref(MirEvent const& event)
     return event;
 }
 
+inline MirEvent const& to_ref(std::shared_ptr<MirEvent const> const& event)
+{
+    return *event;
+}
+
 inline MirKeyboardEvent const* maybe_key_event(MirEvent const* event)
 {
     if (mir_event_get_type(event) != mir_event_type_input)
@@ -31,6 +31,7 @@
 #include <string.h>
 #include <system_error>
 #include <algorithm>
+#include <array>
 
 namespace md = mir::dispatch;
 
@@ -108,48 +109,99 @@ bool md::MultiplexingDispatchable::dispatch(md::FdEvents events)
         return false;
     }
 
-    std::shared_ptr<md::Dispatchable> source;
-    bool rearm_source{false};
-    epoll_event event;
+    std::array<epoll_event, max_dispatch_batch> ready_events;
+    std::array<std::pair<std::shared_ptr<md::Dispatchable>, bool>, max_dispatch_batch> ready_sources;
+    int ready_count;
+    uint64_t removals_seen;
 
     {
         std::shared_lock<decltype(lifetime_mutex)> lock{lifetime_mutex};
 
-        auto result = epoll_wait(epoll_fd, &event, 1, 0);
+        ready_count = epoll_wait(epoll_fd, ready_events.data(), max_events_per_dispatch, 0);
 
-        if (result < 0)
+        if (ready_count < 0)
         {
             BOOST_THROW_EXCEPTION((std::system_error{errno,
                                                      std::system_category(),
                                                      "Failed to wait on fds"}));
         }
 
-        if (result == 0)
+        // If nothing is ready some other thread must have stolen the event
+        // we were woken for; that's ok, just return.
+
+        for (int i = 0; i != ready_count; ++i)
         {
-            // Some other thread must have stolen the event we were woken for;
-            // that's ok, just return.
-            return true;
+            auto event_source = reinterpret_cast<decltype(dispatchee_holder)::pointer>(ready_events[i].data.ptr);
+            ready_sources[i] = *event_source;
         }
-
-        auto event_source = reinterpret_cast<decltype(dispatchee_holder)::pointer>(event.data.ptr);
-
-        source = event_source->first;
-        rearm_source = event_source->second;
+        removals_seen = removal_count;
     }
 
-    if (!source->dispatch(epoll_to_fd_event(event)))
+    /*
+     * Service the batch in the order epoll reported it. Sequential dispatchees
+     * stay disarmed until their own turn is over, exactly as when they are
+     * dispatched singly; those we don't get to because of an exception need
+     * re-arming so they aren't lost.
+     */
+    int next = 0;
+    try
     {
-        remove_watch(source);
+        for (; next != ready_count; ++next)
+        {
+            auto const& source = ready_sources[next].first;
+            auto const rearm_source = ready_sources[next].second;
+
+            // An earlier dispatchee in this batch may have removed a later one
+            if (next != 0 && removal_count != removals_seen)
+            {
+                if (!is_watched(source))
+                    continue;
+            }
+
+            if (!source->dispatch(epoll_to_fd_event(ready_events[next])))
+            {
+                remove_watch(source);
+            }
+            else if (rearm_source)
+            {
+                rearm(source, ready_events[next]);
+            }
+        }
     }
-    else if (rearm_source)
+    catch (...)
     {
-        event.events = fd_event_to_epoll(source->relevant_events()) | EPOLLONESHOT;
-        epoll_ctl(epoll_fd, EPOLL_CTL_MOD, source->watch_fd(), &event);
+        while (++next < ready_count)
+        {
+            if (ready_sources[next].second)
+                rearm(ready_sources[next].first, ready_events[next]);
+        }
+        throw;
     }
 
     return true;
 }
 
+void md::MultiplexingDispatchable::rearm(std::shared_ptr<Dispatchable> const& dispatchee, epoll_event& event)
+{
+    event.events = fd_event_to_epoll(dispatchee->relevant_events()) | EPOLLONESHOT;
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, dispatchee->watch_fd(), &event);
+}
+
+bool md::MultiplexingDispatchable::is_watched(std::shared_ptr<Dispatchable> const& dispatchee)
+{
+    std::shared_lock<decltype(lifetime_mutex)> lock{lifetime_mutex};
+    return std::any_of(dispatchee_holder.begin(), dispatchee_holder.end(),
+        [&dispatchee](std::pair<std::shared_ptr<Dispatchable>,bool> const& candidate)
+        {
+            return candidate.first == dispatchee;
+        });
+}
+
+void md::MultiplexingDispatchable::set_max_events_per_dispatch(int max_events)
+{
+    max_events_per_dispatch = std::clamp(max_events, 1, max_dispatch_batch);
+}
+
 md::FdEvents md::MultiplexingDispatchable::relevant_events() const
 {
     return md::FdEvent::readable;
@@ -227,4 +279,5 @@ void md::MultiplexingDispatchable::remove_watch(Fd const& fd)
     {
         return candidate.first->watch_fd() == fd;
     });
+    ++removal_count;
 }
@@ -35,32 +35,207 @@
 
 #include <capnp/serialize.h>
 
+#include <algorithm>
+#include <stdexcept>
+
 
 namespace ml = mir::logging;
 
+namespace
+{
+void input_to_capnp(mir::events::InputEventData const& from, mir::capnp::InputEvent::Builder to)
+{
+    to.getDeviceId().setId(from.device_id);
+    to.getEventTime().setCount(from.event_time.count());
+    to.setModifiers(from.modifiers);
+    to.setCookie(::capnp::Data::Reader{from.cookie.data(), from.cookie.size()});
+    to.setWindowId(from.window_id);
+
+    switch (from.type)
+    {
+    case mir_input_event_type_key:
+    {
+        auto key = to.initKey();
+        key.setAction(static_cast<mir::capnp::KeyboardEvent::Action>(from.key_action));
+        key.setKeyCode(from.key_code);
+        key.setScanCode(from.scan_code);
+        key.setText(::capnp::Text::Reader{from.text.c_str(), from.text.size()});
+        break;
+    }
+    case mir_input_event_type_pointer:
+    {
+        auto ptr = to.initPointer();
+        ptr.setX(from.x);
+        ptr.setY(from.y);
+        ptr.setDx(from.dx);
+        ptr.setDy(from.dy);
+        ptr.setVscroll(from.vscroll);
+        ptr.setHscroll(from.hscroll);
+        ptr.setButtons(from.buttons);
+        ptr.setAction(static_cast<mir::capnp::PointerEvent::PointerAction>(from.pointer_action));
+        if (from.dnd_handle)
+            ptr.setDndHandle(::kj::ArrayPtr<uint8_t const>{from.dnd_handle->data(), from.dnd_handle->size()});
+        break;
+    }
+    case mir_input_event_type_touch:
+    {
+        using ContactType = mir::capnp::TouchScreenEvent::Contact;
+        auto touch = to.initTouch();
+        auto contacts = touch.initContacts(mir::capnp::TouchScreenEvent::MAX_COUNT);
+        touch.setCount(from.pointer_count);
+        for (size_t i = 0; i != from.pointer_count; ++i)
+        {
+            auto const& contact = from.contacts[i];
+            auto wire_contact = contacts[i];
+            wire_contact.setId(contact.touch_id);
+            wire_contact.setX(contact.x);
+            wire_contact.setY(contact.y);
+            wire_contact.setPressure(contact.pressure);
+            wire_contact.setTouchMajor(contact.touch_major);
+            wire_contact.setTouchMinor(contact.touch_minor);
+            wire_contact.setOrientation(contact.orientation);
+            wire_contact.setAction(static_cast<ContactType::TouchAction>(contact.action));
+            wire_contact.setToolType(static_cast<ContactType::ToolType>(contact.tooltype));
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+auto input_from_capnp(mir::capnp::InputEvent::Reader from) -> mir::events::InputEventData
+{
+    auto type = mir_input_event_type_key;
+    switch (from.which())
+    {
+    case mir::capnp::InputEvent::Which::KEY:
+        type = mir_input_event_type_key;
+        break;
+    case mir::capnp::InputEvent::Which::TOUCH:
+        type = mir_input_event_type_touch;
+        break;
+    case mir::capnp::InputEvent::Which::POINTER:
+        type = mir_input_event_type_pointer;
+        break;
+    default:
+        BOOST_THROW_EXCEPTION(std::runtime_error("Unknown input event type"));
+    }
+
+    mir::events::InputEventData to{type};
+    to.device_id = from.getDeviceId().getId();
+    to.event_time = std::chrono::nanoseconds{from.getEventTime().getCount()};
+    to.modifiers = from.getModifiers();
+    to.window_id = from.getWindowId();
+    auto const cookie = from.getCookie();
+    to.cookie.assign(cookie.begin(), cookie.end());
+
+    switch (type)
+    {
+    case mir_input_event_type_key:
+    {
+        auto const key = from.getKey();
+        to.key_action = static_cast<MirKeyboardAction>(key.getAction());
+        to.key_code = key.getKeyCode();
+        to.scan_code = key.getScanCode();
+        to.text = key.getText().cStr();
+        break;
+    }
+    case mir_input_event_type_pointer:
+    {
+        auto const ptr = from.getPointer();
+        to.x = ptr.getX();
+        to.y = ptr.getY();
+        to.dx = ptr.getDx();
+        to.dy = ptr.getDy();
+        to.vscroll = ptr.getVscroll();
+        to.hscroll = ptr.getHscroll();
+        to.buttons = ptr.getButtons();
+        to.pointer_action = static_cast<MirPointerAction>(ptr.getAction());
+        if (ptr.hasDndHandle())
+        {
+            auto const handle = ptr.getDndHandle();
+            to.dnd_handle.emplace();
+            // Can't use std::copy() as the CapnP iterators don't provide an iterator category
+            for (auto p = handle.begin(); p != handle.end(); ++p)
+                to.dnd_handle->push_back(*p);
+        }
+        break;
+    }
+    case mir_input_event_type_touch:
+    {
+        auto const touch = from.getTouch();
+        auto const contacts = touch.getContacts();
+        to.pointer_count = std::min<size_t>(
+            {touch.getCount(), contacts.size(), mir::events::InputEventData::max_touch_contacts});
+        for (size_t i = 0; i != to.pointer_count; ++i)
+        {
+            auto const wire_contact = contacts[i];
+            auto& contact = to.contacts[i];
+            contact.touch_id = wire_contact.getId();
+            contact.x = wire_contact.getX();
+            contact.y = wire_contact.getY();
+            contact.pressure = wire_contact.getPressure();
+            contact.touch_major = wire_contact.getTouchMajor();
+            contact.touch_minor = wire_contact.getTouchMinor();
+            contact.orientation = wire_contact.getOrientation();
+            contact.action = static_cast<MirTouchAction>(wire_contact.getAction());
+            contact.tooltype = static_cast<MirTouchTooltype>(wire_contact.getToolType());
+        }
+        break;
+    }
+    default:
+        break;
+    }
+
+    return to;
+}
+}
+
+MirEvent::MirEvent(mir::events::InputEventData const& input_data)
+    : event{nullptr},
+      input{input_data}
+{
+}
+
 MirEvent::MirEvent(MirEvent const& e)
+    : event{nullptr},
+      input{e.input}
 {
-    auto reader = e.event.asReader();
-    message.setRoot(reader);
-    event = message.getRoot<mir::capnp::Event>();
+    if (!input)
+    {
+        message.setRoot(e.event.asReader());
+        event = message.getRoot<mir::capnp::Event>();
+    }
 }
 
 MirEvent& MirEvent::operator=(MirEvent const& e)
 {
-    auto reader = e.event.asReader();
-    message.setRoot(reader);
-    event = message.getRoot<mir::capnp::Event>();
+    input = e.input;
+    if (!input)
+    {
+        auto reader = e.event.asReader();
+        message.setRoot(reader);
+        event = message.getRoot<mir::capnp::Event>();
+    }
     return *this;
 }
 
 // TODO Look at replacing the surface event serializer with a capnproto layer
 mir::EventUPtr MirEvent::deserialize(std::string const& bytes)
 {
-    auto e = mir::EventUPtr(new MirEvent, [](MirEvent* ev) { delete ev; });
     kj::ArrayPtr<::capnp::word const> words(reinterpret_cast<::capnp::word const*>(
         bytes.data()), bytes.size() / sizeof(::capnp::word));
 
-    initMessageBuilderFromFlatArrayCopy(words, e->message);
+    ::capnp::FlatArrayMessageReader reader{words};
+    auto const root = reader.getRoot<mir::capnp::Event>();
+    if (root.which() == mir::capnp::Event::Which::INPUT)
+    {
+        return mir::EventUPtr(new MirEvent{input_from_capnp(root.getInput())}, [](MirEvent* ev) { delete ev; });
+    }
+
+    auto e = mir::EventUPtr(new MirEvent, [](MirEvent* ev) { delete ev; });
+    e->message.setRoot(root);
     e->event = e->message.getRoot<mir::capnp::Event>();
 
     return e;
@@ -68,7 +243,14 @@ mir::EventUPtr MirEvent::deserialize(std::string const& bytes)
 
 std::string MirEvent::serialize(MirEvent const* event)
 {
-    std::string output;
+    if (event->input)
+    {
+        ::capnp::MallocMessageBuilder message;
+        input_to_capnp(*event->input, message.initRoot<mir::capnp::Event>().initInput());
+        auto flat_event = ::capnp::messageToFlatArray(message);
+        return {reinterpret_cast<char*>(flat_event.asBytes().begin()), flat_event.asBytes().size()};
+    }
+
     auto flat_event = ::capnp::messageToFlatArray(const_cast<MirEvent*>(event)->message);
 
     return {reinterpret_cast<char*>(flat_event.asBytes().begin()), flat_event.asBytes().size()};
@@ -76,6 +258,9 @@ std::string MirEvent::serialize(MirEvent const* event)
 
 MirEventType MirEvent::type() const
 {
+    if (input)
+        return mir_event_type_input;
+
     switch (event.asReader().which())
     {
     case mir::capnp::Event::Which::INPUT:
@@ -22,56 +22,47 @@
 #include "mir/events/pointer_event.h"
 #include "mir/events/touch_event.h"
 
-#include <stdlib.h>
-
-MirInputEvent::MirInputEvent(MirInputDeviceId dev,
+MirInputEvent::MirInputEvent(MirInputEventType type,
+                             MirInputDeviceId dev,
                              std::chrono::nanoseconds et,
                              MirInputEventModifiers mods,
                              std::vector<uint8_t> const& cookie)
+    : MirEvent(mir::events::InputEventData{type})
 {
-    event.initInput();
-    auto input = event.getInput();
-    input.getDeviceId().setId(dev);
-    input.getEventTime().setCount(et.count());
-    input.setModifiers(mods);
+    input->device_id = dev;
+    input->event_time = et;
+    input->modifiers = mods;
+    input->cookie = cookie;
+}
 
-    ::capnp::Data::Reader cookie_data(cookie.data(), cookie.size());
-    input.setCookie(cookie_data);
+MirInputEvent::MirInputEvent(MirInputEventType type)
+    : MirEvent(mir::events::InputEventData{type})
+{
 }
 
 MirInputEventType MirInputEvent::input_type() const
 {
-    switch (event.asReader().getInput().which())
-    {
-    case mir::capnp::InputEvent::Which::KEY:
-        return mir_input_event_type_key;
-    case mir::capnp::InputEvent::Which::TOUCH:
-        return mir_input_event_type_touch;
-    case mir::capnp::InputEvent::Which::POINTER:
-        return mir_input_event_type_pointer;
-    default:
-        abort();
-    }
+    return input->type;
 }
 
 int MirInputEvent::window_id() const
 {
-    return event.asReader().getInput().getWindowId();
+    return input->window_id;
 }
 
 void MirInputEvent::set_window_id(int id)
 {
-    event.getInput().setWindowId(id);
+    input->window_id = id;
 }
 
 MirInputDeviceId MirInputEvent::device_id() const
 {
-    return event.asReader().getInput().getDeviceId().getId();
+    return input->device_id;
 }
 
 void MirInputEvent::set_device_id(MirInputDeviceId id)
 {
-    event.getInput().getDeviceId().setId(id);
+    input->device_id = id;
 }
 
 MirKeyboardEvent* MirInputEvent::to_keyboard()
@@ -106,35 +97,30 @@ MirTouchEvent const* MirInputEvent::to_touch() const
 
 std::chrono::nanoseconds MirInputEvent::event_time() const
 {
-    return std::chrono::nanoseconds{event.asReader().getInput().getEventTime().getCount()};
+    return input->event_time;
 }
 
 void MirInputEvent::set_event_time(std::chrono::nanoseconds const& event_time)
 {
-    event.getInput().getEventTime().setCount(event_time.count());
+    input->event_time = event_time;
 }
 
 std::vector<uint8_t> MirInputEvent::cookie() const
 {
-    auto cookie = event.asReader().getInput().getCookie();
-    std::vector<uint8_t> vec_cookie(cookie.size());
-    std::copy(std::begin(cookie), std::end(cookie), std::begin(vec_cookie));
-
-    return vec_cookie;
+    return input->cookie;
 }
 
 void MirInputEvent::set_cookie(std::vector<uint8_t> const& cookie)
 {
-    ::capnp::Data::Reader cookie_data(cookie.data(), cookie.size());
-    event.getInput().setCookie(cookie_data);
+    input->cookie = cookie;
 }
 
 MirInputEventModifiers MirInputEvent::modifiers() const
 {
-    return event.asReader().getInput().getModifiers();
+    return input->modifiers;
 }
 
 void MirInputEvent::set_modifiers(MirInputEventModifiers modifiers)
 {
-    event.getInput().setModifiers(modifiers);
+    input->modifiers = modifiers;
 }
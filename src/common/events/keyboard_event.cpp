@@ -20,47 +20,46 @@
 #include "mir/events/keyboard_event.h"
 
 MirKeyboardEvent::MirKeyboardEvent()
+    : MirInputEvent(mir_input_event_type_key)
 {
-    event.initInput();
-    event.getInput().initKey();
 }
 
 MirKeyboardAction MirKeyboardEvent::action() const
 {
-    return static_cast<MirKeyboardAction>(event.asReader().getInput().getKey().getAction());
+    return input->key_action;
 }
 
 void MirKeyboardEvent::set_action(MirKeyboardAction action)
 {
-    event.getInput().getKey().setAction(static_cast<mir::capnp::KeyboardEvent::Action>(action));
+    input->key_action = action;
 }
 
 int32_t MirKeyboardEvent::key_code() const
 {
-    return event.asReader().getInput().getKey().getKeyCode();
+    return input->key_code;
 }
 
 void MirKeyboardEvent::set_key_code(int32_t key_code)
 {
-    event.getInput().getKey().setKeyCode(key_code);
+    input->key_code = key_code;
 }
 
 int32_t MirKeyboardEvent::scan_code() const
 {
-    return event.asReader().getInput().getKey().getScanCode();
+    return input->scan_code;
 }
 
 void MirKeyboardEvent::set_scan_code(int32_t scan_code)
 {
-    event.getInput().getKey().setScanCode(scan_code);
+    input->scan_code = scan_code;
 }
 
 char const* MirKeyboardEvent::text() const
 {
-    return event.asReader().getInput().getKey().getText().cStr();
+    return input->text.c_str();
 }
 
 void MirKeyboardEvent::set_text(char const* str)
 {
-    event.getInput().getKey().setText(str);
+    input->text = str;
 }
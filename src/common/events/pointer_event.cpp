@@ -22,9 +22,8 @@
 #include <boost/throw_exception.hpp>
 
 MirPointerEvent::MirPointerEvent()
+    : MirInputEvent(mir_input_event_type_pointer)
 {
-    event.initInput();
-    event.getInput().initPointer();
 }
 
 MirPointerEvent::MirPointerEvent(MirInputDeviceId dev,
@@ -39,105 +38,101 @@ MirPointerEvent::MirPointerEvent(MirInputDeviceId dev,
                     float dy,
                     float vscroll,
                     float hscroll)
-    : MirInputEvent(dev, et, mods, cookie)
+    : MirInputEvent(mir_input_event_type_pointer, dev, et, mods, cookie)
 {
-    auto input = event.getInput();
-    input.initPointer();
-    auto ptr = event.getInput().getPointer();
-    ptr.setX(x);
-    ptr.setY(y);
-    ptr.setDx(dx);
-    ptr.setDy(dy);
-    ptr.setVscroll(vscroll);
-    ptr.setHscroll(hscroll);
-    ptr.setButtons(buttons);
-    ptr.setAction(static_cast<mir::capnp::PointerEvent::PointerAction>(action));
+    input->x = x;
+    input->y = y;
+    input->dx = dx;
+    input->dy = dy;
+    input->vscroll = vscroll;
+    input->hscroll = hscroll;
+    input->buttons = buttons;
+    input->pointer_action = action;
 }
 
 MirPointerButtons MirPointerEvent::buttons() const
 {
-    return event.asReader().getInput().getPointer().getButtons();
+    return input->buttons;
 }
 
 void MirPointerEvent::set_buttons(MirPointerButtons buttons)
 {
-    event.getInput().getPointer().setButtons(buttons);
+    input->buttons = buttons;
 }
 
 float MirPointerEvent::x() const
 {
-    return event.asReader().getInput().getPointer().getX();
+    return input->x;
 }
 
 void MirPointerEvent::set_x(float x)
 {
-    event.getInput().getPointer().setX(x);
+    input->x = x;
 }
 
 float MirPointerEvent::y() const
 {
-    return event.asReader().getInput().getPointer().getY();
+    return input->y;
 }
 
 void MirPointerEvent::set_y(float y)
 {
-    event.getInput().getPointer().setY(y);
+    input->y = y;
 }
 
 float MirPointerEvent::dx() const
 {
-    return event.asReader().getInput().getPointer().getDx();
+    return input->dx;
 }
 
 void MirPointerEvent::set_dx(float dx)
 {
-    event.getInput().getPointer().setDx(dx);
+    input->dx = dx;
 }
 
 float MirPointerEvent::dy() const
 {
-    return event.asReader().getInput().getPointer().getDy();
+    return input->dy;
 }
 
 void MirPointerEvent::set_dy(float dy)
 {
-    event.getInput().getPointer().setDy(dy);
+    input->dy = dy;
 }
 
 float MirPointerEvent::vscroll() const
 {
-    return event.asReader().getInput().getPointer().getVscroll();
+    return input->vscroll;
 }
 
 void MirPointerEvent::set_vscroll(float vs)
 {
-    event.getInput().getPointer().setVscroll(vs);
+    input->vscroll = vs;
 }
 
 float MirPointerEvent::hscroll() const
 {
-    return event.asReader().getInput().getPointer().getHscroll();
+    return input->hscroll;
 }
 
 void MirPointerEvent::set_hscroll(float hs)
 {
-    event.getInput().getPointer().setHscroll(hs);
+    input->hscroll = hs;
 }
 
 MirPointerAction MirPointerEvent::action() const
 {
-    return static_cast<MirPointerAction>(event.asReader().getInput().getPointer().getAction());
+    return input->pointer_action;
 }
 
 void MirPointerEvent::set_action(MirPointerAction action)
 {
-    event.getInput().getPointer().setAction(static_cast<mir::capnp::PointerEvent::PointerAction>(action));
+    input->pointer_action = action;
 }
 
 void MirPointerEvent::set_dnd_handle(std::vector<uint8_t> const& handle)
 {
-    event.getInput().getPointer().initDndHandle(handle.size());
-    event.getInput().getPointer().setDndHandle(::kj::ArrayPtr<uint8_t const>{&*begin(handle), &*end(handle)});
+    input->dnd_handle = handle;
 }
 
 namespace
@@ -154,19 +149,11 @@ struct MyMirBlob : MirBlob
 
 MirBlob* MirPointerEvent::dnd_handle() const
 {
-    auto const reader = event.asReader().getInput().getPointer();
-
-    if (!reader.hasDndHandle())
+    if (!input->dnd_handle)
         return nullptr;
 
-    auto const dnd_handle = reader.getDndHandle();
-
     auto blob = std::make_unique<MyMirBlob>();
-    blob->data_.reserve(dnd_handle.size());
-
-    // Can't use std::copy() as the CapnP iterators don't provide an iterator category
-    for (auto p = dnd_handle.begin(); p != dnd_handle.end(); ++p)
-        blob->data_.push_back(*p);
+    blob->data_ = *input->dnd_handle;
 
     return blob.release();
 }
@@ -0,0 +1,236 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/logging/async_console_logger.h"
+#include "mir/logging/dumb_console_logger.h"
+#include "mir/thread_name.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace ml = mir::logging;
+
+namespace
+{
+auto round_up_to_power_of_two(size_t n) -> size_t
+{
+    size_t result = 1;
+    while (result < n)
+        result <<= 1;
+    return result;
+}
+
+/// Copies as much of from as fits in to (without splitting a UTF-8 sequence), returning the size copied
+auto copy_truncated(std::string const& from, char* to, size_t capacity, char const* marker = "") -> size_t
+{
+    if (from.size() <= capacity)
+    {
+        memcpy(to, from.data(), from.size());
+        return from.size();
+    }
+
+    auto const marker_size = strlen(marker);
+    auto size = capacity - marker_size;
+    while (size > 0 && (from[size] & 0xc0) == 0x80)
+        --size;
+
+    memcpy(to, from.data(), size);
+    memcpy(to + size, marker, marker_size);
+    return size + marker_size;
+}
+}
+
+ml::AsyncConsoleLogger::AsyncConsoleLogger(size_t capacity)
+    : AsyncConsoleLogger(std::cout, std::cerr, capacity)
+{
+}
+
+ml::AsyncConsoleLogger::AsyncConsoleLogger(std::ostream& out, std::ostream& err, size_t capacity)
+    : out{out},
+      err{err},
+      capacity{round_up_to_power_of_two(capacity)},
+      slots{new Slot[this->capacity]}
+{
+    for (size_t i = 0; i != this->capacity; ++i)
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+
+    consumer = std::thread{[this] { run(); }};
+}
+
+ml::AsyncConsoleLogger::~AsyncConsoleLogger()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+    wake_consumer.notify_one();
+    consumer.join();
+}
+
+void ml::AsyncConsoleLogger::log(Severity severity, std::string const& message, std::string const& component)
+{
+    if (severity == Severity::critical)
+    {
+        // Critical messages usually precede an abort, so make sure they (and
+        // what led up to them) reach the console before returning
+        while (!try_enqueue(severity, message, component))
+            flush();
+        flush();
+        return;
+    }
+
+    if (!try_enqueue(severity, message, component))
+    {
+        dropped_count.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (consumer_sleeping.load())
+    {
+        // Taking the lock ensures the consumer is actually waiting before we notify it
+        { std::lock_guard<std::mutex> lock{mutex}; }
+        wake_consumer.notify_one();
+    }
+}
+
+void ml::AsyncConsoleLogger::flush()
+{
+    auto const target = enqueue_pos.load();
+
+    std::unique_lock<std::mutex> lock{mutex};
+    wake_consumer.notify_one();
+    written_changed.wait(lock, [&] { return written >= target; });
+}
+
+auto ml::AsyncConsoleLogger::dropped() const -> uint64_t
+{
+    return dropped_count.load(std::memory_order_relaxed);
+}
+
+// A bounded multi-producer/single-consumer queue: each slot's sequence says
+// whether it is free for the producer claiming position pos (sequence == pos)
+// or holds a record for the consumer (sequence == pos + 1).
+auto ml::AsyncConsoleLogger::try_enqueue(
+    Severity severity,
+    std::string const& message,
+    std::string const& component) -> bool
+{
+    timespec time;
+    clock_gettime(CLOCK_REALTIME, &time);
+
+    auto pos = enqueue_pos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        auto& slot = slots[pos & (capacity - 1)];
+        auto const sequence = slot.sequence.load(std::memory_order_acquire);
+        auto const diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+        if (diff == 0)
+        {
+            if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                auto& record = slot.record;
+                record.severity = severity;
+                record.time = time;
+                record.message_size = copy_truncated(message, record.message, max_message_size, "...");
+                record.component_size = copy_truncated(component, record.component, max_component_size);
+                // Sequentially consistent, pairing with the consumer going to sleep
+                slot.sequence.store(pos + 1);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            return false;
+        }
+        else
+        {
+            pos = enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+auto ml::AsyncConsoleLogger::has_pending() const -> bool
+{
+    return slots[dequeue_pos & (capacity - 1)].sequence.load() == dequeue_pos + 1;
+}
+
+void ml::AsyncConsoleLogger::drain()
+{
+    while (has_pending())
+    {
+        auto& slot = slots[dequeue_pos & (capacity - 1)];
+        auto const severity = slot.record.severity;
+        auto const time = slot.record.time;
+        std::string const message{slot.record.message, slot.record.message_size};
+        std::string const component{slot.record.component, slot.record.component_size};
+        slot.sequence.store(dequeue_pos + capacity, std::memory_order_release);
+        ++dequeue_pos;
+
+        write(severity, format_console_log_line(severity, message, component, time));
+    }
+
+    auto const dropped_now = dropped();
+    if (dropped_now != reported_dropped)
+    {
+        timespec time;
+        clock_gettime(CLOCK_REALTIME, &time);
+        auto const message = std::to_string(dropped_now - reported_dropped) + " log messages dropped";
+        write(Severity::warning, format_console_log_line(Severity::warning, message, "logging", time));
+        reported_dropped = dropped_now;
+    }
+
+    out.flush();
+    err.flush();
+
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        written = dequeue_pos;
+    }
+    written_changed.notify_all();
+}
+
+void ml::AsyncConsoleLogger::write(Severity severity, std::string const& line)
+{
+    auto& stream = severity < Severity::informational ? err : out;
+    stream.write(line.data(), line.size());
+    stream.put('\n');
+}
+
+void ml::AsyncConsoleLogger::run()
+{
+    mir::set_thread_name("Mir/Log");
+
+    std::unique_lock<std::mutex> lock{mutex};
+    for (;;)
+    {
+        lock.unlock();
+        drain();
+        lock.lock();
+
+        if (stopping && !has_pending())
+            break;
+
+        consumer_sleeping.store(true);
+        if (!stopping && !has_pending())
+        {
+            // The timeout is only a backstop: producers wake us when we're sleeping
+            wake_consumer.wait_for(lock, std::chrono::milliseconds{100});
+        }
+        consumer_sleeping.store(false);
+    }
+}
@@ -28,7 +28,20 @@ void ml::DumbConsoleLogger::log(ml::Severity severity,
                                 const std::string& message,
                                 const std::string& component)
 {
+    std::ostream& out = severity < ml::Severity::informational ? std::cerr : std::cout;
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    out << format_console_log_line(severity, message, component, ts) << std::endl;
+}
 
+auto ml::format_console_log_line(
+    Severity severity,
+    std::string const& message,
+    std::string const& component,
+    timespec const& time) -> std::string
+{
     static const char* lut[5] =
     {
         "< CRITICAL! > ",
@@ -38,20 +51,19 @@ void ml::DumbConsoleLogger::log(ml::Severity severity,
         "< - debug - > "
     };
 
-    std::ostream& out = severity < ml::Severity::informational ? std::cerr : std::cout;
-
-    struct timespec ts;
-    clock_gettime(CLOCK_REALTIME, &ts);
+    struct tm local;
     char now[32];
-    auto offset = strftime(now, sizeof(now), "%F %T", localtime(&ts.tv_sec));
-    snprintf(now+offset, sizeof(now)-offset, ".%06ld", ts.tv_nsec / 1000);
-
-    out << "["
-        << now
-        << "] "
-        << lut[static_cast<int>(severity)]
-        << component
-        << ": "
-        << message
-        << std::endl;
+    auto offset = strftime(now, sizeof(now), "%F %T", localtime_r(&time.tv_sec, &local));
+    snprintf(now+offset, sizeof(now)-offset, ".%06ld", time.tv_nsec / 1000);
+
+    std::string line;
+    line.reserve(sizeof(now) + 20 + component.size() + message.size());
+    line += "[";
+    line += now;
+    line += "] ";
+    line += lut[static_cast<int>(severity)];
+    line += component;
+    line += ": ";
+    line += message;
+    return line;
 }
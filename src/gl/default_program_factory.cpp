@@ -23,6 +23,13 @@
 
 namespace mgl = mir::gl;
 
+mgl::DefaultProgramFactory::DefaultProgramFactory()
+    : textures{std::make_shared<RecentlyUsedTextures>()}
+{
+}
+
+mgl::DefaultProgramFactory::~DefaultProgramFactory() = default;
+
 std::unique_ptr<mgl::Program>
 mgl::DefaultProgramFactory::create_gl_program(
     std::string const& vertex_shader,
@@ -35,5 +42,5 @@ mgl::DefaultProgramFactory::create_gl_program(
 
 std::unique_ptr<mgl::TextureCache> mgl::DefaultProgramFactory::create_texture_cache() const
 {
-    return std::make_unique<RecentlyUsedCache>();
+    return std::make_unique<RecentlyUsedCache>(textures);
 }
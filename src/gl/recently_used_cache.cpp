@@ -19,8 +19,10 @@
 
 #include "recently_used_cache.h"
 #include "mir/graphics/buffer.h"
+#include "mir/graphics/egl_sync_fence.h"
 #include "mir/renderer/gl/texture_source.h"
 
+#include <algorithm>
 #include <stdexcept>
 #include <boost/throw_exception.hpp>
 
@@ -29,52 +31,217 @@ namespace mgl = mir::gl;
 namespace geom = mir::geometry;
 namespace mrgl = mir::renderer::gl;
 
+auto mgl::RecentlyUsedTextures::Slot::in_frame_for_another_cache(RecentlyUsedCache const* cache) const -> bool
+{
+    return std::any_of(readers.begin(), readers.end(),
+        [cache](auto const& reader) { return reader.first != cache && !reader.second; });
+}
+
+auto mgl::RecentlyUsedTextures::acquire(mg::Renderable::ID id) -> std::shared_ptr<Entry>
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    auto& weak_entry = entries[id];
+    if (auto const entry = weak_entry.lock())
+        return entry;
+
+    auto const entry = std::make_shared<Entry>();
+    weak_entry = entry;
+    return entry;
+}
+
+void mgl::RecentlyUsedTextures::prune()
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    for (auto e = entries.begin(); e != entries.end();)
+    {
+        if (e->second.expired())
+            e = entries.erase(e);
+        else
+            ++e;
+    }
+}
+
+mgl::RecentlyUsedCache::RecentlyUsedCache()
+    : RecentlyUsedCache(std::make_shared<RecentlyUsedTextures>())
+{
+}
+
+mgl::RecentlyUsedCache::RecentlyUsedCache(std::shared_ptr<RecentlyUsedTextures> const& textures)
+    : textures{textures}
+{
+}
+
+mgl::RecentlyUsedCache::~RecentlyUsedCache()
+{
+    for (auto const* uses : {&used, &kept})
+    {
+        for (auto const& u : *uses)
+            stop_reading(*u.second.entry);
+    }
+}
+
 std::shared_ptr<mgl::Texture> mgl::RecentlyUsedCache::load(mg::Renderable const& renderable)
 {
     auto const& buffer = renderable.buffer();
     auto buffer_id = buffer->id();
-    auto& texture = textures[renderable.id()];
-    texture.texture->bind();
 
     auto const texture_source = dynamic_cast<mrgl::TextureSource*>(buffer->native_buffer_base());
     if (!texture_source)
         BOOST_THROW_EXCEPTION(std::logic_error("Buffer does not support GL rendering"));
 
-    if ((texture.last_bound_buffer != buffer_id) || (!texture.valid_binding))
+    auto& use = used[renderable.id()];
+    if (!use.entry)
+    {
+        auto const previously = kept.find(renderable.id());
+        use = previously != kept.end() ? previously->second : Use{textures->acquire(renderable.id()), nullptr};
+    }
+
+    std::lock_guard<decltype(use.entry->mutex)> lock{use.entry->mutex};
+    auto& slots = use.entry->slots;
+
+    auto shown = std::find_if(slots.begin(), slots.end(),
+        [&](auto const& slot) { return slot.valid && slot.buffer == buffer_id; });
+
+    if (shown != slots.end())
     {
-        texture_source->bind();
-        texture.resource = buffer;
-        texture.last_bound_buffer = buffer_id;
+        // Another output's cache may already have uploaded this buffer
+        auto const reader = shown->readers.emplace(this, nullptr);
+        if (reader.second)
+        {
+            if (shown->uploaded)
+                shown->uploaded->server_wait();
+        }
+        else
+        {
+            reader.first->second.reset();
+        }
+        use.slot = &*shown;
+        use.slot->texture->bind();
+    }
+    else
+    {
+        auto& slot = slot_for(*use.entry, use.slot, *buffer);
+        use.slot = &slot;
+
+        // Don't overwrite the texture under other outputs' earlier frames
+        for (auto const& reader : slot.readers)
+        {
+            if (reader.first != this)
+                reader.second->server_wait();
+        }
+
+        slot.texture->bind();
+
+        // If the texture holds an earlier buffer of the same stream, only upload what changed
+        bool const can_update =
+            slot.valid &&
+            slot.size == buffer->size() &&
+            slot.format == buffer->pixel_format();
+
+        if (auto const damage =
+                can_update ?
+                    renderable.buffer_damage_since(slot.buffer) :
+                    std::experimental::nullopt)
+        {
+            texture_source->bind_damaged(damage.value());
+        }
+        else
+        {
+            texture_source->bind();
+        }
+
+        // Other contexts sampling the texture wait for this
+        slot.uploaded = std::make_shared<mg::EGLSyncFence>();
+        slot.readers.clear();
+        slot.readers.emplace(this, nullptr);
+
+        slot.resource = buffer;
+        slot.buffer = buffer_id;
+        slot.size = buffer->size();
+        slot.format = buffer->pixel_format();
+        slot.valid = true;
     }
     texture_source->secure_for_render();
 
-    texture.valid_binding = true;
-    texture.used = true;
+    return use.slot->texture;
+}
+
+auto mgl::RecentlyUsedCache::slot_for(
+    RecentlyUsedTextures::Entry& entry,
+    RecentlyUsedTextures::Slot* previous,
+    mg::Buffer& buffer) -> RecentlyUsedTextures::Slot&
+{
+    auto const writable = [this](RecentlyUsedTextures::Slot const& slot)
+        {
+            return !slot.in_frame_for_another_cache(this);
+        };
+
+    // Our previous buffer is the best to update from...
+    if (previous && writable(*previous))
+        return *previous;
+
+    // ...then one no other output is part way through a frame with, preferably the same size
+    auto& slots = entry.slots;
+    auto reusable = std::find_if(slots.begin(), slots.end(),
+        [&](auto const& slot) { return writable(slot) && slot.size == buffer.size(); });
+    if (reusable == slots.end())
+        reusable = std::find_if(slots.begin(), slots.end(), writable);
+    if (reusable != slots.end())
+        return *reusable;
 
-    return texture.texture;
+    slots.emplace_back();
+    return slots.back();
 }
 
-void mgl::RecentlyUsedCache::invalidate()
+void mgl::RecentlyUsedCache::stop_reading(RecentlyUsedTextures::Entry& entry) const
 {
-    for (auto &t : textures)
-        t.second.valid_binding = false;
+    std::lock_guard<decltype(entry.mutex)> lock{entry.mutex};
+    for (auto& slot : entry.slots)
+        slot.readers.erase(this);
 }
 
-void mgl::RecentlyUsedCache::drop_unused()
+void mgl::RecentlyUsedCache::invalidate()
 {
-    auto t = textures.begin();
-    while (t != textures.end())
+    for (auto const* uses : {&used, &kept})
     {
-        auto& tex = t->second;
-        tex.resource.reset();
-        if (tex.used)
+        for (auto const& u : *uses)
         {
-            tex.used = false;
-            ++t;
+            std::lock_guard<decltype(u.second.entry->mutex)> lock{u.second.entry->mutex};
+            for (auto& slot : u.second.entry->slots)
+                slot.valid = false;
         }
-        else
+    }
+}
+
+void mgl::RecentlyUsedCache::drop_unused()
+{
+    if (!used.empty())
+    {
+        // Other contexts wait for this before overwriting what we sampled
+        auto const frame_done = std::make_shared<mg::EGLSyncFence>();
+
+        for (auto const& u : used)
         {
-            t = textures.erase(t);
+            std::lock_guard<decltype(u.second.entry->mutex)> lock{u.second.entry->mutex};
+            auto& slot = *u.second.slot;
+            slot.readers[this] = frame_done;
+
+            // The texture holds a copy, but the buffer is kept until no output is part way through a frame with it
+            if (!slot.in_frame_for_another_cache(this))
+                slot.resource.reset();
         }
     }
+
+    for (auto const& k : kept)
+    {
+        if (used.find(k.first) == used.end())
+            stop_reading(*k.second.entry);
+    }
+
+    // Entries nobody else is using are destroyed (with their textures) here
+    kept = std::move(used);
+    used.clear();
+    textures->prune();
 }
@@ -24,34 +24,97 @@
 #include "mir/gl/texture.h"
 #include "mir/graphics/buffer_id.h"
 #include "mir/graphics/renderable.h"
+#include "mir/geometry/size.h"
+#include "mir_toolkit/common.h"
+#include <list>
+#include <mutex>
 #include <unordered_map>
 
 namespace mir
 {
-namespace graphics { class Buffer; }
+namespace graphics { class Buffer; class EGLSyncFence; }
 namespace gl
 {
+class RecentlyUsedCache;
+
+/**
+ * The per-renderable textures of RecentlyUsedCaches whose GL contexts share objects
+ *
+ * An entry (and its textures) lives as long as any cache is using it, so a
+ * buffer that is composited on several outputs is only uploaded once.
+ *
+ * Each texture ("slot") of an entry holds one buffer of the renderable. Outputs
+ * showing different buffers of a stream use different slots, and a slot is only
+ * overwritten once no other output is part way through a frame sampling it.
+ * Uploads and frames are fenced, so that each context waits for the commands
+ * of the others before it samples or overwrites a texture.
+ */
+class RecentlyUsedTextures
+{
+public:
+    struct Slot
+    {
+        std::shared_ptr<Texture> const texture{std::make_shared<Texture>()};
+        graphics::BufferID buffer;
+        geometry::Size size;
+        MirPixelFormat format{mir_pixel_format_invalid};
+        bool valid{false};
+        std::shared_ptr<graphics::Buffer> resource;
+
+        /// After the upload of buffer
+        std::shared_ptr<graphics::EGLSyncFence> uploaded;
+
+        /// The caches that have sampled buffer, with a fence after their last
+        /// frame (or null while the frame is in progress)
+        std::unordered_map<RecentlyUsedCache const*, std::shared_ptr<graphics::EGLSyncFence>> readers;
+
+        auto in_frame_for_another_cache(RecentlyUsedCache const* cache) const -> bool;
+    };
+
+    struct Entry
+    {
+        /// Held while the slots are bound and updated
+        std::mutex mutex;
+        std::list<Slot> slots;
+    };
+
+    /// The entry for \a id, created if no cache is using one. Requires a current GL context.
+    auto acquire(graphics::Renderable::ID id) -> std::shared_ptr<Entry>;
+
+    /// Forget the entries no cache is using any more
+    void prune();
+
+private:
+    std::mutex mutex;
+    std::unordered_map<graphics::Renderable::ID, std::weak_ptr<Entry>> entries;
+};
+
 class RecentlyUsedCache : public TextureCache
 {
 public:
+    RecentlyUsedCache();
+    explicit RecentlyUsedCache(std::shared_ptr<RecentlyUsedTextures> const& textures);
+    ~RecentlyUsedCache();
+
     std::shared_ptr<Texture> load(graphics::Renderable const& renderable) override;
     void invalidate() override;
     void drop_unused() override;
 
 private:
-    struct Entry
+    struct Use
     {
-        Entry()
-         : texture(std::make_shared<Texture>())
-        {}
-        std::shared_ptr<Texture> texture;
-        graphics::BufferID last_bound_buffer;
-        bool used{true};
-        bool valid_binding{false};
-        std::shared_ptr<graphics::Buffer> resource;
+        std::shared_ptr<RecentlyUsedTextures::Entry> entry;
+        RecentlyUsedTextures::Slot* slot;
     };
+    using Uses = std::unordered_map<graphics::Renderable::ID, Use>;
+
+    auto slot_for(RecentlyUsedTextures::Entry& entry, RecentlyUsedTextures::Slot* previous, graphics::Buffer& buffer)
+        -> RecentlyUsedTextures::Slot&;
+    void stop_reading(RecentlyUsedTextures::Entry& entry) const;
 
-    std::unordered_map<graphics::Renderable::ID, Entry> textures;
+    std::shared_ptr<RecentlyUsedTextures> const textures;
+    Uses used;   ///< Loaded since the last drop_unused()
+    Uses kept;   ///< Loaded before the last drop_unused()
 };
 }
 }
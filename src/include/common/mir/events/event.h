@@ -21,11 +21,13 @@
 
 #include "mir_toolkit/event.h"
 #include "mir/events/event_builders.h"
+#include "mir/events/input_event_data.h"
 #include "mir_event.capnp.h"
 
 #include <capnp/message.h>
 
 #include <cstring>
+#include <optional>
 
 struct MirEvent
 {
@@ -69,9 +71,12 @@ struct MirEvent
 
 protected:
     MirEvent() = default;
+    explicit MirEvent(mir::events::InputEventData const& input_data);
 
+    // Input events live in input; every other event type in the capnp message
     ::capnp::MallocMessageBuilder message;
     mir::capnp::Event::Builder event{message.initRoot<mir::capnp::Event>()};
+    std::optional<mir::events::InputEventData> input;
 };
 
 #endif /* MIR_COMMON_EVENT_H_ */
@@ -50,12 +50,13 @@ struct MirInputEvent : MirEvent
     MirTouchEvent const* to_touch() const;
 
 protected:
-    MirInputEvent(MirInputDeviceId dev,
+    MirInputEvent(MirInputEventType type,
+                  MirInputDeviceId dev,
                   std::chrono::nanoseconds et,
                   MirInputEventModifiers mods,
                   std::vector<uint8_t> const& cookie);
 
-    MirInputEvent() = default;
+    explicit MirInputEvent(MirInputEventType type);
     MirInputEvent(MirInputEvent const& event) = default;
     MirInputEvent& operator=(MirInputEvent const& event) = default;
 };
@@ -0,0 +1,79 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_COMMON_INPUT_EVENT_DATA_H_
+#define MIR_COMMON_INPUT_EVENT_DATA_H_
+
+#include "mir_toolkit/event.h"
+#include "mir/events/contact_state.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mir
+{
+namespace events
+{
+/**
+ * The in-process representation of keyboard, pointer and touch events.
+ *
+ * These are by far the most frequent events, so they are held as plain
+ * values: creating or copying one doesn't build a capnp message, and in
+ * the common case (no cookie, short or no text) doesn't allocate at all.
+ * They are converted to capnp only at the wire boundary.
+ */
+struct InputEventData
+{
+    static size_t constexpr max_touch_contacts{16};
+
+    explicit InputEventData(MirInputEventType type) : type{type} {}
+
+    MirInputEventType type;
+    MirInputDeviceId device_id{0};
+    std::chrono::nanoseconds event_time{0};
+    MirInputEventModifiers modifiers{0};
+    int32_t window_id{0};
+    std::vector<uint8_t> cookie;
+
+    // mir_input_event_type_key
+    MirKeyboardAction key_action{mir_keyboard_action_up};
+    int32_t key_code{0};
+    int32_t scan_code{0};
+    std::string text;
+
+    // mir_input_event_type_pointer
+    MirPointerAction pointer_action{mir_pointer_action_button_up};
+    MirPointerButtons buttons{0};
+    float x{0};
+    float y{0};
+    float dx{0};
+    float dy{0};
+    float vscroll{0};
+    float hscroll{0};
+    std::optional<std::vector<uint8_t>> dnd_handle;
+
+    // mir_input_event_type_touch
+    size_t pointer_count{0};
+    std::array<ContactState, max_touch_contacts> contacts{};
+};
+}
+}
+
+#endif /* MIR_COMMON_INPUT_EVENT_DATA_H_ */
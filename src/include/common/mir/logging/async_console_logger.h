@@ -0,0 +1,116 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_LOGGING_ASYNC_CONSOLE_LOGGER_H_
+#define MIR_LOGGING_ASYNC_CONSOLE_LOGGER_H_
+
+#include "mir/logging/logger.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace mir
+{
+namespace logging
+{
+/**
+ * Logs in the same format as DumbConsoleLogger, but without blocking the
+ * logging thread on formatting and console output.
+ *
+ * Messages are timestamped and queued in a fixed-size lock-free ring buffer
+ * which a dedicated thread drains. If the ring is full the message is dropped
+ * and counted, and the number dropped is reported once there is space again.
+ * Critical messages are never dropped and are only returned from once they
+ * (and everything logged before them) have been written.
+ *
+ * Each slot of the ring has fixed-size storage, so queuing a message never
+ * allocates. Longer messages are truncated and end with "...".
+ */
+class AsyncConsoleLogger : public Logger
+{
+public:
+    /// \param [in] capacity  Maximum number of queued messages (rounded up to a power of two)
+    explicit AsyncConsoleLogger(size_t capacity = 1024);
+    AsyncConsoleLogger(std::ostream& out, std::ostream& err, size_t capacity);
+    ~AsyncConsoleLogger();
+
+    void log(Severity severity, const std::string& message, const std::string& component) override;
+
+    /// Waits until everything logged before the call has been written
+    void flush();
+
+    /// The number of messages dropped because the queue was full
+    auto dropped() const -> uint64_t;
+
+    /// The longest message (in bytes) that is written in full
+    static size_t constexpr max_message_size{1024};
+    static size_t constexpr max_component_size{64};
+
+private:
+    struct Record
+    {
+        Severity severity;
+        timespec time;
+        size_t message_size;
+        size_t component_size;
+        char message[max_message_size];
+        char component[max_component_size];
+    };
+
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        Record record;
+    };
+
+    auto try_enqueue(Severity severity, std::string const& message, std::string const& component) -> bool;
+    auto has_pending() const -> bool;
+    void drain();
+    void write(Severity severity, std::string const& line);
+    void run();
+
+    std::ostream& out;
+    std::ostream& err;
+
+    size_t const capacity;
+    std::unique_ptr<Slot[]> const slots;
+
+    // Producers only touch enqueue_pos, the consumer thread only dequeue_pos
+    alignas(64) std::atomic<size_t> enqueue_pos{0};
+    alignas(64) size_t dequeue_pos{0};
+
+    std::atomic<uint64_t> dropped_count{0};
+    uint64_t reported_dropped{0};
+
+    std::mutex mutex;
+    std::condition_variable wake_consumer;
+    std::condition_variable written_changed;
+    std::atomic<bool> consumer_sleeping{false};
+    size_t written{0};
+    bool stopping{false};
+
+    std::thread consumer;
+};
+}
+}
+
+#endif // MIR_LOGGING_ASYNC_CONSOLE_LOGGER_H_
@@ -21,6 +21,8 @@
 
 #include "mir/logging/logger.h"
 
+#include <ctime>
+
 namespace mir
 {
 namespace logging
@@ -32,6 +34,13 @@ public:
 protected:
     void log(Severity severity, const std::string& message, const std::string& component) override;
 };
+
+/// Formats a message logged at time (CLOCK_REALTIME) as DumbConsoleLogger prints it
+auto format_console_log_line(
+    Severity severity,
+    std::string const& message,
+    std::string const& component,
+    timespec const& time) -> std::string;
 }
 }
 
@@ -26,10 +26,19 @@ namespace mir
 {
 namespace gl
 {
+class RecentlyUsedTextures;
+
 class DefaultProgramFactory : public ProgramFactory
 {
 public:
+    DefaultProgramFactory();
+    ~DefaultProgramFactory();
+
     std::unique_ptr<Program> create_gl_program(std::string const&, std::string const&) const override;
+    /**
+     * The caches created by a factory share their textures, so must only be
+     * used by renderers whose GL contexts share objects.
+     */
     std::unique_ptr<TextureCache> create_texture_cache() const override;
 
 private:
@@ -40,6 +49,7 @@ private:
      * have the same or shared EGL contexts.
      */
     std::mutex mutable mutex;
+    std::shared_ptr<RecentlyUsedTextures> const textures;
 };
 }
 }
@@ -25,6 +25,7 @@
 #include "mir_toolkit/common.h"
 #include "mir/graphics/buffer_id.h"
 
+#include <experimental/optional>
 #include <memory>
 
 namespace mir
@@ -49,6 +50,15 @@ public:
     virtual void drop_old_buffers() = 0;
     virtual auto has_submitted_buffer() const -> bool = 0;
     virtual auto framedropping() const -> bool = 0;
+    /**
+     * The union of the damage submitted with the buffers after \a since, up to
+     * and including \a until, in buffer coordinates.
+     *
+     * Returns nullopt if either buffer is no longer remembered or any buffer
+     * in between was submitted without damage information.
+     */
+    virtual auto buffer_damage(graphics::BufferID since, graphics::BufferID until) const
+        -> std::experimental::optional<geometry::Rectangles> = 0;
 };
 
 }
@@ -116,6 +116,7 @@ class Platform;
 class Display;
 class DisplayReport;
 class DisplayConfigurationObserver;
+class PresentationObserver;
 class GraphicBufferAllocator;
 class Cursor;
 class CursorImage;
@@ -241,6 +242,8 @@ public:
     virtual std::shared_ptr<input::CursorImages> the_cursor_images();
     std::shared_ptr<ObserverRegistrar<graphics::DisplayConfigurationObserver>>
         the_display_configuration_observer_registrar();
+    std::shared_ptr<ObserverRegistrar<graphics::PresentationObserver>>
+        the_presentation_observer_registrar();
 
     /** @} */
 
@@ -374,6 +377,7 @@ protected:
     std::shared_ptr<options::Option> the_options() const;
     std::shared_ptr<input::DefaultInputDeviceHub>  the_default_input_device_hub();
     std::shared_ptr<graphics::DisplayConfigurationObserver> the_display_configuration_observer();
+    std::shared_ptr<graphics::PresentationObserver> the_presentation_observer();
     std::shared_ptr<input::SeatObserver> the_seat_observer();
     std::shared_ptr<frontend::SessionMediatorObserver> the_session_mediator_observer();
 
@@ -473,6 +477,8 @@ private:
     std::shared_ptr<input::EventFilter> default_filter;
     CachedPtr<ObserverMultiplexer<graphics::DisplayConfigurationObserver>>
         display_configuration_observer_multiplexer;
+    CachedPtr<ObserverMultiplexer<graphics::PresentationObserver>>
+        presentation_observer_multiplexer;
     CachedPtr<ObserverMultiplexer<input::SeatObserver>>
         seat_observer_multiplexer;
     CachedPtr<ObserverMultiplexer<frontend::SessionMediatorObserver>>
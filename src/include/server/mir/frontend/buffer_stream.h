@@ -22,6 +22,7 @@
 #include <mir_toolkit/common.h>
 #include "mir/graphics/buffer_id.h"
 #include "mir/geometry/size.h"
+#include "mir/geometry/rectangles.h"
 #include <functional>
 #include <memory>
 
@@ -41,7 +42,12 @@ class BufferStream
 public:
     virtual ~BufferStream() = default;
 
+    /// Submit a buffer whose entire contents should be treated as changed
     virtual void submit_buffer(std::shared_ptr<graphics::Buffer> const& buffer) = 0;
+    /// Submit a buffer that only differs from the previous one within \a damage (in buffer coordinates)
+    virtual void submit_buffer(
+        std::shared_ptr<graphics::Buffer> const& buffer,
+        geometry::Rectangles const& damage) = 0;
 
     virtual void set_frame_posted_callback(
         std::function<void(geometry::Size const&)> const& callback) = 0;
@@ -0,0 +1,60 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GRAPHICS_PRESENTATION_OBSERVER_H_
+#define MIR_GRAPHICS_PRESENTATION_OBSERVER_H_
+
+#include <thread>
+
+namespace mir
+{
+namespace graphics
+{
+struct Frame;
+
+class PresentationObserver
+{
+public:
+    /**
+     * Notification that a new frame has reached the screen.
+     *
+     * \param [in] output_id    The platform's identifier for the output that flipped.
+     * \param [in] frame        The vsync counter and timestamp of the flip.
+     */
+    virtual void frame_presented(unsigned int output_id, Frame const& frame) = 0;
+
+    /**
+     * Notification that a frame has been submitted to an output. It reaches the screen with the
+     * next frame_presented() for that output.
+     *
+     * Notifications from one source arrive in the order they were made, so this arrives before that
+     * frame_presented(), and after any notifications of content the compositor consumed for the frame.
+     *
+     * \param [in] output_id    The platform's identifier for the output.
+     * \param [in] compositor   The thread that composited the frame.
+     */
+    virtual void frame_posted(unsigned int /*output_id*/, std::thread::id /*compositor*/) {}
+
+protected:
+    PresentationObserver() = default;
+    virtual ~PresentationObserver() = default;
+    PresentationObserver(PresentationObserver const&) = delete;
+    PresentationObserver& operator=(PresentationObserver const&) = delete;
+};
+}
+}
+
+#endif //MIR_GRAPHICS_PRESENTATION_OBSERVER_H_
@@ -41,6 +41,8 @@ struct StreamInfo
     std::shared_ptr<compositor::BufferStream> stream;
     geometry::Displacement displacement;
     optional_value<geometry::Size> size;
+    /// The part of the stream the client guarantees is fully opaque, relative to the stream's top left
+    std::vector<geometry::Rectangle> opaque_region{};
 };
 
 class SurfaceObserver;
@@ -26,6 +26,7 @@
 #include "mir/geometry/rectangle.h"
 
 #include <glm/glm.hpp>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -70,10 +71,11 @@ public:
     virtual void renamed(Surface const* surf, char const* name) = 0;
     virtual void cursor_image_removed(Surface const* surf) = 0;
     virtual void placed_relative(Surface const* surf, geometry::Rectangle const& placement) = 0;
-    virtual void input_consumed(Surface const* surf, MirEvent const* event) = 0;
+    virtual void input_consumed(Surface const* surf, std::shared_ptr<MirEvent const> const& event) = 0;
     virtual void start_drag_and_drop(Surface const* surf, std::vector<uint8_t> const& handle) = 0;
     virtual void depth_layer_set_to(Surface const* surf, MirDepthLayer depth_layer) = 0;
     virtual void application_id_set_to(Surface const* surf, std::string const& application_id) = 0;
+    virtual void input_region_set_to(Surface const* surf, std::vector<geometry::Rectangle> const& region) = 0;
 
 protected:
     SurfaceObserver() = default;
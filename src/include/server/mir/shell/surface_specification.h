@@ -30,6 +30,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 namespace mir
 {
@@ -50,6 +51,8 @@ struct StreamSpecification
     std::weak_ptr<frontend::BufferStream> stream;
     geometry::Displacement displacement;
     optional_value<geometry::Size> size;
+    /// The part of the stream the client guarantees is fully opaque, relative to the stream's top left
+    std::vector<geometry::Rectangle> opaque_region{};
 };
 auto operator==(StreamSpecification const& lhs, StreamSpecification const& rhs) -> bool;
 
@@ -0,0 +1,88 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/graphics/egl_sync_fence.h"
+
+#include <GLES2/gl2.h>
+
+namespace mg = mir::graphics;
+
+namespace
+{
+template<typename Proc>
+auto proc_address(char const* name) -> Proc
+{
+    return reinterpret_cast<Proc>(eglGetProcAddress(name));
+}
+
+auto create_fence(PFNEGLCREATESYNCKHRPROC create, PFNEGLDESTROYSYNCKHRPROC destroy, EGLDisplay display)
+    -> EGLSyncKHR
+{
+    auto const sync = create && destroy ?
+        create(display, EGL_SYNC_FENCE_KHR, nullptr) :
+        EGL_NO_SYNC_KHR;
+
+    if (sync != EGL_NO_SYNC_KHR)
+    {
+        // Submit the fenced commands, so that waits from other contexts can complete
+        glFlush();
+    }
+    else
+    {
+        glFinish();
+    }
+    return sync;
+}
+}
+
+mg::EGLSyncFence::EGLSyncFence()
+    : eglCreateSyncKHR{proc_address<PFNEGLCREATESYNCKHRPROC>("eglCreateSyncKHR")},
+      eglDestroySyncKHR{proc_address<PFNEGLDESTROYSYNCKHRPROC>("eglDestroySyncKHR")},
+      eglClientWaitSyncKHR{proc_address<PFNEGLCLIENTWAITSYNCKHRPROC>("eglClientWaitSyncKHR")},
+      eglWaitSyncKHR{proc_address<PFNEGLWAITSYNCKHRPROC>("eglWaitSyncKHR")},
+      display{eglGetCurrentDisplay()},
+      sync{create_fence(eglCreateSyncKHR, eglDestroySyncKHR, display)}
+{
+}
+
+mg::EGLSyncFence::~EGLSyncFence() noexcept
+{
+    if (sync != EGL_NO_SYNC_KHR)
+        eglDestroySyncKHR(display, sync);
+}
+
+void mg::EGLSyncFence::client_wait() const
+{
+    if (sync != EGL_NO_SYNC_KHR && eglClientWaitSyncKHR)
+        eglClientWaitSyncKHR(display, sync, 0, EGL_FOREVER_KHR);
+}
+
+auto mg::EGLSyncFence::signalled() const -> bool
+{
+    return sync == EGL_NO_SYNC_KHR ||
+           !eglClientWaitSyncKHR ||
+           eglClientWaitSyncKHR(display, sync, 0, 0) != EGL_TIMEOUT_EXPIRED_KHR;
+}
+
+void mg::EGLSyncFence::server_wait() const
+{
+    if (sync == EGL_NO_SYNC_KHR)
+        return;
+
+    // eglWaitSyncKHR() fails on displays without EGL_KHR_wait_sync
+    if (!eglWaitSyncKHR || eglWaitSyncKHR(display, sync, 0) != EGL_TRUE)
+        client_wait();
+}
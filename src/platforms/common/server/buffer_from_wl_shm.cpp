@@ -19,6 +19,8 @@
 
 #include "buffer_from_wl_shm.h"
 #include "shm_buffer.h"
+#include "egl_context_executor.h"
+#include "pixel_unpack_stage.h"
 
 #include "mir/renderer/sw/pixel_source.h"
 #include "mir/executor.h"
@@ -28,6 +30,7 @@
 #include "mir/log.h"
 
 #include <boost/throw_exception.hpp>
+#include <algorithm>
 #include <mutex>
 #include <atomic>
 
@@ -37,6 +40,7 @@
 #include <wayland-server-core.h>
 #include <wayland-server-protocol.h>
 #include <cassert>
+#include <cstdlib>
 
 namespace mg = mir::graphics;
 namespace mgc = mir::graphics::common;
@@ -302,6 +306,27 @@ private:
     }
 };
 
+namespace
+{
+void read_shm_pixels(
+    SharedWlBuffer const& buffer,
+    std::function<void(unsigned char const*)> const& do_with_pixels)
+{
+    if (auto const locked_buffer = buffer.lock())
+    {
+        auto const shm_buffer = wl_shm_buffer_get(locked_buffer);
+        wl_shm_buffer_begin_access(shm_buffer);
+        do_with_pixels(
+            static_cast<unsigned char*>(wl_shm_buffer_get_data(shm_buffer)));
+        wl_shm_buffer_end_access(shm_buffer);
+    }
+    else
+    {
+        mir::log_debug("Wayland buffer destroyed before use; rendering will be incomplete");
+    }
+}
+}
+
 class WlShmBuffer :
     public mg::common::ShmBuffer,
     public mir::renderer::software::PixelSource
@@ -309,12 +334,11 @@ class WlShmBuffer :
 public:
     WlShmBuffer(
         SharedWlBuffer buffer,
-        std::shared_ptr<mgc::EGLContextExecutor> egl_delegate,
         mir::geometry::Size const& size,
         mir::geometry::Stride stride,
         MirPixelFormat format,
         std::function<void()>&& on_consumed)
-        : ShmBuffer(size, format, std::move(egl_delegate)),
+        : ShmBuffer(size, format),
           on_consumed{std::move(on_consumed)},
           buffer{std::move(buffer)},
           stride_{stride}
@@ -328,19 +352,22 @@ public:
 
     void bind() override
     {
-        ShmBuffer::bind();
-        std::lock_guard<std::mutex> lock{consumption_mutex};
-        if (!uploaded)
-        {
-            read_internal(
-                [this](unsigned char const* pixels)
-                {
-                    upload_to_texture(pixels, stride());
-                });
-            on_consumed();
-            on_consumed = [](){};
-            uploaded = true;
-        }
+        read_internal(
+            [this](unsigned char const* pixels)
+            {
+                upload_to_texture(pixels, stride());
+            });
+        consume();
+    }
+
+    void bind_damaged(mir::geometry::Rectangles const& damage) override
+    {
+        read_internal(
+            [this, &damage](unsigned char const* pixels)
+            {
+                upload_damage_to_texture(pixels, stride(), damage);
+            });
+        consume();
     }
 
     void write(unsigned char const* /*pixels*/, size_t /*size*/) override
@@ -352,11 +379,7 @@ public:
     void read(std::function<void(unsigned char const*)> const& do_with_pixels) override
     {
         read_internal(do_with_pixels);
-        {
-            std::lock_guard<std::mutex> lock{consumption_mutex};
-            on_consumed();
-            on_consumed = [](){};
-        }
+        consume();
     }
 
     mir::geometry::Stride stride() const override
@@ -364,49 +387,237 @@ public:
         return stride_;
     }
 
-private:
+protected:
     void read_internal(std::function<void(unsigned char const*)> const& do_with_pixels)
     {
-        if (auto const locked_buffer = buffer.lock())
+        read_shm_pixels(buffer, do_with_pixels);
+    }
+
+    void consume()
+    {
+        std::lock_guard<std::mutex> lock{consumption_mutex};
+        on_consumed();
+        on_consumed = [](){};
+    }
+
+private:
+    std::mutex consumption_mutex;
+    std::function<void()> on_consumed;
+    SharedWlBuffer const buffer;
+    mir::geometry::Stride const stride_;
+};
+
+/**
+ * A wl_shm buffer that is staged in a GL pixel-unpack buffer on the EGL-context thread
+ *
+ * Staging is started as soon as the buffer is submitted, so by the time the compositor
+ * comes to render it the copy out of client memory has usually completed, and the
+ * upload of the damaged rows into the renderer's texture is a copy on the GPU. When
+ * the damage since the surface's previous buffer is known only those rows are staged.
+ *
+ * If the context has no pixel-unpack buffers, the compositor gets to the buffer before
+ * the EGL-context thread does, or it needs rows that were not staged, it is uploaded
+ * just as WlShmBuffer would.
+ */
+class AsyncWlShmBuffer :
+    public WlShmBuffer,
+    public std::enable_shared_from_this<AsyncWlShmBuffer>
+{
+public:
+    AsyncWlShmBuffer(
+        SharedWlBuffer buffer,
+        std::shared_ptr<mgc::EGLContextExecutor> egl_delegate,
+        mir::geometry::Size const& size,
+        mir::geometry::Stride stride,
+        MirPixelFormat format,
+        std::function<void()>&& on_consumed,
+        std::experimental::optional<mir::geometry::Rectangles> const& damage)
+        : WlShmBuffer(std::move(buffer), size, stride, format, std::move(on_consumed)),
+          egl_delegate{std::move(egl_delegate)},
+          staged_damage{damage},
+          stage{std::make_shared<mgc::PixelUnpackStage>()}
+    {
+    }
+
+    ~AsyncWlShmBuffer()
+    {
+        if (state == State::staged)
         {
-            auto const shm_buffer = wl_shm_buffer_get(locked_buffer);
-            wl_shm_buffer_begin_access(shm_buffer);
-            do_with_pixels(
-                static_cast<unsigned char*>(wl_shm_buffer_get_data(shm_buffer)));
-            wl_shm_buffer_end_access(shm_buffer);
+            egl_delegate->spawn([stage = stage]() { stage->release(); });
+        }
+    }
+
+    /**
+     * Queue the staging of the buffer content on the EGL-context thread
+     */
+    void start_staging()
+    {
+        egl_delegate->spawn(
+            [weak_self = std::weak_ptr<AsyncWlShmBuffer>{shared_from_this()}]()
+            {
+                if (auto const self = weak_self.lock())
+                {
+                    self->stage_pixels();
+                }
+            });
+    }
+
+    void bind() override
+    {
+        if (staged(mir::geometry::Rectangles{{{0, 0}, size()}}) &&
+            upload_from_stage([this](GLintptr offset) { upload_to_texture(as_pointer(offset), stride()); }))
+        {
+            consume();
         }
         else
         {
-            mir::log_debug("Wayland buffer destroyed before use; rendering will be incomplete");
+            WlShmBuffer::bind();
         }
     }
 
-    std::mutex consumption_mutex;
-    bool uploaded{false};
-    std::function<void()> on_consumed;
-    SharedWlBuffer const buffer;
-    mir::geometry::Stride const stride_;
+    void bind_damaged(mir::geometry::Rectangles const& damage) override
+    {
+        if (staged(damage) &&
+            upload_from_stage(
+                [this, &damage](GLintptr offset)
+                {
+                    upload_damage_to_texture(as_pointer(offset), stride(), damage);
+                }))
+        {
+            consume();
+        }
+        else
+        {
+            WlShmBuffer::bind_damaged(damage);
+        }
+    }
+
+private:
+    enum class State
+    {
+        pending,
+        staged,
+        unstaged
+    };
+
+    // Must be called on the EGL-context thread
+    void stage_pixels()
+    {
+        std::lock_guard<std::mutex> lock{stage_mutex};
+        if (state != State::pending)
+            return;
+
+        state = State::unstaged;
+        read_internal(
+            [this](unsigned char const* pixels)
+            {
+                auto const row_bytes = static_cast<size_t>(stride().as_int());
+                auto const height = size().height.as_int();
+
+                std::vector<mgc::PixelUnpackStage::Span> spans;
+                if (staged_damage)
+                {
+                    for (auto const& rect : staged_damage.value())
+                    {
+                        auto const top = std::max(rect.top().as_int(), 0);
+                        auto const bottom = std::min(rect.bottom().as_int(), height);
+                        if (top < bottom)
+                            spans.push_back({top * row_bytes, (bottom - top) * row_bytes});
+                    }
+                }
+                else
+                {
+                    spans.push_back({0, height * row_bytes});
+                }
+
+                if (stage->stage(pixels, height * row_bytes, spans))
+                {
+                    state = State::staged;
+                }
+            });
+    }
+
+    /// Whether the rows of \a damage were all staged
+    bool staged(mir::geometry::Rectangles const& damage) const
+    {
+        if (!staged_damage)
+            return true;
+
+        return std::all_of(damage.begin(), damage.end(),
+            [this](auto const& rect)
+            {
+                return std::any_of(staged_damage.value().begin(), staged_damage.value().end(),
+                    [&rect](auto const& staged_rect)
+                    {
+                        return staged_rect.top() <= rect.top() && rect.bottom() <= staged_rect.bottom();
+                    });
+            });
+    }
+
+    /// GL takes an offset into the bound pixel-unpack buffer in place of a pointer to the pixels
+    static auto as_pointer(GLintptr offset) -> void const*
+    {
+        return reinterpret_cast<void const*>(offset);
+    }
+
+    // Must be called with a current GL context
+    bool upload_from_stage(std::function<void(GLintptr offset)> const& upload)
+    {
+        std::lock_guard<std::mutex> lock{stage_mutex};
+        if (state == State::pending)
+        {
+            // The EGL thread hasn't got to us yet; there's no point waiting for it.
+            state = State::unstaged;
+        }
+        return state == State::staged && stage->upload(upload);
+    }
+
+    std::shared_ptr<mgc::EGLContextExecutor> const egl_delegate;
+    std::experimental::optional<mir::geometry::Rectangles> const staged_damage;
+
+    std::mutex stage_mutex;
+    State state{State::pending};
+    std::shared_ptr<mgc::PixelUnpackStage> const stage;
 };
 
 auto mg::wayland::buffer_from_wl_shm(
     wl_resource* buffer,
     std::shared_ptr<Executor> executor,
     std::shared_ptr<common::EGLContextExecutor> egl_delegate,
-    std::function<void()>&& on_consumed) -> std::shared_ptr<Buffer>
+    std::function<void()>&& on_consumed,
+    std::experimental::optional<geometry::Rectangles> const& damage) -> std::shared_ptr<Buffer>
 {
     auto const shm_buffer = wl_shm_buffer_get(buffer);
     if (!shm_buffer)
     {
         BOOST_THROW_EXCEPTION((std::logic_error{"Attempt to import a non-SHM buffer as a SHM buffer"}));
     }
+
+    mir::geometry::Size const size{
+        wl_shm_buffer_get_width(shm_buffer),
+        wl_shm_buffer_get_height(shm_buffer)};
+    mir::geometry::Stride const stride{wl_shm_buffer_get_stride(shm_buffer)};
+    auto const format = wl_format_to_mir_format(wl_shm_buffer_get_format(shm_buffer));
+
+    static bool const async_upload{getenv("MIR_SHM_ASYNC_UPLOAD") != nullptr};
+    if (async_upload)
+    {
+        auto const async_buffer = std::make_shared<AsyncWlShmBuffer>(
+            SharedWlBuffer{buffer, std::move(executor)},
+            std::move(egl_delegate),
+            size,
+            stride,
+            format,
+            std::move(on_consumed),
+            damage);
+        async_buffer->start_staging();
+        return async_buffer;
+    }
+
     return std::make_shared<WlShmBuffer>(
         SharedWlBuffer{buffer, std::move(executor)},
-        std::move(egl_delegate),
-        mir::geometry::Size{
-            wl_shm_buffer_get_width(shm_buffer),
-            wl_shm_buffer_get_height(shm_buffer)
-        },
-        mir::geometry::Stride{wl_shm_buffer_get_stride(shm_buffer)},
-        wl_format_to_mir_format(wl_shm_buffer_get_format(shm_buffer)),
+        size,
+        stride,
+        format,
         std::move(on_consumed));
 }
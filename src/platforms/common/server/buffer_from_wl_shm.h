@@ -20,6 +20,9 @@
 #ifndef MIR_GRAPHICS_GL_WAYLAND_SHM_PROVIDER_H_
 #define MIR_GRAPHICS_GL_WAYLAND_SHM_PROVIDER_H_
 
+#include "mir/geometry/rectangles.h"
+
+#include <experimental/optional>
 #include <memory>
 #include <functional>
 
@@ -43,22 +46,28 @@ namespace wayland
 /**
  * Get a mir::graphics::Buffer with the content of the shm buffer.
  *
- * The returned buffer will support the mg::gl::Texture and
+ * The returned buffer will support the mir::renderer::gl::TextureSource and
  * mir::renderer::sw::PixelSource interfaces.
  *
+ * If MIR_SHM_ASYNC_UPLOAD is set in the environment the content is staged in a
+ * GL pixel-unpack buffer on the \a egl_delegate thread ahead of being rendered.
+ * If \a damage is given only the damaged rows are staged.
+ *
  * \note This must be called on the Wayland thread, with a current GL context
  *
  * \param buffer        [in]    The Wayland SHM buffer to import
  * \param executor      [in]    An Executor that will defer work to the Wayland event loop
  * \param egl_delegate  [in]    An EGL-context-thread delegator
  * \param on_consumed   [in]    Closure to call when the compositor has consumed this buffer
+ * \param damage        [in]    What has changed since the surface's previous buffer, in buffer coordinates
  * \return                      An mg::Buffer supporting being rendered from in GL and read by the CPU.
  */
 auto buffer_from_wl_shm(
     wl_resource* buffer,
     std::shared_ptr<Executor> executor,
     std::shared_ptr<common::EGLContextExecutor> egl_delegate,
-    std::function<void()>&& on_consumed) -> std::shared_ptr<Buffer>;
+    std::function<void()>&& on_consumed,
+    std::experimental::optional<geometry::Rectangles> const& damage = {}) -> std::shared_ptr<Buffer>;
 }
 }
 }
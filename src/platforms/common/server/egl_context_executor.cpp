@@ -55,22 +55,38 @@ void mgc::EGLContextExecutor::process_loop(mgc::EGLContextExecutor* const me)
     std::unique_lock<std::mutex> lock{me->mutex};
     while (!me->shutdown_requested)
     {
-        for (auto& work : me->work_queue)
+        /* Run the queued work without holding the lock, so that a long-running
+         * work item (such as a texture upload) doesn't block spawn() callers,
+         * and work items may themselves spawn() further work.
+         */
+        decltype(me->work_queue) work_queue;
+        std::swap(work_queue, me->work_queue);
+        lock.unlock();
+        for (auto& work : work_queue)
         {
             work();
         }
-        me->work_queue.clear();
+        work_queue.clear();
+        lock.lock();
 
-        me->new_work.wait(lock);
+        me->new_work.wait(lock, [me]() { return me->shutdown_requested || !me->work_queue.empty(); });
     }
 
     // Drain the work-queue
-    for (auto& work : me->work_queue)
+    while (!me->work_queue.empty())
     {
-        work();
+        decltype(me->work_queue) work_queue;
+        std::swap(work_queue, me->work_queue);
+        lock.unlock();
+        for (auto& work : work_queue)
+        {
+            work();
+        }
+        // …and ensure any functor cleanup happens with the EGL context current, too.
+        work_queue.clear();
+        lock.lock();
     }
-    // …and ensure any functor cleanup happens with the EGL context current, too.
-    me->work_queue.clear();
+    lock.unlock();
 
     me->ctx->release_current();
 }
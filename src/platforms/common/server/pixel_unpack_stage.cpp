@@ -0,0 +1,91 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pixel_unpack_stage.h"
+#include "mir/graphics/egl_sync_fence.h"
+
+namespace mg = mir::graphics;
+namespace mgc = mir::graphics::common;
+
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC   // From GLES 3
+#endif
+#ifndef GL_MAJOR_VERSION
+#define GL_MAJOR_VERSION 0x821B         // From GLES 3
+#endif
+
+namespace
+{
+bool context_has_pixel_unpack_buffers()
+{
+    GLint major{0};
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+
+    if (major == 0)
+    {
+        // A GLES 2 context doesn't know the query; don't leave the error for someone else
+        glGetError();
+    }
+    return major >= 3;
+}
+}
+
+mgc::PixelUnpackStage::PixelUnpackStage() = default;
+mgc::PixelUnpackStage::~PixelUnpackStage() = default;
+
+bool mgc::PixelUnpackStage::stage(unsigned char const* pixels, size_t size, std::vector<Span> const& spans)
+{
+    if (!context_has_pixel_unpack_buffers())
+        return false;
+
+    if (pixel_buffer == 0)
+        glGenBuffers(1, &pixel_buffer);
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixel_buffer);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    for (auto const& span : spans)
+    {
+        glBufferSubData(GL_PIXEL_UNPACK_BUFFER, span.offset, span.length, pixels + span.offset);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    fence = std::make_unique<mg::EGLSyncFence>();
+    return true;
+}
+
+bool mgc::PixelUnpackStage::upload(std::function<void(GLintptr offset)> const& upload)
+{
+    if (pixel_buffer == 0)
+        return false;
+
+    // Renderers' contexts may each upload from the stage, so each waits
+    fence->server_wait();
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixel_buffer);
+    upload(0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    return true;
+}
+
+void mgc::PixelUnpackStage::release()
+{
+    fence.reset();
+    if (pixel_buffer != 0)
+    {
+        glDeleteBuffers(1, &pixel_buffer);
+        pixel_buffer = 0;
+    }
+}
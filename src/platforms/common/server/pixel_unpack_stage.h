@@ -0,0 +1,99 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GRAPHICS_COMMON_PIXEL_UNPACK_STAGE_H_
+#define MIR_GRAPHICS_COMMON_PIXEL_UNPACK_STAGE_H_
+
+#include <GLES2/gl2.h>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace mir
+{
+namespace graphics
+{
+class EGLSyncFence;
+
+namespace common
+{
+/**
+ * A copy of a buffer's pixels in a GL pixel-unpack buffer
+ *
+ * Staging lets the copy out of client memory happen ahead of rendering, on a thread
+ * with its own (shared) GL context. The renderer then uploads into its texture from
+ * the stage through the ordinary ShmBuffer upload path, and the GPU does the copy.
+ *
+ * Pixel-unpack buffers are core in GLES 3; in a GLES 2 context nothing is staged.
+ *
+ * \note PixelUnpackStage is not thread-safe; callers must serialise access to it.
+ */
+class PixelUnpackStage
+{
+public:
+    /// A range of bytes of the pixels
+    struct Span
+    {
+        size_t offset;
+        size_t length;
+    };
+
+    PixelUnpackStage();
+    ~PixelUnpackStage();
+
+    /**
+     * Copy \a spans of the \a size bytes at \a pixels into the stage, fencing the copy
+     *
+     * The stage holds \a size bytes laid out as at \a pixels, but only the spans are
+     * defined.
+     *
+     * \note This must be called with a current GL context
+     * \return false, staging nothing, if the context has no pixel-unpack buffers
+     */
+    bool stage(unsigned char const* pixels, size_t size, std::vector<Span> const& spans);
+
+    /**
+     * Call \a upload with the stage bound as the GL pixel-unpack buffer
+     *
+     * The GPU is made to wait for the staged copy first (in every context uploading). \a upload is passed the offset
+     * of the pixels in the bound buffer, which is what GL takes in place of a pointer.
+     *
+     * \note This must be called with a current GL context
+     * \return false, without calling \a upload, if nothing has been staged
+     */
+    bool upload(std::function<void(GLintptr offset)> const& upload);
+
+    /**
+     * Delete the GL objects backing the stage
+     *
+     * \note This must be called with a current GL context before the stage is destroyed,
+     *       if anything was staged
+     */
+    void release();
+
+    PixelUnpackStage(PixelUnpackStage const&) = delete;
+    PixelUnpackStage& operator=(PixelUnpackStage const&) = delete;
+private:
+    GLuint pixel_buffer{0};
+    std::unique_ptr<EGLSyncFence> fence;
+};
+}
+}
+}
+
+#endif /* MIR_GRAPHICS_COMMON_PIXEL_UNPACK_STAGE_H_ */
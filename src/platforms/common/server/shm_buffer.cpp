@@ -19,9 +19,6 @@
 
 #include "mir/graphics/gl_format.h"
 #include "shm_buffer.h"
-#include "mir/graphics/program_factory.h"
-#include "mir/graphics/program.h"
-#include "egl_context_executor.h"
 
 #define MIR_LOG_COMPONENT "gfx-common"
 #include "mir/log.h"
@@ -31,7 +28,11 @@
 
 #include <boost/throw_exception.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include <string.h>
 #include <endian.h>
@@ -96,35 +97,22 @@ bool mgc::ShmBuffer::supports(MirPixelFormat mir_format)
 
 mgc::ShmBuffer::ShmBuffer(
     geom::Size const& size,
-    MirPixelFormat const& format,
-    std::shared_ptr<EGLContextExecutor> egl_delegate)
+    MirPixelFormat const& format)
     : size_{size},
-      pixel_format_{format},
-      egl_delegate{std::move(egl_delegate)}
+      pixel_format_{format}
 {
 }
 
 mgc::MemoryBackedShmBuffer::MemoryBackedShmBuffer(
     geom::Size const& size,
-    MirPixelFormat const& pixel_format,
-    std::shared_ptr<EGLContextExecutor> egl_delegate)
-    : ShmBuffer(size, pixel_format, std::move(egl_delegate)),
+    MirPixelFormat const& pixel_format)
+    : ShmBuffer(size, pixel_format),
       stride_{MIR_BYTES_PER_PIXEL(pixel_format) * size.width.as_uint32_t()},
       pixels{new unsigned char[stride_.as_int() * size.height.as_int()]}
 {
 }
 
-mgc::ShmBuffer::~ShmBuffer() noexcept
-{
-    if (tex_id != 0)
-    {
-        egl_delegate->spawn(
-            [id = tex_id]()
-            {
-                glDeleteTextures(1, &id);
-            });
-    }
-}
+mgc::ShmBuffer::~ShmBuffer() noexcept = default;
 
 geom::Size mgc::ShmBuffer::size() const
 {
@@ -141,47 +129,121 @@ MirPixelFormat mgc::ShmBuffer::pixel_format() const
     return pixel_format_;
 }
 
+bool mgc::upload_pixels_to_texture(
+    void const* pixels,
+    geom::Size const& size,
+    geom::Stride const& stride,
+    MirPixelFormat format)
+{
+    GLenum gl_format, gl_type;
+
+    if (!mg::get_gl_pixel_format(format, gl_format, gl_type))
+        return false;
+
+    auto const stride_in_px =
+        stride.as_int() / MIR_BYTES_PER_PIXEL(format);
+    /*
+     * We assume (as does Weston, AFAICT) that stride is
+     * a multiple of whole pixels, but it need not be.
+     *
+     * TODO: Handle non-pixel-multiple strides.
+     * This should be possible by calculating GL_UNPACK_ALIGNMENT
+     * to match the size of the partial-pixel-stride().
+     */
+
+    glPixelStorei(GL_UNPACK_ROW_LENGTH_EXT, stride_in_px);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    glTexImage2D(
+        GL_TEXTURE_2D,
+        0,
+        gl_format,
+        size.width.as_int(), size.height.as_int(),
+        0,
+        gl_format,
+        gl_type,
+        pixels);
+
+    // Be nice to other users of the GL context by reverting our changes to shared state
+    glPixelStorei(GL_UNPACK_ROW_LENGTH_EXT, 0);     // 0 is default, meaning “use width”
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);          // 4 is default; word alignment.
+
+    return true;
+}
+
 void mgc::ShmBuffer::upload_to_texture(void const* pixels, geom::Stride const& stride)
+{
+    if (!upload_pixels_to_texture(pixels, size(), stride, pixel_format()))
+    {
+        mir::log_error(
+            "Buffer %i has non-GL-compatible pixel format %i; rendering will be incomplete",
+            id().as_value(),
+            pixel_format());
+    }
+}
+
+void mgc::ShmBuffer::upload_damage_to_texture(
+    void const* pixels,
+    geom::Stride const& stride,
+    geom::Rectangles const& damage)
 {
     GLenum format, type;
 
-    if (mg::get_gl_pixel_format(pixel_format_, format, type))
+    if (!mg::get_gl_pixel_format(pixel_format_, format, type))
+    {
+        upload_to_texture(pixels, stride);
+        return;
+    }
+
+    // Collect the damaged rows as [top, bottom) spans, merging those that touch
+    auto const height = size().height.as_int();
+    std::vector<std::pair<int, int>> rows;
+    for (auto const& rect : damage)
+    {
+        auto const top = std::max(rect.top().as_int(), 0);
+        auto const bottom = std::min(rect.bottom().as_int(), height);
+        if (top < bottom && rect.size.width.as_int() > 0)
+            rows.emplace_back(top, bottom);
+    }
+
+    if (rows.empty())
+        return;
+
+    std::sort(rows.begin(), rows.end());
+    auto merged_end = rows.begin();
+    for (auto span = std::next(rows.begin()); span != rows.end(); ++span)
+    {
+        if (span->first <= merged_end->second)
+            merged_end->second = std::max(merged_end->second, span->second);
+        else
+            *++merged_end = *span;
+    }
+    rows.erase(std::next(merged_end), rows.end());
+
+    // Same caveat as upload_to_texture() about strides that are not whole pixels
+    auto const stride_in_px = stride.as_int() / MIR_BYTES_PER_PIXEL(pixel_format());
+
+    glPixelStorei(GL_UNPACK_ROW_LENGTH_EXT, stride_in_px);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    /* pixels may be an offset into a bound pixel-unpack buffer rather than a pointer,
+     * so step through the rows with integer arithmetic.
+     */
+    auto const base = reinterpret_cast<std::uintptr_t>(pixels);
+    for (auto const& span : rows)
     {
-        auto const stride_in_px =
-            stride.as_int() / MIR_BYTES_PER_PIXEL(pixel_format());
-        /*
-         * We assume (as does Weston, AFAICT) that stride is
-         * a multiple of whole pixels, but it need not be.
-         *
-         * TODO: Handle non-pixel-multiple strides.
-         * This should be possible by calculating GL_UNPACK_ALIGNMENT
-         * to match the size of the partial-pixel-stride().
-         */
-
-        glPixelStorei(GL_UNPACK_ROW_LENGTH_EXT, stride_in_px);
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-        glTexImage2D(
+        glTexSubImage2D(
             GL_TEXTURE_2D,
             0,
-            format,
-            size().width.as_int(), size().height.as_int(),
-            0,
+            0, span.first,
+            size().width.as_int(), span.second - span.first,
             format,
             type,
-            pixels);
-
-        // Be nice to other users of the GL context by reverting our changes to shared state
-        glPixelStorei(GL_UNPACK_ROW_LENGTH_EXT, 0);     // 0 is default, meaning “use width”
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);          // 4 is default; word alignment.
-    }
-    else
-    {
-        mir::log_error(
-            "Buffer %i has non-GL-compatible pixel format %i; rendering will be incomplete",
-            id().as_value(),
-            pixel_format());
+            reinterpret_cast<void const*>(base + span.first * stride.as_int()));
     }
+
+    glPixelStorei(GL_UNPACK_ROW_LENGTH_EXT, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 }
 
 void mgc::MemoryBackedShmBuffer::write(unsigned char const* data, size_t data_size)
@@ -201,60 +263,27 @@ mg::NativeBufferBase* mgc::ShmBuffer::native_buffer_base()
     return this;
 }
 
-void mgc::ShmBuffer::bind()
+void mgc::ShmBuffer::gl_bind_to_texture()
 {
-    std::lock_guard<decltype(tex_id_mutex)> lock{tex_id_mutex};
-    bool const needs_initialisation = tex_id == 0;
-    if (needs_initialisation)
-    {
-        glGenTextures(1, &tex_id);
-    }
-    glBindTexture(GL_TEXTURE_2D, tex_id);
-    if (needs_initialisation)
-    {
-        // The ShmBuffer *should* be immutable, so we can just upload once.
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    }
-}
-
-void mgc::MemoryBackedShmBuffer::bind()
-{
-    mgc::ShmBuffer::bind();
-    std::lock_guard<decltype(uploaded_mutex)> lock{uploaded_mutex};
-    if (!uploaded)
-    {
-        upload_to_texture(pixels.get(), stride_);
-        uploaded = true;
-    }
+    bind();
+    secure_for_render();
 }
 
-auto mgc::MemoryBackedShmBuffer::native_buffer_handle() const -> std::shared_ptr<mg::NativeBuffer>
+void mgc::ShmBuffer::secure_for_render()
 {
-    BOOST_THROW_EXCEPTION((std::runtime_error{"MemoryBackedShmBuffer does not support mirclient APIs"}));
 }
 
-mg::gl::Program const& mgc::ShmBuffer::shader(mg::gl::ProgramFactory& cache) const
+void mgc::MemoryBackedShmBuffer::bind()
 {
-    static int argb_shader{0};
-    return cache.compile_fragment_shader(
-        &argb_shader,
-        "",
-        "uniform sampler2D tex;\n"
-        "vec4 sample_to_rgba(in vec2 texcoord)\n"
-        "{\n"
-        "    return texture2D(tex, texcoord);\n"
-        "}\n");
+    upload_to_texture(pixels.get(), stride_);
 }
 
-auto mgc::ShmBuffer::layout() const -> Layout
+void mgc::MemoryBackedShmBuffer::bind_damaged(geom::Rectangles const& damage)
 {
-    return Layout::GL;
+    upload_damage_to_texture(pixels.get(), stride_, damage);
 }
 
-void mgc::ShmBuffer::add_syncpoint()
+auto mgc::MemoryBackedShmBuffer::native_buffer_handle() const -> std::shared_ptr<mg::NativeBuffer>
 {
+    BOOST_THROW_EXCEPTION((std::runtime_error{"MemoryBackedShmBuffer does not support mirclient APIs"}));
 }
-
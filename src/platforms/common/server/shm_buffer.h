@@ -24,14 +24,11 @@
 #include "mir/geometry/dimensions.h"
 #include "mir/geometry/size.h"
 #include "mir_toolkit/common.h"
+#include "mir/geometry/rectangles.h"
 #include "mir/renderer/gl/texture_target.h"
+#include "mir/renderer/gl/texture_source.h"
 #include "mir_toolkit/mir_native_buffer.h"
 #include "mir/renderer/sw/pixel_source.h"
-#include "mir/graphics/texture.h"
-
-#include <GLES2/gl2.h>
-
-#include <mutex>
 
 namespace mir
 {
@@ -41,12 +38,28 @@ namespace graphics
 {
 namespace common
 {
-class EGLContextExecutor;
-
+/**
+ * Upload \a pixels, laid out with \a stride, to the bound texture
+ *
+ * \note This must be called with a current GL context
+ * \return false, without uploading anything, if \a format has no GL equivalent
+ */
+bool upload_pixels_to_texture(
+    void const* pixels,
+    geometry::Size const& size,
+    geometry::Stride const& stride,
+    MirPixelFormat format);
+
+/**
+ * A buffer in CPU memory, rendered by uploading it to whatever texture the renderer has bound.
+ *
+ * The renderer is expected to keep that texture across buffers of a stream, so that
+ * bind_damaged() can upload only what has changed.
+ */
 class ShmBuffer :
     public BufferBasic,
     public NativeBufferBase,
-    public graphics::gl::Texture
+    public renderer::gl::TextureSource
 {
 public:
     ~ShmBuffer() noexcept override;
@@ -57,24 +70,37 @@ public:
     MirPixelFormat pixel_format() const override;
     NativeBufferBase* native_buffer_base() override;
 
-    void bind() override;
-    gl::Program const& shader(gl::ProgramFactory& cache) const override;
-    Layout layout() const override;
-    void add_syncpoint() override;
+    void gl_bind_to_texture() override;
+    void secure_for_render() override;
 protected:
     ShmBuffer(
         geometry::Size const& size,
-        MirPixelFormat const& format,
-        std::shared_ptr<EGLContextExecutor> egl_delegate);
-
-    /// \note This must be called with a current GL context
+        MirPixelFormat const& format);
+
+    /**
+     * Upload \a pixels to the bound texture
+     *
+     * \a pixels may instead be an offset into a bound GL pixel-unpack buffer.
+     *
+     * \note This must be called with a current GL context
+     */
     void upload_to_texture(void const* pixels, geometry::Stride const& stride);
+
+    /**
+     * Upload the rows of \a pixels touched by \a damage to the bound texture
+     *
+     * As with upload_to_texture(), \a pixels may be an offset into a bound pixel-unpack buffer.
+     *
+     * \note This must be called with a current GL context, and the bound texture must
+     *       already have our size and format
+     */
+    void upload_damage_to_texture(
+        void const* pixels,
+        geometry::Stride const& stride,
+        geometry::Rectangles const& damage);
 private:
     geometry::Size const size_;
     MirPixelFormat const pixel_format_;
-    std::shared_ptr<EGLContextExecutor> const egl_delegate;
-    std::mutex tex_id_mutex;
-    GLuint tex_id{0};
 };
 
 class MemoryBackedShmBuffer :
@@ -84,8 +110,7 @@ class MemoryBackedShmBuffer :
 public:
     MemoryBackedShmBuffer(
         geometry::Size const& size,
-        MirPixelFormat const& pixel_format,
-        std::shared_ptr<EGLContextExecutor> egl_delegate);
+        MirPixelFormat const& pixel_format);
 
     void write(unsigned char const* data, size_t size) override;
     void read(std::function<void(unsigned char const*)> const& do_with_pixels) override;
@@ -94,14 +119,13 @@ public:
     std::shared_ptr<NativeBuffer> native_buffer_handle() const override;
 
     void bind() override;
+    void bind_damaged(geometry::Rectangles const& damage) override;
 
     MemoryBackedShmBuffer(MemoryBackedShmBuffer const&) = delete;
     MemoryBackedShmBuffer& operator=(MemoryBackedShmBuffer const&) = delete;
 private:
     geometry::Stride const stride_;
     std::unique_ptr<unsigned char[]> const pixels;
-    std::mutex uploaded_mutex;
-    bool uploaded{false};
 };
 
 }
@@ -252,6 +252,7 @@ public:
         // Wait for the last flip to finish, if it hasn't already.
         pending_flip.get();
 
+        display_report->report_frame_posted(crtc_id);
         pending_flip = event_handler->expect_flip_event(
             crtc_id,
             [this](unsigned frame_count, std::chrono::milliseconds frame_time)
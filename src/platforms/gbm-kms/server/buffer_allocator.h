@@ -86,6 +86,11 @@ public:
         wl_resource* buffer,
         std::shared_ptr<Executor> wayland_executor,
         std::function<void()>&& on_consumed) -> std::shared_ptr<Buffer> override;
+    auto buffer_from_shm(
+        wl_resource* buffer,
+        std::shared_ptr<Executor> wayland_executor,
+        std::function<void()>&& on_consumed,
+        geometry::Rectangles const& damage) -> std::shared_ptr<Buffer> override;
 private:
     std::shared_ptr<Buffer> alloc_hardware_buffer(
         graphics::BufferProperties const& buffer_properties);
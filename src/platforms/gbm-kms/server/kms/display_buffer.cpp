@@ -527,9 +527,13 @@ void mgg::DisplayBuffer::set_transformation(glm::mat2 const& t, geometry::Rectan
 bool mgg::DisplayBuffer::overlay(RenderableList const& renderable_list)
 {
     glm::mat2 static const no_transformation(1);
+    plane_frame = {};
     if (transform == no_transformation &&
        (bypass_option == mgg::BypassOption::allowed))
     {
+        if (assign_planes(renderable_list))
+            return true;
+
         mgg::BypassMatch bypass_match(area);
         auto bypass_it = std::find_if(renderable_list.rbegin(), renderable_list.rend(), bypass_match);
         if (bypass_it != renderable_list.rend())
@@ -554,6 +558,70 @@ bool mgg::DisplayBuffer::overlay(RenderableList const& renderable_list)
     return false;
 }
 
+bool mgg::DisplayBuffer::assign_planes(RenderableList const& renderable_list)
+{
+    // Planes belong to a CRTC, so there's no sharing them between clones
+    if (outputs.size() != 1 || !outputs.front()->supports_planes())
+        return false;
+
+    auto const& output = outputs.front();
+    glm::mat4 const identity(1);
+    PlaneFrame frame;
+
+    for (auto const& renderable : renderable_list)
+    {
+        auto const position = renderable->screen_position();
+        auto const clip = renderable->clip_area();
+        auto const visible = clip ? position.intersection_with(clip.value()) : position;
+        if (!visible.overlaps(area))
+            continue;
+
+        /* Planes can scale, but not rotate, fade or straddle the edge of the
+         * output; leave anything like that to GL.
+         */
+        if (renderable->transformation() != identity ||
+            renderable->alpha() < 1.0f ||
+            !area.contains(visible))
+        {
+            return false;
+        }
+
+        // The primary plane must cover the whole output, with nothing showing through
+        if (frame.layers.empty() && (visible != area || renderable->shaped()))
+            return false;
+
+        auto const buffer = renderable->buffer();
+        auto const dmabuf_image = dynamic_cast<mg::DMABufBuffer*>(buffer->native_buffer_base());
+        if (!dmabuf_image)
+            return false;
+
+        /* A clipped renderable is scanned out by cropping the plane's source, which
+         * is only exact when the buffer isn't scaled onto the screen.
+         */
+        if (visible != position && buffer->size() != position.size)
+            return false;
+
+        auto const fb = output->fb_for(*dmabuf_image);
+        if (!fb)
+            return false;
+
+        frame.layers.push_back(PlaneLayer{
+            fb.get(),
+            visible != position ?
+                geom::Rectangle{geom::Point{} + (visible.top_left - position.top_left), visible.size} :
+                geom::Rectangle{{0, 0}, buffer->size()},
+            {geom::Point{} + (visible.top_left - area.top_left), visible.size}});
+        frame.buffers.push_back(buffer);
+        frame.fbs.push_back(fb);
+    }
+
+    if (frame.layers.empty() || !output->test_planes(frame.layers))
+        return false;
+
+    plane_frame = std::move(frame);
+    return true;
+}
+
 void mgg::DisplayBuffer::for_each_display_buffer(
     std::function<void(graphics::DisplayBuffer&)> const& f)
 {
@@ -562,9 +630,16 @@ void mgg::DisplayBuffer::for_each_display_buffer(
 
 void mgg::DisplayBuffer::swap_buffers()
 {
+    // The render time estimate is only used to pace single-output frames
+    if (outputs.size() == 1 && !render_fence)
+    {
+        // Signalled when the GPU has finished rendering this frame
+        render_fence = std::make_unique<EGLSyncFence>();
+    }
     surface.swap_buffers();
     bypass_buf = nullptr;
     bypass_bufobj = nullptr;
+    plane_frame = {};
 }
 
 void mgg::DisplayBuffer::set_crtc(FBHandle const& forced_frame)
@@ -593,8 +668,24 @@ void mgg::DisplayBuffer::post()
      * each frame. Just remember wait_for_page_flip() must be called at some
      * point before the next schedule_page_flip().
      */
+    if (bypass_buf || !plane_frame.layers.empty())
+    {
+        record_render_time(bypass_render_time);
+    }
+    else if (!render_fence)
+    {
+        // In clone mode there is no fence (see swap_buffers()); the frame is ready as far as we can tell
+        record_render_time(composite_render_time);
+    }
+
     wait_for_page_flip();
 
+    if (!plane_frame.layers.empty())
+    {
+        post_planes();
+        return;
+    }
+
     std::shared_ptr<mgg::FBHandle const> bufobj;
     if (bypass_buf)
     {
@@ -630,10 +721,8 @@ void mgg::DisplayBuffer::post()
         needs_set_crtc = false;
     }
 
-    using namespace std::chrono_literals;  // For operator""ms()
-
     // Predicted worst case render time for the next frame...
-    auto predicted_render_time = 50ms;
+    auto predicted_render_time = composite_render_time.estimate();
 
     if (bypass_buf)
     {
@@ -651,7 +740,7 @@ void mgg::DisplayBuffer::post()
 
         // It's very likely the next frame will be bypassed like this one so
         // we only need time for kernel page flip scheduling...
-        predicted_render_time = 5ms;
+        predicted_render_time = bypass_render_time.estimate();
     }
     else
     {
@@ -659,35 +748,125 @@ void mgg::DisplayBuffer::post()
          * Not in clone mode? We can afford to wait for the page flip then,
          * making us double-buffered (noticeably less laggy than the triple
          * buffering that clone mode requires).
+         *
+         * The flip can't complete before the GPU has finished the frame, so
+         * waiting for the render fence first to time the frame costs nothing.
          */
         if (outputs.size() == 1)
+        {
+            wait_for_render_fence();
             wait_for_page_flip();
-
-        /*
-         * TODO: If you're optimistic about your GPU performance and/or
-         *       measure it carefully you may wish to set predicted_render_time
-         *       to a lower value here for lower latency.
-         *
-         *predicted_render_time = 9ms; // e.g. about the same as Weston
-         */
+        }
     }
 
     // Buffer lifetimes are managed exclusively by scheduled*/visible* now
     bypass_buf = nullptr;
     bypass_bufobj = nullptr;
 
+    update_recommended_sleep(predicted_render_time);
+}
+
+void mgg::DisplayBuffer::post_planes()
+{
+    if (outputs.front()->schedule_planes_flip(plane_frame.layers))
+    {
+        page_flips_pending = true;
+    }
+    else
+    {
+        mir::log_error("Failed to schedule page flip of hardware planes; frame will be dropped");
+    }
+    scheduled_plane_frame = std::move(plane_frame);
+    plane_frame = {};
+
+    /*
+     * As for bypass frames, wait for the flip now rather than holding
+     * client buffers for an extra frame.
+     */
+    wait_for_page_flip();
+
+    // It's very likely the next frame will be scanned out like this one too
+    update_recommended_sleep(bypass_render_time.estimate());
+}
+
+void mgg::DisplayBuffer::record_render_time(RenderTimeEstimator& estimator)
+{
+    if (frame_start)
+    {
+        estimator.record(std::chrono::steady_clock::now() - *frame_start);
+        frame_start = std::nullopt;
+    }
+}
+
+void mgg::DisplayBuffer::wait_for_render_fence()
+{
+    if (render_fence)
+    {
+        render_fence->client_wait();
+        render_fence.reset();
+        record_render_time(composite_render_time);
+    }
+}
+
+void mgg::DisplayBuffer::update_recommended_sleep(std::chrono::milliseconds predicted_render_time)
+{
+    using namespace std::chrono_literals;  // For operator""ms()
+
     recommend_sleep = 0ms;
+    composite_deadline = std::nullopt;
     if (outputs.size() == 1)
     {
         auto const& output = outputs.front();
         auto const min_frame_interval = 1000ms / output->max_refresh_rate();
-        if (predicted_render_time < min_frame_interval)
+        auto const vblank = output->last_frame();
+
+        /*
+         * Aim to have the next frame ready just before the vblank following
+         * the one we last flipped on, measured from the flip's own timestamp
+         * rather than from whenever this thread got around to returning.
+         */
+        vblank_clock.record(vblank, min_frame_interval);
+        if (auto const next_vblank = vblank_clock.next_after(Frame::Timestamp::now(vblank.ust.clock_id)))
+        {
+            composite_deadline = *next_vblank - predicted_render_time;
+        }
+        else if (predicted_render_time < min_frame_interval)
+        {
             recommend_sleep = min_frame_interval - predicted_render_time;
+        }
     }
 }
 
+void mgg::DisplayBuffer::begin_frame()
+{
+    frame_start = std::chrono::steady_clock::now();
+}
+
+void mgg::DisplayBuffer::wait_for_frame_deadline()
+{
+    /*
+     * post() has already waited for the flip where that's needed, so the
+     * deadline is measured from that flip's own timestamp. Sleep until the
+     * deadline itself rather than for a rounded-down interval from now.
+     */
+    if (composite_deadline)
+        mir::time::sleep_until(*composite_deadline);
+    else
+        std::this_thread::sleep_for(recommend_sleep);
+}
+
 std::chrono::milliseconds mgg::DisplayBuffer::recommended_sleep() const
 {
+    if (composite_deadline)
+    {
+        auto const now = Frame::Timestamp::now(composite_deadline->clock_id);
+        if (*composite_deadline > now)
+        {
+            // Round down: waking a little early is harmless, missing the vblank is not
+            return std::chrono::duration_cast<std::chrono::milliseconds>(*composite_deadline - now);
+        }
+        return std::chrono::milliseconds::zero();
+    }
     return recommend_sleep;
 }
 
@@ -720,16 +899,19 @@ void mgg::DisplayBuffer::wait_for_page_flip()
         page_flips_pending = false;
     }
 
-    if (scheduled_bypass_frame || scheduled_composite_frame)
+    if (scheduled_bypass_frame || scheduled_composite_frame || !scheduled_plane_frame.layers.empty())
     {
-        // Why are both of these grouped into a single statement?
-        // Because in either case both types of frame need releasing each time.
+        // Why are all of these grouped into a single statement?
+        // Because in any case every type of frame needs releasing each time.
 
         visible_bypass_frame = scheduled_bypass_frame;
         scheduled_bypass_frame = nullptr;
 
         visible_composite_frame = std::move(scheduled_composite_frame);
         scheduled_composite_frame = nullptr;
+
+        visible_plane_frame = std::move(scheduled_plane_frame);
+        scheduled_plane_frame = {};
     }
 }
 
@@ -748,6 +930,11 @@ void mgg::DisplayBuffer::release_current()
     surface.release_current();
 }
 
+auto mgg::DisplayBuffer::buffer_age() const -> int
+{
+    return surface.buffer_age();
+}
+
 void mgg::DisplayBuffer::schedule_set_crtc()
 {
     needs_set_crtc = true;
@@ -806,6 +993,11 @@ void mgg::GBMOutputSurface::bind()
 
 }
 
+auto mgg::GBMOutputSurface::buffer_age() const -> int
+{
+    return egl.buffer_age();
+}
+
 auto mgg::GBMOutputSurface::lock_front() -> FrontBuffer
 {
     return FrontBuffer{surface.get()};
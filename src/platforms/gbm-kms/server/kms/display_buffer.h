@@ -21,14 +21,20 @@
 
 #include "mir/graphics/display_buffer.h"
 #include "mir/graphics/display.h"
+#include "mir/graphics/egl_sync_fence.h"
 #include "mir/renderer/gl/render_target.h"
 #include "display_helpers.h"
 #include "egl_helper.h"
 #include "platform_common.h"
+#include "kms_output.h"
+#include "render_time_estimator.h"
+#include "vblank_clock.h"
 
 #include <vector>
 #include <memory>
 #include <atomic>
+#include <chrono>
+#include <optional>
 
 namespace mir
 {
@@ -82,6 +88,7 @@ public:
     void release_current() override;
     void swap_buffers() override;
     void bind() override;
+    auto buffer_age() const -> int override;
 
     FrontBuffer lock_front();
     void report_egl_configuration(std::function<void(EGLDisplay, EGLConfig)> const& to);
@@ -113,11 +120,14 @@ public:
     void swap_buffers() override;
     bool overlay(RenderableList const& renderlist) override;
     void bind() override;
+    auto buffer_age() const -> int override;
 
     void for_each_display_buffer(
         std::function<void(graphics::DisplayBuffer&)> const& f) override;
     void post() override;
     std::chrono::milliseconds recommended_sleep() const override;
+    void begin_frame() override;
+    void wait_for_frame_deadline() override;
 
     glm::mat2 transformation() const override;
     NativeDisplayBuffer* native_display_buffer() override;
@@ -127,12 +137,29 @@ public:
     void wait_for_page_flip();
 
 private:
+    bool assign_planes(RenderableList const& renderlist);
+    void post_planes();
+    void update_recommended_sleep(std::chrono::milliseconds predicted_render_time);
+    void record_render_time(RenderTimeEstimator& estimator);
+    void wait_for_render_fence();
     bool schedule_page_flip(FBHandle const& bufobj);
     void set_crtc(FBHandle const&);
 
     std::shared_ptr<graphics::Buffer> visible_bypass_frame, scheduled_bypass_frame;
     std::shared_ptr<Buffer> bypass_buf{nullptr};
     std::shared_ptr<FBHandle const> bypass_bufobj{nullptr};
+
+    /*
+     * Renderables assigned to hardware planes, bottom-most first.
+     * The buffers and FBs are held until the frame displaying them is superseded.
+     */
+    struct PlaneFrame
+    {
+        std::vector<PlaneLayer> layers;
+        std::vector<std::shared_ptr<Buffer>> buffers;
+        std::vector<std::shared_ptr<FBHandle const>> fbs;
+    };
+    PlaneFrame plane_frame, scheduled_plane_frame, visible_plane_frame;
     std::shared_ptr<DisplayReport> const listener;
     BypassOption bypass_option;
 
@@ -157,6 +184,18 @@ private:
     glm::mat2 transform;
     std::atomic<bool> needs_set_crtc;
     std::chrono::milliseconds recommend_sleep{0};
+    VblankClock vblank_clock;
+    std::optional<Frame::Timestamp> composite_deadline;
+
+    /*
+     * Measured from the start of the frame (begin_frame()) to the frame being
+     * ready for scanout; for composited frames on a single output that's when
+     * the GPU has finished.
+     */
+    std::optional<std::chrono::steady_clock::time_point> frame_start;
+    std::unique_ptr<EGLSyncFence> render_fence;
+    RenderTimeEstimator composite_render_time{std::chrono::milliseconds{50}};
+    RenderTimeEstimator bypass_render_time{std::chrono::milliseconds{5}};
     bool page_flips_pending;
 };
 
@@ -19,6 +19,7 @@
 #include "egl_helper.h"
 #include "mir/graphics/gl_config.h"
 #include "mir/graphics/egl_error.h"
+#include <EGL/eglext.h>
 #include <boost/exception/errinfo_errno.hpp>
 #include <boost/throw_exception.hpp>
 
@@ -162,6 +163,15 @@ bool mgmh::EGLHelper::release_current() const
     return (ret == EGL_TRUE);
 }
 
+int mgmh::EGLHelper::buffer_age() const
+{
+    EGLint age{0};
+    // Without EGL_EXT_buffer_age this fails with EGL_BAD_ATTRIBUTE
+    if (eglQuerySurface(egl_display, egl_surface, EGL_BUFFER_AGE_EXT, &age) != EGL_TRUE)
+        return 0;
+    return age;
+}
+
 namespace
 {
 std::vector<EGLConfig> get_matching_configs(EGLDisplay dpy, EGLint const attr[])
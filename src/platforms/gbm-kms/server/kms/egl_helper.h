@@ -54,6 +54,8 @@ public:
     bool swap_buffers();
     bool make_current() const;
     bool release_current() const;
+    /// The EGL_EXT_buffer_age of the back buffer, or 0 if unknown
+    int buffer_age() const;
 
     EGLContext context() const { return egl_context; }
 
@@ -22,6 +22,7 @@
 #include "mir/geometry/size.h"
 #include "mir/geometry/point.h"
 #include "mir/geometry/displacement.h"
+#include "mir/geometry/rectangle.h"
 #include "mir/graphics/display_configuration.h"
 #include "mir/graphics/frame.h"
 #include "mir/graphics/dmabuf_buffer.h"
@@ -31,6 +32,8 @@
 
 #include <gbm.h>
 
+#include <vector>
+
 namespace mir
 {
 namespace graphics
@@ -42,6 +45,16 @@ namespace gbm
 
 class FBHandle;
 
+/**
+ * A framebuffer to be scanned out directly by a hardware plane.
+ */
+struct PlaneLayer
+{
+    FBHandle const* fb;                 ///< Must remain live until the flip displaying it has been superseded
+    geometry::Rectangle source;         ///< Region of the framebuffer to scan out, in buffer pixels
+    geometry::Rectangle destination;    ///< Where on the output to display it, relative to the output's origin
+};
+
 class KMSOutput
 {
 public:
@@ -70,6 +83,29 @@ public:
     virtual bool schedule_page_flip(FBHandle const& fb) = 0;
     virtual void wait_for_page_flip() = 0;
 
+    /**
+     * Whether this output can scan out renderables on its hardware planes.
+     *
+     * This requires atomic modesetting, and is only enabled if MIR_DRM_ATOMIC_PLANES is set.
+     */
+    virtual bool supports_planes() const = 0;
+    /**
+     * Check, with a TEST_ONLY commit, whether layers can be scanned out without composition.
+     *
+     * \param [in] layers   The layers to display, bottom-most first. The bottom-most layer
+     *                      is assigned to the primary plane and must cover the whole output.
+     * \return  True if the hardware accepted the plane configuration.
+     */
+    virtual bool test_planes(std::vector<PlaneLayer> const& layers) = 0;
+    /**
+     * Schedule layers to be displayed on the hardware planes at the next vblank.
+     *
+     * As with schedule_page_flip(), completion must be waited for with wait_for_page_flip().
+     * Planes enabled by this call stay enabled until the next schedule_page_flip(),
+     * schedule_planes_flip(), set_crtc() or clear_crtc().
+     */
+    virtual bool schedule_planes_flip(std::vector<PlaneLayer> const& layers) = 0;
+
     virtual bool set_cursor(gbm_bo* buffer) = 0;
     virtual void move_cursor(geometry::Point destination) = 0;
     virtual bool clear_cursor() = 0;
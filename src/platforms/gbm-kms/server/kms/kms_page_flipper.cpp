@@ -65,27 +65,77 @@ bool mgg::KMSPageFlipper::schedule_flip(uint32_t crtc_id,
                                         uint32_t fb_id,
                                         uint32_t connector_id)
 {
-    std::unique_lock<std::mutex> lock{pf_mutex};
-
-    if (pending_page_flips.find(crtc_id) != pending_page_flips.end())
-        BOOST_THROW_EXCEPTION(std::logic_error("Page flip for crtc_id is already scheduled"));
-
-    pending_page_flips[crtc_id] = PageFlipEventData{crtc_id, connector_id, this};
-
     /*
      * It appears we can't tell the difference between flipping being
      * unsupported or failing for other reasons. On VirtualBox this always
      * fails with -22 (Invalid argument) despite the arguments being
      * apparently valid.
      */
-    auto ret = drmModePageFlip(drm_fd, crtc_id, fb_id,
-                               DRM_MODE_PAGE_FLIP_EVENT,
-                               &pending_page_flips[crtc_id]);
+    return schedule(crtc_id, connector_id,
+        [&](PageFlipEventData* event_data)
+        {
+            return drmModePageFlip(drm_fd, crtc_id, fb_id,
+                                   DRM_MODE_PAGE_FLIP_EVENT,
+                                   event_data);
+        });
+}
+
+bool mgg::KMSPageFlipper::schedule_atomic_flip(
+    uint32_t crtc_id,
+    drmModeAtomicReq* request,
+    uint32_t connector_id)
+{
+    /*
+     * A non-blocking atomic commit delivers the same event as drmModePageFlip(),
+     * so it completes through wait_for_flip() in exactly the same way.
+     */
+    return schedule(crtc_id, connector_id,
+        [&](PageFlipEventData* event_data)
+        {
+            return drmModeAtomicCommit(drm_fd, request,
+                                       DRM_MODE_ATOMIC_NONBLOCK | DRM_MODE_PAGE_FLIP_EVENT,
+                                       event_data);
+        });
+}
+
+bool mgg::KMSPageFlipper::schedule(
+    uint32_t crtc_id,
+    uint32_t connector_id,
+    std::function<int(PageFlipEventData*)> const& submit)
+{
+    {
+        std::unique_lock<std::mutex> lock{pf_mutex};
+
+        if (pending_page_flips.find(crtc_id) != pending_page_flips.end())
+            BOOST_THROW_EXCEPTION(std::logic_error("Page flip for crtc_id is already scheduled"));
+
+        pending_page_flips[crtc_id] = PageFlipEventData{crtc_id, connector_id, this};
+
+        if (auto const ret = submit(&pending_page_flips[crtc_id]))
+        {
+            pending_page_flips.erase(crtc_id);
+            return false;
+        }
 
-    if (ret)
-        pending_page_flips.erase(crtc_id);
+        unreported_posts.insert(crtc_id);
+    }
+
+    report->report_frame_posted(connector_id);
+
+    std::unique_lock<std::mutex> lock{pf_mutex};
+    unreported_posts.erase(crtc_id);
 
-    return (ret == 0);
+    /* If another thread has handled the flip meanwhile, its vsync was left for us to report */
+    auto const held_back = held_back_vsyncs.find(crtc_id);
+    if (held_back != held_back_vsyncs.end())
+    {
+        auto const frame = held_back->second;
+        held_back_vsyncs.erase(held_back);
+        lock.unlock();
+
+        report->report_vsync(connector_id, frame);
+    }
+    return true;
 }
 
 mg::Frame mgg::KMSPageFlipper::wait_for_flip(uint32_t crtc_id)
@@ -184,7 +234,10 @@ void mgg::KMSPageFlipper::notify_page_flip(uint32_t crtc_id, int64_t msc,
         auto& frame = completed_page_flips[crtc_id];
         frame.msc = msc;
         frame.ust = {clock_id, ust};
-        report->report_vsync(pending->second.connector_id, frame);
+        if (unreported_posts.count(crtc_id))
+            held_back_vsyncs[crtc_id] = frame;
+        else
+            report->report_vsync(pending->second.connector_id, frame);
         pending_page_flips.erase(pending);
     }
 }
@@ -22,6 +22,8 @@
 #include "page_flipper.h"
 
 #include <unordered_map>
+#include <unordered_set>
+#include <functional>
 #include <chrono>
 #include <mutex>
 #include <condition_variable>
@@ -53,6 +55,7 @@ public:
     KMSPageFlipper(int drm_fd, std::shared_ptr<DisplayReport> const& report);
 
     bool schedule_flip(uint32_t crtc_id, uint32_t fb_id, uint32_t connector_id) override;
+    bool schedule_atomic_flip(uint32_t crtc_id, drmModeAtomicReq* request, uint32_t connector_id) override;
     Frame wait_for_flip(uint32_t crtc_id) override;
 
     std::thread::id debug_get_worker_tid();
@@ -60,11 +63,19 @@ public:
     void notify_page_flip(uint32_t crtc_id, int64_t msc, std::chrono::nanoseconds ust);
 private:
     bool page_flip_is_done(uint32_t crtc_id);
+    bool schedule(uint32_t crtc_id, uint32_t connector_id, std::function<int(PageFlipEventData*)> const& submit);
 
     int const drm_fd;
     std::shared_ptr<DisplayReport> const report;
     std::unordered_map<uint32_t,PageFlipEventData> pending_page_flips;
     std::unordered_map<uint32_t,Frame> completed_page_flips;
+    /*
+     * Flips that have been scheduled but not yet reported as posted, and the
+     * vsyncs of any of those that have already completed. The reports are made
+     * without holding pf_mutex, and a vsync is held back until after its post.
+     */
+    std::unordered_set<uint32_t> unreported_posts;
+    std::unordered_map<uint32_t,Frame> held_back_vsyncs;
     std::mutex pf_mutex;
     std::condition_variable pf_cv;
     std::thread::id worker_tid;
@@ -26,6 +26,7 @@
 #include <sys/stat.h>
 
 #include <boost/throw_exception.hpp>
+#include <algorithm>
 #include <system_error>
 #include <xf86drm.h>
 
@@ -37,9 +38,10 @@ namespace geom = mir::geometry;
 class mgg::FBHandle
 {
 public:
-    FBHandle(int drm_fd, uint32_t fb_id)
+    FBHandle(int drm_fd, uint32_t fb_id, uint32_t format)
         : drm_fd{drm_fd},
-          fb_id{fb_id}
+          fb_id{fb_id},
+          format{format}
     {
     }
 
@@ -53,16 +55,22 @@ public:
     {
         return fb_id;
     }
+
+    auto get_format() const -> uint32_t
+    {
+        return format;
+    }
 private:
     int const drm_fd;
     uint32_t const fb_id;
+    uint32_t const format;
 };
 
-
 mgg::RealKMSOutput::RealKMSOutput(
     int drm_fd,
     kms::DRMModeConnectorUPtr&& connector,
-    std::shared_ptr<PageFlipper> const& page_flipper)
+    std::shared_ptr<PageFlipper> const& page_flipper,
+    bool atomic_planes)
     : drm_fd_{drm_fd},
       page_flipper{page_flipper},
       connector{std::move(connector)},
@@ -70,6 +78,7 @@ mgg::RealKMSOutput::RealKMSOutput(
       current_crtc(),
       saved_crtc(),
       using_saved_crtc{true},
+      atomic_planes{atomic_planes},
       has_cursor_{false},
       power_mode(mir_power_mode_on)
 {
@@ -160,6 +169,12 @@ bool mgg::RealKMSOutput::set_crtc(FBHandle const& fb)
         return false;
     }
 
+    // drmModeSetCrtc() only replaces the primary plane's FB
+    {
+        std::lock_guard<std::mutex> lock{planes_mutex};
+        disable_overlay_planes();
+    }
+
     auto ret = drmModeSetCrtc(drm_fd_, current_crtc->crtc_id,
                               fb.get_drm_fb_id(), fb_offset.dx.as_int(), fb_offset.dy.as_int(),
                               &connector->connector_id, 1,
@@ -191,6 +206,11 @@ void mgg::RealKMSOutput::clear_crtc()
         return;
     }
 
+    {
+        std::lock_guard<std::mutex> lock{planes_mutex};
+        disable_overlay_planes();
+    }
+
     auto result = drmModeSetCrtc(drm_fd_, current_crtc->crtc_id,
                                  0, 0, 0, nullptr, 0, nullptr);
     if (result)
@@ -230,12 +250,223 @@ bool mgg::RealKMSOutput::schedule_page_flip(FBHandle const& fb)
                        mgk::connector_name(connector).c_str());
         return false;
     }
+    bool overlay_planes_active;
+    {
+        std::lock_guard<std::mutex> lock{planes_mutex};
+        overlay_planes_active = !active_overlay_planes.empty();
+    }
+    if (overlay_planes_active)
+    {
+        /* A legacy page flip would leave the overlay planes showing on top of
+         * the composited frame, so flip to it on the primary plane alone.
+         */
+        lg.unlock();
+        return schedule_planes_flip(
+            {PlaneLayer{&fb, {geom::Point{} + fb_offset, size()}, {{0, 0}, size()}}});
+    }
     return page_flipper->schedule_flip(
         current_crtc->crtc_id,
         fb.get_drm_fb_id(),
         connector->connector_id);
 }
 
+bool mgg::RealKMSOutput::supports_planes() const
+{
+    return atomic_planes;
+}
+
+auto mgg::RealKMSOutput::crtc_planes() -> std::vector<Plane> const&
+{
+    if (planes_crtc_id == current_crtc->crtc_id)
+        return planes;
+
+    planes.clear();
+    planes_crtc_id = current_crtc->crtc_id;
+
+    kms::DRMModeResources resources{drm_fd_};
+    auto crtc_index = 0;
+    for (auto& crtc : resources.crtcs())
+    {
+        if (crtc->crtc_id == current_crtc->crtc_id)
+            break;
+        ++crtc_index;
+    }
+
+    std::vector<Plane> usable;
+    kms::PlaneResources plane_resources{drm_fd_};
+    for (auto& plane : plane_resources.planes())
+    {
+        if (plane->possible_crtcs & (1 << crtc_index))
+        {
+            kms::ObjectProperties properties{drm_fd_, plane};
+            usable.push_back(Plane{
+                plane->plane_id,
+                properties["type"],
+                {plane->formats, plane->formats + plane->count_formats},
+                std::move(properties)});
+        }
+    }
+
+    /* Stack the planes the way we'll assign layers to them: the primary plane
+     * at the bottom and any cursor plane on top. Overlay planes keep the
+     * driver's enumeration order.
+     */
+    for (auto const type : {DRM_PLANE_TYPE_PRIMARY, DRM_PLANE_TYPE_OVERLAY, DRM_PLANE_TYPE_CURSOR})
+    {
+        for (auto const& plane : usable)
+        {
+            if (plane.type == static_cast<uint64_t>(type))
+                planes.push_back(plane);
+        }
+    }
+
+    return planes;
+}
+
+auto mgg::RealKMSOutput::planes_request(
+    std::vector<PlaneLayer> const& layers,
+    std::vector<uint32_t>& used_planes) -> AtomicReqUPtr
+{
+    AtomicReqUPtr request{drmModeAtomicAlloc(), &drmModeAtomicFree};
+
+    auto const& candidates = crtc_planes();
+    auto candidate = candidates.begin();
+    for (auto const& layer : layers)
+    {
+        auto const bottom_layer = used_planes.empty();
+        candidate = std::find_if(
+            candidate,
+            candidates.end(),
+            [this, bottom_layer, format = layer.fb->get_format()](Plane const& plane)
+            {
+                if (bottom_layer != (plane.type == DRM_PLANE_TYPE_PRIMARY))
+                    return false;
+                // The hardware cursor owns the cursor plane while it's in use
+                if (plane.type == DRM_PLANE_TYPE_CURSOR && has_cursor_)
+                    return false;
+                return std::find(plane.formats.begin(), plane.formats.end(), format) != plane.formats.end();
+            });
+
+        if (candidate == candidates.end())
+            return {nullptr, &drmModeAtomicFree};
+
+        auto const& props = candidate->properties;
+        auto const plane_id = candidate->id;
+        auto const add = [&](char const* name, uint64_t value)
+            {
+                drmModeAtomicAddProperty(request.get(), plane_id, props.id_for(name), value);
+            };
+
+        add("FB_ID", layer.fb->get_drm_fb_id());
+        add("CRTC_ID", current_crtc->crtc_id);
+
+        /* Source viewport. Coordinates are 16.16 fixed point format */
+        add("SRC_X", static_cast<uint64_t>(layer.source.top_left.x.as_int()) << 16);
+        add("SRC_Y", static_cast<uint64_t>(layer.source.top_left.y.as_int()) << 16);
+        add("SRC_W", static_cast<uint64_t>(layer.source.size.width.as_int()) << 16);
+        add("SRC_H", static_cast<uint64_t>(layer.source.size.height.as_int()) << 16);
+
+        /* Destination viewport. Coordinates are *not* 16.16 */
+        add("CRTC_X", layer.destination.top_left.x.as_int());
+        add("CRTC_Y", layer.destination.top_left.y.as_int());
+        add("CRTC_W", layer.destination.size.width.as_int());
+        add("CRTC_H", layer.destination.size.height.as_int());
+
+        used_planes.push_back(plane_id);
+        ++candidate;
+    }
+
+    // Turn off anything we're no longer using
+    for (auto const& plane : candidates)
+    {
+        if (std::find(active_overlay_planes.begin(), active_overlay_planes.end(), plane.id) !=
+                active_overlay_planes.end() &&
+            std::find(used_planes.begin(), used_planes.end(), plane.id) == used_planes.end())
+        {
+            drmModeAtomicAddProperty(request.get(), plane.id, plane.properties.id_for("FB_ID"), 0);
+            drmModeAtomicAddProperty(request.get(), plane.id, plane.properties.id_for("CRTC_ID"), 0);
+        }
+    }
+
+    return request;
+}
+
+bool mgg::RealKMSOutput::test_planes(std::vector<PlaneLayer> const& layers)
+{
+    if (!atomic_planes || layers.empty() || !current_crtc)
+        return false;
+
+    try
+    {
+        std::lock_guard<std::mutex> lock{planes_mutex};
+        std::vector<uint32_t> used_planes;
+        auto const request = planes_request(layers, used_planes);
+        if (!request)
+            return false;
+
+        return drmModeAtomicCommit(drm_fd_, request.get(), DRM_MODE_ATOMIC_TEST_ONLY, nullptr) == 0;
+    }
+    catch (std::exception const& error)
+    {
+        mir::log_debug("Failed to query planes of output %s: %s",
+                       mgk::connector_name(connector).c_str(),
+                       error.what());
+        return false;
+    }
+}
+
+bool mgg::RealKMSOutput::schedule_planes_flip(std::vector<PlaneLayer> const& layers)
+{
+    std::unique_lock<std::mutex> lg(power_mutex);
+    if (power_mode != mir_power_mode_on)
+        return true;
+    if (!current_crtc)
+    {
+        mir::log_error("Output %s has no associated CRTC to schedule page flips on",
+                       mgk::connector_name(connector).c_str());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> planes_lock{planes_mutex};
+    std::vector<uint32_t> used_planes;
+    auto const request = planes_request(layers, used_planes);
+    if (!request)
+        return false;
+
+    if (!page_flipper->schedule_atomic_flip(current_crtc->crtc_id, request.get(), connector->connector_id))
+        return false;
+
+    // The primary plane is always in use, and is managed by the legacy calls too
+    used_planes.erase(used_planes.begin());
+    active_overlay_planes = std::move(used_planes);
+    return true;
+}
+
+void mgg::RealKMSOutput::disable_overlay_planes()
+{
+    if (active_overlay_planes.empty() || !current_crtc)
+        return;
+
+    AtomicReqUPtr request{drmModeAtomicAlloc(), &drmModeAtomicFree};
+    for (auto const& plane : crtc_planes())
+    {
+        if (std::find(active_overlay_planes.begin(), active_overlay_planes.end(), plane.id) !=
+            active_overlay_planes.end())
+        {
+            drmModeAtomicAddProperty(request.get(), plane.id, plane.properties.id_for("FB_ID"), 0);
+            drmModeAtomicAddProperty(request.get(), plane.id, plane.properties.id_for("CRTC_ID"), 0);
+        }
+    }
+
+    if (auto const error = drmModeAtomicCommit(drm_fd_, request.get(), 0, nullptr))
+    {
+        mir::log_warning("Failed to disable overlay planes on output %s: %s",
+                         mgk::connector_name(connector).c_str(),
+                         strerror(-error));
+    }
+    active_overlay_planes.clear();
+}
+
 void mgg::RealKMSOutput::wait_for_page_flip()
 {
     std::unique_lock<std::mutex> lg(power_mutex);
@@ -260,6 +491,26 @@ bool mgg::RealKMSOutput::set_cursor(gbm_bo* buffer)
     int result = 0;
     if (current_crtc)
     {
+        std::lock_guard<std::mutex> lock{planes_mutex};
+
+        // The legacy cursor takes over the cursor plane, if we were using it for a layer
+        active_overlay_planes.erase(
+            std::remove_if(
+                active_overlay_planes.begin(),
+                active_overlay_planes.end(),
+                [this](uint32_t plane_id)
+                {
+                    auto const& candidates = crtc_planes();
+                    return std::any_of(
+                        candidates.begin(),
+                        candidates.end(),
+                        [plane_id](Plane const& plane)
+                        {
+                            return plane.id == plane_id && plane.type == DRM_PLANE_TYPE_CURSOR;
+                        });
+                }),
+            active_overlay_planes.end());
+
         has_cursor_ = true;
         result = drmModeSetCursor(
                 drm_fd_,
@@ -296,6 +547,7 @@ bool mgg::RealKMSOutput::clear_cursor()
     int result = 0;
     if (current_crtc)
     {
+        std::lock_guard<std::mutex> lock{planes_mutex};
         result = drmModeSetCursor(drm_fd_, current_crtc->crtc_id, 0, 0, 0);
 
         if (result)
@@ -309,6 +561,7 @@ bool mgg::RealKMSOutput::clear_cursor()
 
 bool mgg::RealKMSOutput::has_cursor() const
 {
+    std::lock_guard<std::mutex> lock{planes_mutex};
     return has_cursor_;
 }
 
@@ -665,7 +918,7 @@ auto mgg::RealKMSOutput::FBRegistry::lookup_or_create(int const drm_fd, gbm_bo*
 
     /* Create a FBHandle and associate it with the gbm_bo */
 
-    bufobj = new std::shared_ptr<FBHandle const>(new FBHandle{drm_fd, fb_id});
+    bufobj = new std::shared_ptr<FBHandle const>(new FBHandle{drm_fd, fb_id, format});
     gbm_bo_set_user_data(bo, bufobj, bo_user_data_destroy);
 
     return *bufobj;
@@ -800,7 +1053,7 @@ auto mgg::RealKMSOutput::FBRegistry::lookup_or_create(
         return nullptr;
     }
 
-    auto fb_handle = std::make_shared<FBHandle>(drm_fd, drm_fb_id);
+    auto fb_handle = std::make_shared<FBHandle>(drm_fd, drm_fb_id, image.drm_fourcc());
 
     if (existing_fb != dmabuf_fbs.end())
     {
@@ -25,6 +25,7 @@
 
 #include <memory>
 #include <mutex>
+#include <vector>
 
 namespace mir
 {
@@ -41,7 +42,8 @@ public:
     RealKMSOutput(
         int drm_fd,
         kms::DRMModeConnectorUPtr&& connector,
-        std::shared_ptr<PageFlipper> const& page_flipper);
+        std::shared_ptr<PageFlipper> const& page_flipper,
+        bool atomic_planes);
     ~RealKMSOutput();
 
     uint32_t id() const override;
@@ -56,6 +58,10 @@ public:
     bool schedule_page_flip(FBHandle const& fb) override;
     void wait_for_page_flip() override;
 
+    bool supports_planes() const override;
+    bool test_planes(std::vector<PlaneLayer> const& layers) override;
+    bool schedule_planes_flip(std::vector<PlaneLayer> const& layers) override;
+
     bool set_cursor(gbm_bo* buffer) override;
     void move_cursor(geometry::Point destination) override;
     bool clear_cursor() override;
@@ -79,6 +85,26 @@ private:
     bool ensure_crtc();
     void restore_saved_crtc();
 
+    struct Plane
+    {
+        uint32_t id;
+        uint64_t type;
+        std::vector<uint32_t> formats;
+        kms::ObjectProperties properties;
+    };
+    typedef std::unique_ptr<drmModeAtomicReq, void(*)(drmModeAtomicReqPtr)> AtomicReqUPtr;
+
+    // The plane helpers must be called with planes_mutex held
+    auto crtc_planes() -> std::vector<Plane> const&;
+    /**
+     * Build an atomic request displaying layers on current_crtc's planes.
+     *
+     * \return The request, or nullptr if there are not enough suitable planes.
+     */
+    auto planes_request(std::vector<PlaneLayer> const& layers, std::vector<uint32_t>& used_planes)
+        -> AtomicReqUPtr;
+    void disable_overlay_planes();
+
     int const drm_fd_;
     std::shared_ptr<PageFlipper> const page_flipper;
 
@@ -103,7 +129,16 @@ private:
     kms::DRMModeCrtcUPtr current_crtc;
     drmModeCrtc saved_crtc;
     bool using_saved_crtc;
+
+    bool const atomic_planes;
+    /* The cursor is updated from the input thread while the compositor assigns
+     * planes, and both claim the cursor plane, so they share this lock.
+     */
+    std::mutex mutable planes_mutex;
     bool has_cursor_;
+    uint32_t planes_crtc_id{0};
+    std::vector<Plane> planes;          ///< Planes usable on planes_crtc_id, primary first
+    std::vector<uint32_t> active_overlay_planes;
 
     MirPowerMode power_mode;
     int dpms_enum_id;
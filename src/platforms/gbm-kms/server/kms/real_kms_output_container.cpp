@@ -20,13 +20,52 @@
 #include "real_kms_output_container.h"
 #include "real_kms_output.h"
 #include "kms-utils/drm_mode_resources.h"
+#include "mir/log.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <xf86drm.h>
 
 namespace mgg = mir::graphics::gbm;
 
+namespace
+{
+char const* const mir_drm_atomic_planes = "MIR_DRM_ATOMIC_PLANES";
+
+/* The atomic client cap is a property of the DRM file description, so
+ * set it once per device rather than once per output.
+ */
+auto enable_atomic_planes(std::vector<int> const& drm_fds) -> std::unordered_map<int, bool>
+{
+    std::unordered_map<int, bool> atomic_planes;
+    auto const wanted = getenv(mir_drm_atomic_planes) != nullptr;
+
+    for (auto const drm_fd : drm_fds)
+    {
+        auto& enabled = atomic_planes[drm_fd];
+        if (!wanted)
+            continue;
+
+        if (auto const error = drmSetClientCap(drm_fd, DRM_CLIENT_CAP_ATOMIC, 1))
+        {
+            mir::log_info(
+                "%s is set but the DRM device doesn't support atomic modesetting (%s); "
+                "hardware planes will not be used",
+                mir_drm_atomic_planes,
+                strerror(-error));
+            continue;
+        }
+        enabled = true;
+    }
+    return atomic_planes;
+}
+}
+
 mgg::RealKMSOutputContainer::RealKMSOutputContainer(
     std::vector<int> const& drm_fds,
     std::function<std::shared_ptr<PageFlipper>(int)> const& construct_page_flipper)
     : drm_fds{drm_fds},
+      atomic_planes{enable_atomic_planes(drm_fds)},
       construct_page_flipper{construct_page_flipper}
 {
 }
@@ -85,7 +124,8 @@ void mgg::RealKMSOutputContainer::update_from_hardware_state()
                 new_outputs.push_back(std::make_shared<RealKMSOutput>(
                     drm_fd,
                     std::move(connector),
-                    construct_page_flipper(drm_fd)));
+                    construct_page_flipper(drm_fd),
+                    atomic_planes.at(drm_fd)));
             }
         }
 
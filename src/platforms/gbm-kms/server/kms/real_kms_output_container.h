@@ -20,6 +20,7 @@
 #define MIR_GRAPHICS_GBM_REAL_KMS_OUTPUT_CONTAINER_H_
 
 #include "kms_output_container.h"
+#include <unordered_map>
 #include <vector>
 
 namespace mir
@@ -43,6 +44,7 @@ public:
     void update_from_hardware_state() override;
 private:
     std::vector<int> const drm_fds;
+    std::unordered_map<int, bool> const atomic_planes;  ///< Whether each DRM fd accepted the atomic cap
     std::vector<std::shared_ptr<KMSOutput>> outputs;
     std::function<std::shared_ptr<PageFlipper>(int drm_fd)> const construct_page_flipper;
 };
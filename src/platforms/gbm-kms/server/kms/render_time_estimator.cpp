@@ -0,0 +1,55 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "render_time_estimator.h"
+
+#include <algorithm>
+
+namespace mgg = mir::graphics::gbm;
+
+namespace
+{
+// The fraction of recent frames that the estimate should cover
+double constexpr percentile{0.95};
+
+// Slack for scheduling jitter between waking up and starting the frame
+std::chrono::milliseconds constexpr margin{1};
+}
+
+mgg::RenderTimeEstimator::RenderTimeEstimator(std::chrono::milliseconds fallback)
+    : fallback{fallback}
+{
+}
+
+void mgg::RenderTimeEstimator::record(std::chrono::steady_clock::duration render_time)
+{
+    samples[next_sample] = render_time;
+    next_sample = (next_sample + 1) % window_size;
+    sample_count = std::min(sample_count + 1, window_size);
+}
+
+auto mgg::RenderTimeEstimator::estimate() const -> std::chrono::milliseconds
+{
+    if (sample_count < min_samples)
+        return fallback;
+
+    auto recent = samples;
+    auto const end = recent.begin() + sample_count;
+    auto const nth = recent.begin() + static_cast<std::size_t>(percentile * (sample_count - 1));
+    std::nth_element(recent.begin(), nth, end);
+
+    return std::chrono::ceil<std::chrono::milliseconds>(*nth) + margin;
+}
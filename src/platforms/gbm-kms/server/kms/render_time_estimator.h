@@ -0,0 +1,67 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GRAPHICS_GBM_RENDER_TIME_ESTIMATOR_H_
+#define MIR_GRAPHICS_GBM_RENDER_TIME_ESTIMATOR_H_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+namespace mir
+{
+namespace graphics
+{
+namespace gbm
+{
+
+/**
+ * Predicts how long the next frame will take to be ready for scanout.
+ *
+ * The prediction is a high percentile of the most recently recorded
+ * render times, so an occasional slow frame is tolerated without
+ * the estimate (and hence input latency) growing for every frame.
+ */
+class RenderTimeEstimator
+{
+public:
+    /**
+     * \param [in] fallback   The estimate to use until enough frames have been recorded
+     */
+    explicit RenderTimeEstimator(std::chrono::milliseconds fallback);
+
+    void record(std::chrono::steady_clock::duration render_time);
+
+    /**
+     * A conservative prediction of the next frame's render time, rounded up to whole milliseconds.
+     */
+    auto estimate() const -> std::chrono::milliseconds;
+
+private:
+    static std::size_t constexpr window_size{120};      // Two seconds at 60Hz
+    static std::size_t constexpr min_samples{window_size / 4};
+
+    std::chrono::milliseconds const fallback;
+    std::array<std::chrono::steady_clock::duration, window_size> samples;
+    std::size_t sample_count{0};
+    std::size_t next_sample{0};
+};
+
+}
+}
+}
+
+#endif /* MIR_GRAPHICS_GBM_RENDER_TIME_ESTIMATOR_H_ */
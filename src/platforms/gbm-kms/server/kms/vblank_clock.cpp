@@ -0,0 +1,70 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "vblank_clock.h"
+
+namespace mg = mir::graphics;
+namespace mgg = mir::graphics::gbm;
+
+void mgg::VblankClock::record(Frame const& vblank, std::chrono::nanoseconds nominal_interval)
+{
+    // A default Frame means no flip has completed yet
+    if (vblank.msc == 0 && vblank.ust.nanoseconds.count() == 0)
+        return;
+
+    if (last_vblank && vblank.msc == last_vblank->msc && vblank.ust == last_vblank->ust)
+        return;
+
+    refresh_interval = nominal_interval;
+
+    if (last_vblank &&
+        vblank.ust.clock_id == last_vblank->ust.clock_id &&
+        vblank.msc > last_vblank->msc)
+    {
+        auto const measured = (vblank.ust - last_vblank->ust) / (vblank.msc - last_vblank->msc);
+
+        // Tolerate timestamp jitter, but not a mode change or a misreported counter
+        if (measured > nominal_interval / 2 && measured < nominal_interval * 2)
+            refresh_interval = measured;
+    }
+
+    last_vblank = vblank;
+}
+
+auto mgg::VblankClock::next_after(Frame::Timestamp const& time) const -> std::optional<Frame::Timestamp>
+{
+    if (!last_vblank ||
+        last_vblank->ust.clock_id != time.clock_id ||
+        refresh_interval <= std::chrono::nanoseconds::zero())
+    {
+        return std::nullopt;
+    }
+
+    auto next = last_vblank->ust + refresh_interval;
+    if (next <= time)
+    {
+        // We've missed some vblanks (for instance while idle); stay in phase with the output
+        auto const missed = (time - next) / refresh_interval + 1;
+        next = next + missed * refresh_interval;
+    }
+
+    return next;
+}
+
+auto mgg::VblankClock::interval() const -> std::chrono::nanoseconds
+{
+    return refresh_interval;
+}
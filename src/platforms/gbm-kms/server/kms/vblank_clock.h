@@ -0,0 +1,66 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GRAPHICS_GBM_VBLANK_CLOCK_H_
+#define MIR_GRAPHICS_GBM_VBLANK_CLOCK_H_
+
+#include "mir/graphics/frame.h"
+
+#include <chrono>
+#include <optional>
+
+namespace mir
+{
+namespace graphics
+{
+namespace gbm
+{
+
+/**
+ * Predicts when an output's upcoming vblanks will happen from the
+ * timestamps of completed page flips, so that compositing can be started
+ * a fixed time before the next one rather than a fixed time after the last.
+ */
+class VblankClock
+{
+public:
+    /**
+     * Records a completed page flip.
+     *
+     * The refresh interval is measured from consecutive flips; the nominal
+     * interval of the current mode is used until that is possible and
+     * whenever a measurement is implausible.
+     */
+    void record(Frame const& vblank, std::chrono::nanoseconds nominal_interval);
+
+    /**
+     * The first predicted vblank strictly after \a time, or nothing if no
+     * flip has been recorded in the same clock domain.
+     */
+    auto next_after(Frame::Timestamp const& time) const -> std::optional<Frame::Timestamp>;
+
+    auto interval() const -> std::chrono::nanoseconds;
+
+private:
+    std::optional<Frame> last_vblank;
+    std::chrono::nanoseconds refresh_interval{0};
+};
+
+}
+}
+}
+
+#endif /* MIR_GRAPHICS_GBM_VBLANK_CLOCK_H_ */
@@ -35,7 +35,6 @@
 #include "mir/renderer/gl/context.h"
 #include "mir/graphics/program_factory.h"
 #include "mir/graphics/program.h"
-#include "egl_context_executor.h"
 #include "mir/executor.h"
 #include "shm_buffer.h"
 #include "buffer_allocator.h"
@@ -83,9 +82,7 @@ std::unique_ptr<mir::renderer::gl::Context> context_for_output(mg::Display const
 
 mg::rpi::BufferAllocator::BufferAllocator(mir::graphics::Display const& output)
     : egl_extensions{std::make_shared<mg::EGLExtensions>()},
-      ctx{context_for_output(output)},
-      egl_executor{
-        std::make_shared<mg::common::EGLContextExecutor>(context_for_output(output))}
+      ctx{context_for_output(output)}
 {
 }
 
@@ -107,9 +104,8 @@ public:
     DispmanxShmBuffer(
         geom::Size const& size,
         geom::Stride const& stride,
-        MirPixelFormat format,
-        std::shared_ptr<mg::common::EGLContextExecutor> egl_executor)
-        : ShmBuffer(size, format, std::move(egl_executor)),
+        MirPixelFormat format)
+        : ShmBuffer(size, format),
           stride_{stride},
           handle{mg::rpi::dispmanx_resource_for(size, stride_, format)}
     {
@@ -169,14 +165,17 @@ public:
 
     void bind() override
     {
-        ShmBuffer::bind();
-
         /*
          * Slowpath: we download from VideoCore memory before uploading again
          */
         read([this](auto pixels) { upload_to_texture(pixels, stride()); });
     }
 
+    void bind_damaged(geom::Rectangles const& damage) override
+    {
+        read([this, &damage](auto pixels) { upload_damage_to_texture(pixels, stride(), damage); });
+    }
+
     explicit operator DISPMANX_RESOURCE_HANDLE_T() const override
     {
         return handle;
@@ -216,8 +215,7 @@ auto mg::rpi::BufferAllocator::alloc_software_buffer(
     return std::make_shared<DispmanxShmBuffer>(
         size,
         calculate_stride(size, format),
-        format,
-        egl_executor);
+        format);
 }
 
 namespace
@@ -457,13 +455,11 @@ class DispmanxWlShmBuffer : public DispmanxShmBuffer
 public:
     DispmanxWlShmBuffer(
         wl_shm_buffer* buffer,
-        std::shared_ptr<mg::common::EGLContextExecutor> egl_executor,
         std::function<void()>&& on_consumed)
         : DispmanxShmBuffer(
             geom::Size{wl_shm_buffer_get_width(buffer), wl_shm_buffer_get_height(buffer)},
             geom::Stride{wl_shm_buffer_get_stride(buffer)},
-            wl_format_to_mir_format(wl_shm_buffer_get_format(buffer)),
-            std::move(egl_executor)),
+            wl_format_to_mir_format(wl_shm_buffer_get_format(buffer))),
           on_consumed(std::move(on_consumed))
     {
         wl_shm_buffer_begin_access(buffer);
@@ -475,18 +471,28 @@ public:
 
     void bind() override
     {
-        ShmBuffer::bind();
+        DispmanxShmBuffer::bind();
+        consume();
+    }
+
+    void bind_damaged(geom::Rectangles const& damage) override
+    {
+        DispmanxShmBuffer::bind_damaged(damage);
+        consume();
+    }
 
+private:
+    void consume()
+    {
         std::lock_guard<std::mutex> lock{consumption_mutex};
         if (on_consumed)
         {
-            read([this](auto pixels) { upload_to_texture(pixels, stride()); });
             on_consumed();
             on_consumed = nullptr;
         }
     }
 
-private:
+
     std::mutex consumption_mutex;
     std::function<void()> on_consumed;
 };
@@ -505,7 +511,6 @@ auto mg::rpi::BufferAllocator::buffer_from_shm(
 
     auto const mir_buffer = std::make_shared<DispmanxWlShmBuffer>(
         shm_buffer,
-        egl_executor,
         std::move(on_consumed));
 
     // DispmanxWlShmBuffer eagerly copies out of the wl_shm_buffer, so we're done with it here.
@@ -41,11 +41,6 @@ namespace graphics
 {
 class Display;
 
-namespace common
-{
-class EGLContextExecutor;
-}
-
 namespace rpi
 {
 class DispmanXBuffer
@@ -79,7 +74,6 @@ public:
 private:
     std::shared_ptr<EGLExtensions> const egl_extensions;
     std::shared_ptr<renderer::gl::Context> const ctx;
-    std::shared_ptr<common::EGLContextExecutor> const egl_executor;
     std::shared_ptr<Executor> wayland_executor;
 };
 }
@@ -58,6 +58,11 @@ public:
         wl_resource* buffer,
         std::shared_ptr<Executor> wayland_executor,
         std::function<void()>&& on_consumed) -> std::shared_ptr<Buffer> override;
+    auto buffer_from_shm(
+        wl_resource* buffer,
+        std::shared_ptr<Executor> wayland_executor,
+        std::function<void()>&& on_consumed,
+        geometry::Rectangles const& damage) -> std::shared_ptr<Buffer> override;
 
     std::vector<MirPixelFormat> supported_pixel_formats() override;
 
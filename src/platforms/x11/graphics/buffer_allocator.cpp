@@ -104,7 +104,7 @@ std::shared_ptr<mg::Buffer> mgx::BufferAllocator::alloc_software_buffer(
                 "Trying to create SHM buffer with unsupported pixel format"));
     }
 
-    return std::make_shared<mgc::MemoryBackedShmBuffer>(size, format, egl_delegate);
+    return std::make_shared<mgc::MemoryBackedShmBuffer>(size, format);
 }
 
 std::vector<MirPixelFormat> mgx::BufferAllocator::supported_pixel_formats()
@@ -244,3 +244,17 @@ auto mgx::BufferAllocator::buffer_from_shm(
         egl_delegate,
         std::move(on_consumed));
 }
+
+auto mgx::BufferAllocator::buffer_from_shm(
+    wl_resource* buffer,
+    std::shared_ptr<Executor> wayland_executor,
+    std::function<void()>&& on_consumed,
+    geom::Rectangles const& damage) -> std::shared_ptr<Buffer>
+{
+    return mg::wayland::buffer_from_wl_shm(
+        buffer,
+        std::move(wayland_executor),
+        egl_delegate,
+        std::move(on_consumed),
+        damage);
+}
@@ -24,6 +24,7 @@
 #include "mir/graphics/display_report.h"
 #include "mir/graphics/transformation.h"
 #include <cstring>
+#include <EGL/eglext.h>
 
 namespace mg=mir::graphics;
 namespace mgx=mg::X;
@@ -138,6 +139,7 @@ void mgx::DisplayBuffer::swap_buffers()
      * but this is best-effort. And besides, we don't want Mir reporting all
      * real vsyncs because that would mean the compositor never sleeps.
      */
+    report->report_frame_posted(output_id.as_value());
     report->report_vsync(output_id.as_value(), last_frame->load());
 }
 
@@ -145,6 +147,15 @@ void mgx::DisplayBuffer::bind()
 {
 }
 
+auto mgx::DisplayBuffer::buffer_age() const -> int
+{
+    EGLint age{0};
+    // Without EGL_EXT_buffer_age this fails with EGL_BAD_ATTRIBUTE
+    if (eglQuerySurface(egl.display(), egl.surface(), EGL_BUFFER_AGE_EXT, &age) != EGL_TRUE)
+        return 0;
+    return age;
+}
+
 glm::mat2 mgx::DisplayBuffer::transformation() const
 {
     return transform;
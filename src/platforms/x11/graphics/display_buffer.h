@@ -62,6 +62,7 @@ public:
     void release_current() override;
     void swap_buffers() override;
     void bind() override;
+    auto buffer_age() const -> int override;
     bool overlay(RenderableList const& renderlist) override;
     void set_view_area(geometry::Rectangle const& a);
     void set_transformation(glm::mat2 const& t);
@@ -0,0 +1,270 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define MIR_LOG_COMPONENT "GLRenderer"
+
+#include "program_binary_cache.h"
+#include "mir/log.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mrg = mir::renderer::gl;
+
+namespace
+{
+// Bump this whenever the file layout changes
+char const magic[] = "MIRGLPB1";
+
+// Real program binaries are tens of KB; anything claiming more than this is corrupt
+uint64_t const max_binary_size = 8 * 1024 * 1024;
+
+// FNV-1a: stable across builds, unlike std::hash
+auto fnv1a(std::string const& data, uint64_t hash = 14695981039346656037ull) -> uint64_t
+{
+    for (auto const c : data)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+void write_string(std::ostream& out, std::string const& s)
+{
+    uint64_t const size = s.size();
+    out.write(reinterpret_cast<char const*>(&size), sizeof size);
+    out.write(s.data(), s.size());
+}
+
+auto read_matches(std::istream& in, std::string const& expected) -> bool
+{
+    uint64_t size = 0;
+    if (!in.read(reinterpret_cast<char*>(&size), sizeof size) || size != expected.size())
+        return false;
+
+    std::string s(size, '\0');
+    return in.read(&s[0], size) && s == expected;
+}
+
+auto hash_of(std::string const& driver, std::string const& vertex_src, std::string const& fragment_src)
+    -> uint64_t
+{
+    return fnv1a(fragment_src, fnv1a(vertex_src, fnv1a(driver)));
+}
+
+auto path_for(std::string const& directory, uint64_t hash) -> std::string
+{
+    std::ostringstream path;
+    path << directory << "/" << std::hex << std::setw(16) << std::setfill('0') << hash << ".bin";
+    return path.str();
+}
+
+void make_directories(std::string const& path)
+{
+    for (auto pos = path.find('/', 1); ; pos = path.find('/', pos + 1))
+    {
+        auto const dir = path.substr(0, pos);
+        if (mkdir(dir.c_str(), 0700) != 0 && errno != EEXIST)
+            return;
+        if (pos == std::string::npos)
+            return;
+    }
+}
+}
+
+mrg::ProgramBinaryCache::ProgramBinaryCache(std::experimental::optional<std::string> const& directory)
+    : directory{directory}
+{
+}
+
+auto mrg::ProgramBinaryCache::load(
+    std::string const& driver,
+    std::string const& vertex_src,
+    std::string const& fragment_src) -> std::experimental::optional<Binary>
+{
+    auto const hash = hash_of(driver, vertex_src, fragment_src);
+
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto const entry = entries.find(hash);
+    if (entry != entries.end())
+    {
+        if (entry->second.driver == driver &&
+            entry->second.vertex_src == vertex_src &&
+            entry->second.fragment_src == fragment_src)
+        {
+            return entry->second.binary;
+        }
+        return {};
+    }
+
+    if (!directory)
+        return {};
+
+    Entry key{driver, vertex_src, fragment_src, {}};
+    if (auto binary = load_file(path_for(directory.value(), hash), key))
+    {
+        key.binary = binary.value();
+        entries.emplace(hash, std::move(key));
+        return binary;
+    }
+
+    return {};
+}
+
+void mrg::ProgramBinaryCache::store(
+    std::string const& driver,
+    std::string const& vertex_src,
+    std::string const& fragment_src,
+    Binary const& binary)
+{
+    auto const hash = hash_of(driver, vertex_src, fragment_src);
+    Entry entry{driver, vertex_src, fragment_src, binary};
+
+    std::lock_guard<std::mutex> lock{mutex};
+
+    if (directory && binary.data.size() <= max_binary_size)
+    {
+        make_directories(directory.value());
+        store_file(path_for(directory.value(), hash), entry);
+    }
+
+    entries[hash] = std::move(entry);
+}
+
+void mrg::ProgramBinaryCache::discard(
+    std::string const& driver,
+    std::string const& vertex_src,
+    std::string const& fragment_src)
+{
+    auto const hash = hash_of(driver, vertex_src, fragment_src);
+
+    std::lock_guard<std::mutex> lock{mutex};
+
+    entries.erase(hash);
+    if (directory)
+        unlink(path_for(directory.value(), hash).c_str());
+}
+
+auto mrg::ProgramBinaryCache::load_file(std::string const& path, Entry const& key) const
+    -> std::experimental::optional<Binary>
+{
+    std::ifstream in{path, std::ios::binary};
+    if (!in)
+        return {};
+
+    char file_magic[sizeof magic] = {};
+    if (!in.read(file_magic, sizeof file_magic) || memcmp(file_magic, magic, sizeof magic) != 0)
+        return {};
+
+    if (!read_matches(in, key.driver) ||
+        !read_matches(in, key.vertex_src) ||
+        !read_matches(in, key.fragment_src))
+    {
+        return {};
+    }
+
+    uint32_t format = 0;
+    uint64_t size = 0;
+    if (!in.read(reinterpret_cast<char*>(&format), sizeof format) ||
+        !in.read(reinterpret_cast<char*>(&size), sizeof size) ||
+        size == 0 || size > max_binary_size)
+    {
+        return {};
+    }
+
+    // The binary runs to the end of the file, so a truncated file is a miss too
+    auto const data_start = in.tellg();
+    if (!in.seekg(0, std::ios::end))
+        return {};
+    auto const file_end = in.tellg();
+    if (data_start < 0 || file_end < data_start ||
+        static_cast<uint64_t>(file_end - data_start) != size ||
+        !in.seekg(data_start))
+    {
+        return {};
+    }
+
+    Binary binary{format, std::vector<char>(size)};
+    if (!in.read(binary.data.data(), size))
+        return {};
+
+    return binary;
+}
+
+void mrg::ProgramBinaryCache::store_file(std::string const& path, Entry const& entry) const
+{
+    // Write to a private file and rename it into place so that concurrent
+    // servers never see a partially written binary
+    auto const tmp_path = path + "." + std::to_string(getpid());
+
+    {
+        std::ofstream out{tmp_path, std::ios::binary | std::ios::trunc};
+        out.write(magic, sizeof magic);
+        write_string(out, entry.driver);
+        write_string(out, entry.vertex_src);
+        write_string(out, entry.fragment_src);
+        uint32_t const format = entry.binary.format;
+        uint64_t const size = entry.binary.data.size();
+        out.write(reinterpret_cast<char const*>(&format), sizeof format);
+        out.write(reinterpret_cast<char const*>(&size), sizeof size);
+        out.write(entry.binary.data.data(), entry.binary.data.size());
+
+        if (!out.flush())
+        {
+            mir::log_debug("Failed to write GL program binary to %s", tmp_path.c_str());
+            unlink(tmp_path.c_str());
+            return;
+        }
+    }
+
+    if (rename(tmp_path.c_str(), path.c_str()) != 0)
+    {
+        mir::log_debug("Failed to write GL program binary to %s: %s", path.c_str(), strerror(errno));
+        unlink(tmp_path.c_str());
+    }
+}
+
+auto mrg::ProgramBinaryCache::default_directory() -> std::experimental::optional<std::string>
+{
+    // An empty MIR_GL_PROGRAM_CACHE_DIR disables the on-disk cache
+    if (auto const dir = getenv("MIR_GL_PROGRAM_CACHE_DIR"))
+    {
+        if (!*dir)
+            return {};
+        return std::string{dir};
+    }
+
+    auto const xdg_cache_home = getenv("XDG_CACHE_HOME");
+    if (xdg_cache_home && *xdg_cache_home)
+        return std::string{xdg_cache_home} + "/mir/gl-programs";
+
+    auto const home = getenv("HOME");
+    if (home && *home)
+        return std::string{home} + "/.cache/mir/gl-programs";
+
+    return {};
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_RENDERER_GL_PROGRAM_BINARY_CACHE_H_
+#define MIR_RENDERER_GL_PROGRAM_BINARY_CACHE_H_
+
+#include <GLES2/gl2.h>
+#include <cstdint>
+#include <experimental/optional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mir
+{
+namespace renderer
+{
+namespace gl
+{
+
+/**
+ * ProgramBinaryCache keeps linked GL program binaries (as retrieved with
+ * GL_OES_get_program_binary) so that programs linked by one renderer can be
+ * recreated by the others without compiling and linking their shaders, and
+ * (when given a directory) so that later runs can skip that too.
+ *
+ * Binaries are only valid for the driver that produced them, so each entry
+ * records the driver identity and the shader sources it was built from and
+ * is ignored unless both match exactly.
+ *
+ * A single cache may be used by renderers on different threads.
+ */
+class ProgramBinaryCache
+{
+public:
+    struct Binary
+    {
+        GLenum format;
+        std::vector<char> data;
+    };
+
+    /**
+     * \param [in] directory  Where the binaries are kept on disk (created on
+     *                        demand), or nothing to only keep them in memory
+     */
+    explicit ProgramBinaryCache(std::experimental::optional<std::string> const& directory);
+
+    /**
+     * \param [in] driver  Identifies the GL implementation, for example
+     *                     GL_VENDOR, GL_RENDERER and GL_VERSION
+     */
+    auto load(std::string const& driver, std::string const& vertex_src, std::string const& fragment_src)
+        -> std::experimental::optional<Binary>;
+    void store(
+        std::string const& driver,
+        std::string const& vertex_src,
+        std::string const& fragment_src,
+        Binary const& binary);
+    void discard(std::string const& driver, std::string const& vertex_src, std::string const& fragment_src);
+
+    /// The directory to use, or nothing if the on-disk cache is disabled
+    static auto default_directory() -> std::experimental::optional<std::string>;
+
+private:
+    struct Entry
+    {
+        std::string driver;
+        std::string vertex_src;
+        std::string fragment_src;
+        Binary binary;
+    };
+
+    auto load_file(std::string const& path, Entry const& key) const -> std::experimental::optional<Binary>;
+    void store_file(std::string const& path, Entry const& entry) const;
+
+    std::experimental::optional<std::string> const directory;
+
+    std::mutex mutex;
+    std::unordered_map<uint64_t, Entry> entries;
+};
+
+}
+}
+}
+
+#endif // MIR_RENDERER_GL_PROGRAM_BINARY_CACHE_H_
@@ -19,6 +19,7 @@
 #define MIR_LOG_COMPONENT "GLRenderer"
 
 #include "renderer.h"
+#include "program_binary_cache.h"
 #include "mir/compositor/buffer_stream.h"
 #include "mir/gl/default_program_factory.h"
 #include "mir/graphics/renderable.h"
@@ -38,10 +39,13 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <EGL/egl.h>
+#include <GLES2/gl2ext.h>
 
 #include <boost/throw_exception.hpp>
 #include <stdexcept>
 #include <cmath>
+#include <cstring>
+#include <cstddef>
 #include <sstream>
 
 namespace mg = mir::graphics;
@@ -80,6 +84,11 @@ void mrg::CurrentRenderTarget::swap_buffers()
     render_target->swap_buffers();
 }
 
+auto mrg::CurrentRenderTarget::buffer_age() const -> int
+{
+    return render_target->buffer_age();
+}
+
 const GLchar* const mrg::Renderer::vshader =
 {
     "attribute vec3 position;\n"
@@ -125,6 +134,9 @@ const GLchar* const mrg::Renderer::default_fshader =
 
 namespace
 {
+// Render targets rarely have more than triple buffering
+auto const max_buffer_age = 4u;
+
 template<void (* deleter)(GLuint)>
 class GLHandle
 {
@@ -199,8 +211,13 @@ class mrg::Renderer::ProgramFactory : public mir::graphics::gl::ProgramFactory
 {
 public:
     // NOTE: This must be called with a current GL context
-    ProgramFactory()
-        : vertex_shader{compile_shader(GL_VERTEX_SHADER, vertex_shader_src)}
+    ProgramFactory(std::shared_ptr<ProgramBinaryCache> const& binary_cache)
+        : get_program_binary{
+              reinterpret_cast<PFNGLGETPROGRAMBINARYOESPROC>(eglGetProcAddress("glGetProgramBinaryOES"))},
+          program_binary{
+              reinterpret_cast<PFNGLPROGRAMBINARYOESPROC>(eglGetProcAddress("glProgramBinaryOES"))},
+          binary_cache{get_program_binary && program_binary && supports_program_binaries() ? binary_cache : nullptr},
+          driver{driver_identity()}
     {
     }
 
@@ -260,19 +277,14 @@ public:
         // GL shader compilation is *not* threadsafe, and requires external synchronisation
         std::lock_guard<std::mutex> lock{compilation_mutex};
 
-        ShaderHandle const opaque_shader{
-            compile_shader(GL_FRAGMENT_SHADER, opaque_fragment.str().c_str())};
-        ShaderHandle const alpha_shader{
-            compile_shader(GL_FRAGMENT_SHADER, alpha_fragment.str().c_str())};
+        auto opaque_program = build_program(opaque_fragment.str());
+        auto alpha_program = build_program(alpha_fragment.str());
 
         programs.emplace_back(id, std::make_unique<::Program>(
-            link_shader(vertex_shader, opaque_shader),
-            link_shader(vertex_shader, alpha_shader)));
+            std::move(opaque_program),
+            std::move(alpha_program)));
 
         return *programs.back().second;
-
-        // We delete opaque_shader and alpha_shader here. This is fine; it only marks them
-        // for deletion. GL will only delete them once the GL Program they're linked in is destroyed.
     }
 
 private:
@@ -323,7 +335,96 @@ private:
         return program;
     }
 
-    ShaderHandle const vertex_shader;
+    static auto supports_program_binaries() -> bool
+    {
+        auto const extensions = reinterpret_cast<char const*>(glGetString(GL_EXTENSIONS));
+        if (!extensions || !strstr(extensions, "GL_OES_get_program_binary"))
+            return false;
+
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS_OES, &formats);
+        return formats > 0;
+    }
+
+    // Binaries are only usable with the driver (version) that produced them
+    static auto driver_identity() -> std::string
+    {
+        std::string driver;
+        for (auto const name : {GL_VENDOR, GL_RENDERER, GL_VERSION})
+        {
+            auto const val = reinterpret_cast<char const*>(glGetString(name));
+            driver += std::string{val ? val : ""} + "\n";
+        }
+        return driver;
+    }
+
+    // NOTE: These must be called with compilation_mutex held
+    ProgramHandle build_program(std::string const& fragment_src)
+    {
+        if (auto program = load_program(fragment_src))
+            return program;
+
+        if (!vertex_shader)
+            vertex_shader.emplace(compile_shader(GL_VERTEX_SHADER, vertex_shader_src));
+
+        // We delete the fragment shader on return. This is fine; it only marks it for
+        // deletion. GL will only delete it once the GL Program it's linked in is destroyed.
+        ShaderHandle const fragment_shader{compile_shader(GL_FRAGMENT_SHADER, fragment_src.c_str())};
+        auto program = link_shader(vertex_shader.value(), fragment_shader);
+        save_program(program, fragment_src);
+        return program;
+    }
+
+    ProgramHandle load_program(std::string const& fragment_src) const
+    {
+        if (!binary_cache)
+            return ProgramHandle{0};
+
+        auto const binary = binary_cache->load(driver, vertex_shader_src, fragment_src);
+        if (!binary)
+            return ProgramHandle{0};
+
+        ProgramHandle program{glCreateProgram()};
+        program_binary(program, binary.value().format, binary.value().data.data(), binary.value().data.size());
+
+        // The driver may still reject a binary it produced (after an update, say)
+        GLint ok = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &ok);
+        if (!ok)
+        {
+            binary_cache->discard(driver, vertex_shader_src, fragment_src);
+            return ProgramHandle{0};
+        }
+
+        return program;
+    }
+
+    void save_program(ProgramHandle const& program, std::string const& fragment_src) const
+    {
+        if (!binary_cache)
+            return;
+
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH_OES, &length);
+        if (length <= 0)
+            return;
+
+        ProgramBinaryCache::Binary binary{0, std::vector<char>(length)};
+        GLsizei written = 0;
+        get_program_binary(program, length, &written, &binary.format, binary.data.data());
+        if (written <= 0)
+            return;
+
+        binary.data.resize(written);
+        binary_cache->store(driver, vertex_shader_src, fragment_src, binary);
+    }
+
+    PFNGLGETPROGRAMBINARYOESPROC const get_program_binary;
+    PFNGLPROGRAMBINARYOESPROC const program_binary;
+    std::shared_ptr<ProgramBinaryCache> const binary_cache;
+    std::string const driver;
+    // Only compiled if a program is missing from the binary cache
+    std::experimental::optional<ShaderHandle> vertex_shader;
     std::vector<std::pair<void const*, std::unique_ptr<::Program>>> programs;
     // GL requires us to synchronise multi-threaded access to the shader APIs.
     std::mutex compilation_mutex;
@@ -350,12 +451,23 @@ mrg::Renderer::Program::Program(GLuint program_id)
 }
 
 mrg::Renderer::Renderer(graphics::DisplayBuffer& display_buffer)
+    : Renderer(
+          display_buffer,
+          std::make_shared<ProgramBinaryCache>(ProgramBinaryCache::default_directory()),
+          std::make_shared<mgl::DefaultProgramFactory>())
+{
+}
+
+mrg::Renderer::Renderer(
+    graphics::DisplayBuffer& display_buffer,
+    std::shared_ptr<ProgramBinaryCache> const& program_binaries,
+    std::shared_ptr<mgl::ProgramFactory> const& texture_caches)
     : render_target(&display_buffer),
       clear_color{0.0f, 0.0f, 0.0f, 0.0f},
       default_program(family.add_program(vshader, default_fshader)),
       alpha_program(family.add_program(vshader, alpha_fshader)),
-      program_factory{std::make_unique<ProgramFactory>()},
-      texture_cache(mgl::DefaultProgramFactory().create_texture_cache()),
+      program_factory{std::make_unique<ProgramFactory>(program_binaries)},
+      texture_cache(texture_caches->create_texture_cache()),
       display_transform(1)
 {
     eglBindAPI(EGL_OPENGL_ES_API);
@@ -405,6 +517,7 @@ mrg::Renderer::Renderer(graphics::DisplayBuffer& display_buffer)
     mir::log_info("GL framebuffer bits: RGBA=%d%d%d%d, depth=%d, stencil=%d",
                   rbits, gbits, bbits, abits, dbits, sbits);
 
+    glGenBuffers(1, &vertex_buffer);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     set_viewport(display_buffer.view_area());
@@ -413,6 +526,8 @@ mrg::Renderer::Renderer(graphics::DisplayBuffer& display_buffer)
 mrg::Renderer::~Renderer()
 {
     render_target.ensure_current();
+    if (vertex_buffer)
+        glDeleteBuffers(1, &vertex_buffer);
 }
 
 void mrg::Renderer::tessellate(std::vector<mgl::Primitive>& primitives,
@@ -424,18 +539,59 @@ void mrg::Renderer::tessellate(std::vector<mgl::Primitive>& primitives,
 
 void mrg::Renderer::render(mg::RenderableList const& renderables) const
 {
+    static glm::mat4 const identity(1);
+
     render_target.bind();
 
+    // Nothing is known about blending or the bound program, but every
+    // render() leaves scissoring disabled.
+    gl_state = GLState{};
+
+    redraw_area = area_to_redraw();
+    use_scissor(redraw_area);
+
     glClearColor(clear_color[0], clear_color[1], clear_color[2], clear_color[3]);
     glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
     glClear(GL_COLOR_BUFFER_BIT);
 
     ++frameno;
+
+    // Tessellate the whole frame up front so its vertices can be uploaded at once.
+    // Renderables are kept in z-order: blending needs them drawn back to front.
+    frame_primitives.clear();
+    frame_first_vertex.clear();
+    frame_vertices.clear();
+    frame_batches.clear();
     for (auto const& r : renderables)
     {
-        draw(*r);
+        // Untransformed renderables stay within their screen position, so can be skipped
+        if (redraw_area &&
+            r->transformation() == identity &&
+            !r->screen_position().overlaps(redraw_area.value()))
+        {
+            continue;
+        }
+
+        primitives.clear();
+        tessellate(primitives, *r);
+
+        frame_batches.emplace_back(r.get(), Batch{frame_primitives.size(), primitives.size()});
+        for (auto const& p : primitives)
+        {
+            frame_first_vertex.push_back(frame_vertices.size());
+            frame_vertices.insert(frame_vertices.end(), p.vertices, p.vertices + p.nvertices);
+            frame_primitives.push_back(p);
+        }
     }
 
+    upload_vertices();
+
+    for (auto const& batch : frame_batches)
+        draw(*batch.first, batch.second);
+
+    reset_gl_state();
+    redraw_area = std::experimental::nullopt;
+
     render_target.swap_buffers();
 
     // Deleting unused textures only requires the GL context. This clean-up
@@ -446,22 +602,168 @@ void mrg::Renderer::render(mg::RenderableList const& renderables) const
         mir::log_debug("GL error: %d", gl_error);
 }
 
-void mrg::Renderer::draw(mg::Renderable const& renderable) const
+void mrg::Renderer::upload_vertices() const
+{
+    glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer);
+
+    if (frame_vertices.empty())
+        return;
+
+    // Respecifying the whole buffer lets the driver orphan the storage still
+    // in use by the previous frame rather than stalling on it.
+    glBufferData(GL_ARRAY_BUFFER,
+                 frame_vertices.size() * sizeof(mgl::Vertex),
+                 frame_vertices.data(),
+                 GL_STREAM_DRAW);
+}
+
+void mrg::Renderer::use_program(Program const& prog) const
+{
+    if (gl_state.program != prog.id)
+    {
+        glUseProgram(prog.id);
+        gl_state.program = prog.id;
+    }
+
+    // Attribute arrays are global state, so only need repointing when a
+    // program with different attribute locations is used
+    if (gl_state.position_attr != prog.position_attr)
+    {
+        if (gl_state.position_attr >= 0)
+            glDisableVertexAttribArray(gl_state.position_attr);
+        glEnableVertexAttribArray(prog.position_attr);
+        glVertexAttribPointer(prog.position_attr, 3, GL_FLOAT,
+                              GL_FALSE, sizeof(mgl::Vertex),
+                              reinterpret_cast<GLvoid const*>(offsetof(mgl::Vertex, position)));
+        gl_state.position_attr = prog.position_attr;
+    }
+    if (gl_state.texcoord_attr != prog.texcoord_attr)
+    {
+        if (gl_state.texcoord_attr >= 0)
+            glDisableVertexAttribArray(gl_state.texcoord_attr);
+        glEnableVertexAttribArray(prog.texcoord_attr);
+        glVertexAttribPointer(prog.texcoord_attr, 2, GL_FLOAT,
+                              GL_FALSE, sizeof(mgl::Vertex),
+                              reinterpret_cast<GLvoid const*>(offsetof(mgl::Vertex, texcoord)));
+        gl_state.texcoord_attr = prog.texcoord_attr;
+    }
+}
+
+void mrg::Renderer::use_scissor(std::experimental::optional<geom::Rectangle> const& area) const
+{
+    if (area == gl_state.scissor)
+        return;
+
+    if (area)
+    {
+        if (!gl_state.scissor)
+            glEnable(GL_SCISSOR_TEST);
+        set_scissor(area.value());
+    }
+    else
+    {
+        glDisable(GL_SCISSOR_TEST);
+    }
+    gl_state.scissor = area;
+}
+
+void mrg::Renderer::use_blend(GLenum src_rgb, GLenum dst_rgb, GLenum src_alpha, GLenum dst_alpha) const
+{
+    if (gl_state.blend_enabled != true)
+    {
+        glEnable(GL_BLEND);
+        gl_state.blend_enabled = true;
+    }
+
+    std::array<GLenum, 4> const func{{src_rgb, dst_rgb, src_alpha, dst_alpha}};
+    if (gl_state.blend_func != func)
+    {
+        glBlendFuncSeparate(src_rgb, dst_rgb, src_alpha, dst_alpha);
+        gl_state.blend_func = func;
+    }
+}
+
+void mrg::Renderer::disable_blend() const
+{
+    if (gl_state.blend_enabled != false)
+    {
+        glDisable(GL_BLEND);
+        gl_state.blend_enabled = false;
+    }
+}
+
+void mrg::Renderer::reset_gl_state() const
+{
+    if (gl_state.texcoord_attr >= 0)
+        glDisableVertexAttribArray(gl_state.texcoord_attr);
+    if (gl_state.position_attr >= 0)
+        glDisableVertexAttribArray(gl_state.position_attr);
+    gl_state.texcoord_attr = gl_state.position_attr = -1;
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    use_scissor(std::experimental::nullopt);
+}
+
+auto mrg::Renderer::area_to_redraw() const -> std::experimental::optional<geom::Rectangle>
+{
+    auto const damage = std::move(next_frame_damage);
+    next_frame_damage = std::experimental::nullopt;
+
+    if (!damage || !partial_redraw_possible || back_buffers_stale)
+    {
+        // Nothing is known about the contents of older buffers
+        damage_history.clear();
+        back_buffers_stale = false;
+        return std::experimental::nullopt;
+    }
+
+    damage_history.push_front(damage.value());
+    if (damage_history.size() > max_buffer_age)
+        damage_history.pop_back();
+
+    // The back buffer is missing the damage of every frame since it was last drawn
+    auto const age = render_target.buffer_age();
+    if (age <= 0 || static_cast<unsigned>(age) > damage_history.size())
+        return std::experimental::nullopt;
+
+    geom::Rectangles region;
+    for (auto frame = damage_history.begin(); frame != damage_history.begin() + age; ++frame)
+    {
+        for (auto const& rect : *frame)
+            region.add(rect);
+    }
+
+    // Redrawing the bounding rectangle is much cheaper than a scissored pass per rectangle
+    return region.bounding_rectangle().intersection_with(viewport);
+}
+
+void mrg::Renderer::set_scissor(geom::Rectangle const& area) const
+{
+    glScissor(
+        area.top_left.x.as_int() -
+            viewport.top_left.x.as_int(),
+        viewport.top_left.y.as_int() +
+            viewport.size.height.as_int() -
+            area.top_left.y.as_int() -
+            area.size.height.as_int(),
+        area.size.width.as_int(),
+        area.size.height.as_int()
+    );
+}
+
+void mrg::Renderer::draw(mg::Renderable const& renderable, Batch const& batch) const
 {
     auto const clip_area = renderable.clip_area();
     if (clip_area)
     {
-        glEnable(GL_SCISSOR_TEST);
-        glScissor(
-            clip_area.value().top_left.x.as_int() -
-                viewport.top_left.x.as_int(),
-            viewport.top_left.y.as_int() +
-                viewport.size.height.as_int() -
-                clip_area.value().top_left.y.as_int() -
-                clip_area.value().size.height.as_int(),
-            clip_area.value().size.width.as_int(), 
-            clip_area.value().size.height.as_int()
-        );
+        use_scissor(
+            redraw_area ?
+                clip_area.value().intersection_with(redraw_area.value()) :
+                clip_area.value());
+    }
+    else
+    {
+        use_scissor(redraw_area);
     }
 
     auto const texture = std::dynamic_pointer_cast<mg::gl::Texture>(renderable.buffer());
@@ -513,7 +815,7 @@ void mrg::Renderer::draw(mg::Renderable const& renderable) const
 
     auto const& prog = *maybe_prog;
 
-    glUseProgram(prog.id);
+    use_program(prog);
     if (prog.last_used_frameno != frameno)
     {   // Avoid reloading the screen-global uniforms on every renderable
         // TODO: We actually only need to bind these *once*, right? Not once per frame?
@@ -529,17 +831,13 @@ void mrg::Renderer::draw(mg::Renderable const& renderable) const
                            glm::value_ptr(display_transform));
         glUniformMatrix4fv(prog.screen_to_gl_coords_uniform, 1, GL_FALSE,
                            glm::value_ptr(screen_to_gl_coords));
+        prog.loaded_transform = std::experimental::nullopt;
+        prog.loaded_centre = std::experimental::nullopt;
+        prog.loaded_alpha = std::experimental::nullopt;
     }
 
     glActiveTexture(GL_TEXTURE0);
 
-    auto const& rect = renderable.screen_position();
-    GLfloat centrex = rect.top_left.x.as_int() +
-                      rect.size.width.as_int() / 2.0f;
-    GLfloat centrey = rect.top_left.y.as_int() +
-                      rect.size.height.as_int() / 2.0f;
-    glUniform2f(prog.centre_uniform, centrex, centrey);
-
     glm::mat4 transform = renderable.transformation();
     if (texture && (texture->layout() == mg::gl::Texture::Layout::TopRowFirst))
     {
@@ -553,53 +851,57 @@ void mrg::Renderer::draw(mg::Renderable const& renderable) const
         };
     }
 
-    glUniformMatrix4fv(prog.transform_uniform, 1, GL_FALSE,
-                       glm::value_ptr(transform));
-
-    if (prog.alpha_uniform >= 0)
-        glUniform1f(prog.alpha_uniform, renderable.alpha());
+    if (prog.loaded_transform != transform)
+    {
+        glUniformMatrix4fv(prog.transform_uniform, 1, GL_FALSE,
+                           glm::value_ptr(transform));
+        prog.loaded_transform = transform;
+    }
 
-    glEnableVertexAttribArray(prog.position_attr);
-    glEnableVertexAttribArray(prog.texcoord_attr);
+    auto const& rect = renderable.screen_position();
+    glm::vec2 const centre{
+        rect.top_left.x.as_int() + rect.size.width.as_int() / 2.0f,
+        rect.top_left.y.as_int() + rect.size.height.as_int() / 2.0f};
+    if (prog.loaded_centre != centre)
+    {
+        glUniform2f(prog.centre_uniform, centre.x, centre.y);
+        prog.loaded_centre = centre;
+    }
 
-    primitives.clear();
-    tessellate(primitives, renderable);
+    if (prog.alpha_uniform >= 0 && prog.loaded_alpha != renderable.alpha())
+    {
+        glUniform1f(prog.alpha_uniform, renderable.alpha());
+        prog.loaded_alpha = renderable.alpha();
+    }
 
     // if we fail to load the texture, we need to carry on (part of lp:1629275)
     try
     {
-        typedef struct  // Represents parameters of glBlendFuncSeparate()
-        {
-            GLenum src_rgb, dst_rgb, src_alpha, dst_alpha;
-        } BlendSeparate;
-
-        BlendSeparate client_blend;
-
         // These renderable method names could be better (see LP: #1236224)
         if (renderable.shaped())  // Client is RGBA:
         {
-            client_blend = {GL_ONE, GL_ONE_MINUS_SRC_ALPHA,
-                            GL_ONE, GL_ONE_MINUS_SRC_ALPHA};
+            use_blend(GL_ONE, GL_ONE_MINUS_SRC_ALPHA,
+                      GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
         }
         else if (renderable.alpha() == 1.0f)  // RGBX and no window translucency:
         {
-            client_blend = {GL_ONE,  GL_ZERO,
-                            GL_ZERO, GL_ONE};  // Avoid using src_alpha!
+            disable_blend();  // Avoid using src_alpha!
         }
         else
         {   // Client is RGBX but we also have window translucency.
             // The texture alpha channel is possibly uninitialized so we must be
             // careful and avoid using SRC_ALPHA (LP: #1423462).
-            client_blend = {GL_ONE,  GL_ONE_MINUS_CONSTANT_ALPHA,
-                            GL_ZERO, GL_ONE};
-            glBlendColor(0.0f, 0.0f, 0.0f, renderable.alpha());
+            use_blend(GL_ONE,  GL_ONE_MINUS_CONSTANT_ALPHA,
+                      GL_ZERO, GL_ONE);
+            if (gl_state.blend_alpha != renderable.alpha())
+            {
+                glBlendColor(0.0f, 0.0f, 0.0f, renderable.alpha());
+                gl_state.blend_alpha = renderable.alpha();
+            }
         }
 
-        for (auto const& p : primitives)
+        for (auto i = batch.first_primitive; i != batch.first_primitive + batch.primitive_count; ++i)
         {
-            BlendSeparate blend;
-
-            blend = client_blend;
             if (surface_tex)
             {
                 surface_tex->bind();
@@ -609,25 +911,8 @@ void mrg::Renderer::draw(mg::Renderable const& renderable) const
                 texture->bind();
             }
 
-            glVertexAttribPointer(prog.position_attr, 3, GL_FLOAT,
-                                  GL_FALSE, sizeof(mgl::Vertex),
-                                  &p.vertices[0].position);
-            glVertexAttribPointer(prog.texcoord_attr, 2, GL_FLOAT,
-                                  GL_FALSE, sizeof(mgl::Vertex),
-                                  &p.vertices[0].texcoord);
-
-            if (blend.dst_rgb == GL_ZERO)
-            {
-                glDisable(GL_BLEND);
-            }
-            else
-            {
-                glEnable(GL_BLEND);
-                glBlendFuncSeparate(blend.src_rgb,   blend.dst_rgb,
-                                    blend.src_alpha, blend.dst_alpha);
-            }
-
-            glDrawArrays(p.type, 0, p.nvertices);
+            auto const& p = frame_primitives[i];
+            glDrawArrays(p.type, frame_first_vertex[i], p.nvertices);
 
             if (texture)
             {
@@ -640,13 +925,6 @@ void mrg::Renderer::draw(mg::Renderable const& renderable) const
     {
         report_exception();
     }
-
-    glDisableVertexAttribArray(prog.texcoord_attr);
-    glDisableVertexAttribArray(prog.position_attr);
-    if (renderable.clip_area())
-    {
-        glDisable(GL_SCISSOR_TEST);
-    }
 }
 
 void mrg::Renderer::set_viewport(geometry::Rectangle const& rect)
@@ -725,7 +1003,19 @@ void mrg::Renderer::update_gl_viewport()
         GLint offset_y = (buf_height - reduced_height) / 2;
 
         glViewport(offset_x, offset_y, reduced_width, reduced_height);
+
+        partial_redraw_possible =
+            display_transform == glm::mat4(1) &&
+            offset_x == 0 && offset_y == 0 &&
+            viewport.size == geom::Size{buf_width, buf_height};
+    }
+    else
+    {
+        partial_redraw_possible = false;
     }
+
+    // Whatever is in the back buffers was drawn with different parameters
+    back_buffers_stale = true;
 }
 
 void mrg::Renderer::set_output_transform(glm::mat2 const& t)
@@ -738,8 +1028,17 @@ void mrg::Renderer::set_output_transform(glm::mat2 const& t)
     }
 }
 
+void mrg::Renderer::set_damage(geom::Rectangles const& damage)
+{
+    next_frame_damage = damage;
+}
+
 void mrg::Renderer::suspend()
 {
     texture_cache->invalidate();
+    // Something other than us is updating the screen, and the damage of
+    // those frames never reaches us
+    back_buffers_stale = true;
+    next_frame_damage = std::experimental::nullopt;
 }
 
@@ -29,13 +29,16 @@
 #include "mir/renderer/gl/render_target.h"
 
 #include <GLES2/gl2.h>
+#include <array>
+#include <deque>
+#include <experimental/optional>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 namespace mir
 {
-namespace gl { class TextureCache; }
+namespace gl { class TextureCache; class ProgramFactory; }
 namespace graphics { class DisplayBuffer; }
 namespace renderer
 {
@@ -51,20 +54,32 @@ public:
     void ensure_current();
     void bind();
     void swap_buffers();
+    auto buffer_age() const -> int;
 
 private:
     renderer::gl::RenderTarget* const render_target;
 };
 
+class ProgramBinaryCache;
+
 class Renderer : public renderer::Renderer
 {
 public:
     Renderer(graphics::DisplayBuffer& display_buffer);
+    /**
+     * Renderers sharing program_binaries only compile each shader program once,
+     * and those sharing texture_caches only upload each client buffer once.
+     */
+    Renderer(
+        graphics::DisplayBuffer& display_buffer,
+        std::shared_ptr<ProgramBinaryCache> const& program_binaries,
+        std::shared_ptr<mir::gl::ProgramFactory> const& texture_caches);
     virtual ~Renderer();
 
     // These are called with a valid GL context:
     void set_viewport(geometry::Rectangle const& rect) override;
     void set_output_transform(glm::mat2 const&) override;
+    void set_damage(geometry::Rectangles const& damage) override;
     void render(graphics::RenderableList const&) const override;
 
     // This is called _without_ a GL context:
@@ -87,6 +102,11 @@ public:
         GLint alpha_uniform = -1;
         mutable long long last_used_frameno = 0;
 
+        /// Per-renderable uniform values last loaded this frame (to skip reloading them)
+        mutable std::experimental::optional<glm::mat4> loaded_transform;
+        mutable std::experimental::optional<glm::vec2> loaded_centre;
+        mutable std::experimental::optional<GLfloat> loaded_alpha;
+
         Program(GLuint program_id);
     };
 private:
@@ -123,10 +143,29 @@ protected:
     static const GLchar* const default_fshader;
     static const GLchar* const alpha_fshader;
 
-    virtual void draw(graphics::Renderable const& renderable) const;
+    /// The primitives of one renderable within the frame's vertex buffer
+    struct Batch
+    {
+        std::size_t first_primitive;
+        std::size_t primitive_count;
+    };
+
+    /**
+     * draw issues the GL calls for a renderable whose primitives have been
+     * tessellated into the frame's vertex buffer by render().
+     */
+    virtual void draw(graphics::Renderable const& renderable, Batch const& batch) const;
 
 private:
     void update_gl_viewport();
+    auto area_to_redraw() const -> std::experimental::optional<geometry::Rectangle>;
+    void set_scissor(geometry::Rectangle const& area) const;
+    void upload_vertices() const;
+    void use_program(Program const& prog) const;
+    void use_scissor(std::experimental::optional<geometry::Rectangle> const& area) const;
+    void use_blend(GLenum src_rgb, GLenum dst_rgb, GLenum src_alpha, GLenum dst_alpha) const;
+    void disable_blend() const;
+    void reset_gl_state() const;
 
     class ProgramFactory;
     std::unique_ptr<ProgramFactory> const program_factory;
@@ -135,6 +174,36 @@ private:
     glm::mat4 screen_to_gl_coords;
     glm::mat4 display_transform;
     std::vector<mir::gl::Primitive> mutable primitives;
+
+    /// Every primitive of the current frame, streamed to the GPU in one upload
+    std::vector<mir::gl::Primitive> mutable frame_primitives;
+    std::vector<GLint> mutable frame_first_vertex;
+    std::vector<mir::gl::Vertex> mutable frame_vertices;
+    std::vector<std::pair<graphics::Renderable const*, Batch>> mutable frame_batches;
+    GLuint vertex_buffer{0};
+
+    /// GL state set by the current render(), so that redundant changes can be skipped
+    struct GLState
+    {
+        GLuint program{0};
+        GLint position_attr{-1};
+        GLint texcoord_attr{-1};
+        std::experimental::optional<bool> blend_enabled;
+        std::experimental::optional<std::array<GLenum, 4>> blend_func;
+        std::experimental::optional<GLfloat> blend_alpha;
+        std::experimental::optional<geometry::Rectangle> scissor;
+    };
+    GLState mutable gl_state;
+
+    /// Scissoring is only used when the viewport maps 1:1 onto the render target
+    bool partial_redraw_possible{false};
+    std::experimental::optional<geometry::Rectangles> mutable next_frame_damage;
+    /// Damage of the most recent frames (newest first) for redrawing aged buffers
+    std::deque<geometry::Rectangles> mutable damage_history;
+    /// Whether the back buffers may miss frames that damage_history knows nothing of
+    bool mutable back_buffers_stale{true};
+    /// The area being redrawn by the current render(), if not everything
+    std::experimental::optional<geometry::Rectangle> mutable redraw_area;
 };
 
 }
@@ -18,13 +18,22 @@
 
 #include "renderer_factory.h"
 #include "renderer.h"
+#include "program_binary_cache.h"
+#include "mir/gl/default_program_factory.h"
 #include "mir/graphics/display_buffer.h"
 
 namespace mrg = mir::renderer::gl;
+namespace mgl = mir::gl;
+
+mrg::RendererFactory::RendererFactory()
+    : program_binaries{std::make_shared<ProgramBinaryCache>(ProgramBinaryCache::default_directory())},
+      texture_caches{std::make_shared<mgl::DefaultProgramFactory>()}
+{
+}
 
 std::unique_ptr<mir::renderer::Renderer>
 mrg::RendererFactory::create_renderer_for(
     graphics::DisplayBuffer& display_buffer)
 {
-    return std::make_unique<Renderer>(display_buffer);
+    return std::make_unique<Renderer>(display_buffer, program_binaries, texture_caches);
 }
@@ -21,18 +21,31 @@
 
 #include "mir/renderer/renderer_factory.h"
 
+#include <memory>
+
 namespace mir
 {
+namespace gl { class ProgramFactory; }
 namespace renderer
 {
 namespace gl
 {
 
+class ProgramBinaryCache;
+
 class RendererFactory : public renderer::RendererFactory
 {
 public:
+    RendererFactory();
+
     std::unique_ptr<renderer::Renderer> create_renderer_for(
         graphics::DisplayBuffer& display_buffer) override;
+
+private:
+    /// Shared by every output's renderer, so each program is only compiled once
+    std::shared_ptr<ProgramBinaryCache> const program_binaries;
+    /// Shared by every output's renderer, so each client buffer is only uploaded once
+    std::shared_ptr<mir::gl::ProgramFactory> const texture_caches;
 };
 
 }
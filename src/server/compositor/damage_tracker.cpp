@@ -0,0 +1,164 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "damage_tracker.h"
+#include "mir/graphics/buffer.h"
+#include "mir/geometry/displacement.h"
+
+#include <cmath>
+#include <unordered_map>
+
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+namespace geom = mir::geometry;
+
+namespace
+{
+/// Maps a rectangle of a buffer onto the screen area it is drawn to
+auto buffer_to_screen(
+    geom::Rectangle const& damage,
+    geom::Size const& buffer_size,
+    geom::Rectangle const& screen_position) -> geom::Rectangle
+{
+    if (buffer_size == screen_position.size)
+        return {screen_position.top_left + as_displacement(damage.top_left), damage.size};
+
+    auto const x_scale = float(screen_position.size.width.as_int()) / buffer_size.width.as_int();
+    auto const y_scale = float(screen_position.size.height.as_int()) / buffer_size.height.as_int();
+
+    // Round outwards; sampling can bleed into neighbouring pixels when scaling
+    auto const left = int(std::floor(damage.left().as_int() * x_scale)) - 1;
+    auto const top = int(std::floor(damage.top().as_int() * y_scale)) - 1;
+    auto const right = int(std::ceil(damage.right().as_int() * x_scale)) + 1;
+    auto const bottom = int(std::ceil(damage.bottom().as_int() * y_scale)) + 1;
+
+    return {
+        screen_position.top_left + geom::Displacement{left, top},
+        geom::Size{right - left, bottom - top}};
+}
+}
+
+auto mc::DamageTracker::damage_for(
+    mg::RenderableList const& renderables,
+    geom::Rectangle const& view_area) -> geom::Rectangles
+{
+    static glm::mat4 const identity(1);
+
+    std::vector<RenderableState> current;
+    current.reserve(renderables.size());
+
+    bool damage_everything = previous_view_area != view_area;
+    for (auto const& renderable : renderables)
+    {
+        // We can't tell where a transformed renderable ends up on screen
+        if (renderable->transformation() != identity)
+            damage_everything = true;
+
+        auto const buffer = renderable->buffer();
+        current.push_back({
+            renderable->id(),
+            buffer ? buffer->id() : mg::BufferID{},
+            renderable->screen_position(),
+            renderable->clip_area(),
+            renderable->alpha(),
+            renderable->shaped()});
+    }
+
+    auto const previous_state = std::move(previous);
+    previous = current;
+    previous_view_area = view_area;
+
+    if (damage_everything)
+        return {view_area};
+
+    auto const visible_area = [&view_area](RenderableState const& state)
+        {
+            auto const area = state.position.intersection_with(view_area);
+            return state.clip_area ? area.intersection_with(state.clip_area.value()) : area;
+        };
+
+    geom::Rectangles damage;
+    auto const add_damage = [&damage](geom::Rectangle const& rect)
+        {
+            if (rect != geom::Rectangle{})
+                damage.add(rect);
+        };
+
+    // Renderables common to both frames, mapped to their index in each
+    std::unordered_map<mg::Renderable::ID, std::size_t> previous_index;
+    for (auto i = 0u; i != previous_state.size(); ++i)
+        previous_index[previous_state[i].id] = i;
+
+    std::unordered_map<mg::Renderable::ID, std::size_t> current_index;
+    for (auto i = 0u; i != current.size(); ++i)
+        current_index[current[i].id] = i;
+
+    // Rank amongst the renderables common to both frames; a change of rank is a restack
+    std::unordered_map<mg::Renderable::ID, std::size_t> previous_rank;
+    for (auto const& state : previous_state)
+    {
+        if (current_index.count(state.id))
+            previous_rank.emplace(state.id, previous_rank.size());
+        else
+            add_damage(visible_area(state));
+    }
+
+    std::size_t current_rank = 0;
+    for (auto i = 0u; i != current.size(); ++i)
+    {
+        auto const& now = current[i];
+        auto const found = previous_index.find(now.id);
+
+        if (found == previous_index.end())
+        {
+            add_damage(visible_area(now));
+            continue;
+        }
+
+        auto const& before = previous_state[found->second];
+
+        if (previous_rank[now.id] != current_rank++ ||
+            before.position != now.position ||
+            before.clip_area != now.clip_area ||
+            before.alpha != now.alpha ||
+            before.shaped != now.shaped)
+        {
+            add_damage(visible_area(before));
+            add_damage(visible_area(now));
+        }
+        else if (before.buffer != now.buffer)
+        {
+            auto const& renderable = *renderables[i];
+            auto const buffer = renderable.buffer();
+            auto const buffer_damage = renderable.buffer_damage_since(before.buffer);
+
+            if (buffer && buffer_damage)
+            {
+                for (auto const& rect : buffer_damage.value())
+                {
+                    add_damage(
+                        buffer_to_screen(rect, buffer->size(), now.position).intersection_with(visible_area(now)));
+                }
+            }
+            else
+            {
+                add_damage(visible_area(now));
+            }
+        }
+    }
+
+    return damage;
+}
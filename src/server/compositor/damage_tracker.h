@@ -0,0 +1,63 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_COMPOSITOR_DAMAGE_TRACKER_H_
+#define MIR_COMPOSITOR_DAMAGE_TRACKER_H_
+
+#include "mir/graphics/renderable.h"
+#include "mir/geometry/rectangles.h"
+
+#include <vector>
+
+namespace mir
+{
+namespace compositor
+{
+
+/// Works out which parts of an output change from one frame to the next
+class DamageTracker
+{
+public:
+    /**
+     * The region of \a view_area whose contents differ between the
+     * renderables passed to the previous call and \a renderables.
+     *
+     * \note The first call, and any call following a change of view area,
+     *       damages the whole of \a view_area.
+     */
+    auto damage_for(
+        graphics::RenderableList const& renderables,
+        geometry::Rectangle const& view_area) -> geometry::Rectangles;
+
+private:
+    struct RenderableState
+    {
+        graphics::Renderable::ID id;
+        graphics::BufferID buffer;
+        geometry::Rectangle position;
+        std::experimental::optional<geometry::Rectangle> clip_area;
+        float alpha;
+        bool shaped;
+    };
+
+    std::vector<RenderableState> previous;
+    std::experimental::optional<geometry::Rectangle> previous_view_area;
+};
+
+}
+}
+
+#endif /* MIR_COMPOSITOR_DAMAGE_TRACKER_H_ */
@@ -79,8 +79,10 @@ void mc::DefaultDisplayBufferCompositor::composite(mc::SceneElementSequence&& sc
     }
     else
     {
+        // Only GL-composited frames count: the damage is relative to what the renderer last drew
         renderer->set_output_transform(display_buffer.transformation());
         renderer->set_viewport(view_area);
+        renderer->set_damage(damage_tracker.damage_for(renderable_list, view_area));
         renderer->render(renderable_list);
 
         report->renderables_in_frame(this, renderable_list);
@@ -135,6 +135,7 @@ public:
                     not_posted_yet = false;
                     lock.unlock();
 
+                    group.begin_frame();
                     for (auto& tuple : compositors)
                     {
                         auto& compositor = std::get<1>(tuple);
@@ -149,9 +150,10 @@ public:
                      * the latency between snapshotting the scene and post()
                      * completing by almost a whole frame.
                      */
-                    auto delay = force_sleep >= std::chrono::milliseconds::zero() ?
-                                 force_sleep : group.recommended_sleep();
-                    std::this_thread::sleep_for(delay);
+                    if (force_sleep >= std::chrono::milliseconds::zero())
+                        std::this_thread::sleep_for(force_sleep);
+                    else
+                        group.wait_for_frame_deadline();
 
                     lock.lock();
 
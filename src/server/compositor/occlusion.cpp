@@ -17,6 +17,7 @@
  */
 
 #include "mir/geometry/rectangle.h"
+#include "mir/geometry/rectangles.h"
 #include "mir/compositor/scene_element.h"
 #include "mir/graphics/renderable.h"
 #include "occlusion.h"
@@ -29,10 +30,55 @@ using namespace mir::compositor;
 
 namespace
 {
+/// Whether \a rect is entirely covered by the union of coverage[first...]
+bool is_covered(
+    Rectangle const& rect,
+    Rectangles const& coverage,
+    Rectangles::const_iterator first)
+{
+    for (auto r = first; r != coverage.end(); ++r)
+    {
+        if (r->contains(rect))
+            return true;
+
+        auto const overlap = rect.intersection_with(*r);
+        if (overlap == Rectangle{})
+            continue;
+
+        // Whatever isn't covered by *r needs covering by the remaining rectangles.
+        // Split it into (up to) four pieces: above, below, left and right of the overlap.
+        auto const width = rect.size.width.as_int();
+        auto const left_width = (overlap.left() - rect.left()).as_int();
+        auto const right_width = (rect.right() - overlap.right()).as_int();
+        auto const above_height = (overlap.top() - rect.top()).as_int();
+        auto const below_height = (rect.bottom() - overlap.bottom()).as_int();
+        auto const overlap_height = overlap.size.height.as_int();
+
+        Rectangle const uncovered[] = {
+            {rect.top_left, {width, above_height}},
+            {{rect.left(), overlap.bottom()}, {width, below_height}},
+            {{rect.left(), overlap.top()}, {left_width, overlap_height}},
+            {{overlap.right(), overlap.top()}, {right_width, overlap_height}}};
+
+        for (auto const& piece : uncovered)
+        {
+            if (piece.size.width.as_int() > 0 && piece.size.height.as_int() > 0 &&
+                !is_covered(piece, coverage, std::next(r)))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
 bool renderable_is_occluded(
     Renderable const& renderable, 
     Rectangle const& area,
-    std::vector<Rectangle>& coverage)
+    Rectangles& coverage)
 {
     static glm::mat4 const identity(1);
     static Rectangle const empty{};
@@ -41,24 +87,32 @@ bool renderable_is_occluded(
         return false;  // Weirdly transformed. Assume never occluded.
 
     auto const& window = renderable.screen_position();
-    auto const& clipped_window = window.intersection_with(area);
+    auto clipped_window = window.intersection_with(area);
+    if (auto const& clip = renderable.clip_area())
+        clipped_window = clipped_window.intersection_with(clip.value());
 
     if (clipped_window == empty)
         return true;  // Not in the area; definitely occluded.
 
-    bool occluded = false;
-    for (auto const& r : coverage)
+    bool const occluded = is_covered(clipped_window, coverage, coverage.begin());
+
+    if (!occluded && renderable.alpha() == 1.0f)
     {
-        if (r.contains(clipped_window))
+        if (!renderable.shaped())
         {
-            occluded = true;
-            break;
+            coverage.add(clipped_window);
+        }
+        else
+        {
+            for (auto const& opaque : renderable.opaque_region())
+            {
+                auto const clipped_opaque = opaque.intersection_with(clipped_window);
+                if (clipped_opaque != empty)
+                    coverage.add(clipped_opaque);
+            }
         }
     }
 
-    if (!occluded && renderable.alpha() == 1.0f && !renderable.shaped())
-        coverage.push_back(clipped_window);
-
     return occluded;
 }
 }
@@ -68,7 +122,7 @@ SceneElementSequence mir::compositor::filter_occlusions_from(
     Rectangle const& area)
 {
     SceneElementSequence occluded;
-    std::vector<Rectangle> coverage;
+    Rectangles coverage;
 
     auto it = elements.rbegin();
     while (it != elements.rend())
@@ -22,6 +22,7 @@
 #include "dropping_schedule.h"
 #include "mir/graphics/buffer.h"
 #include <boost/throw_exception.hpp>
+#include <algorithm>
 
 namespace mc = mir::compositor;
 namespace geom = mir::geometry;
@@ -29,6 +30,12 @@ namespace mg = mir::graphics;
 namespace ms = mir::scene;
 namespace geom = mir::geometry;
 
+namespace
+{
+// Enough to cover a client rendering several times faster than the slowest output
+auto const max_damage_history = 16u;
+}
+
 enum class mc::Stream::ScheduleMode {
     Queueing,
     Dropping
@@ -49,12 +56,36 @@ mc::Stream::Stream(
 mc::Stream::~Stream() = default;
 
 void mc::Stream::submit_buffer(std::shared_ptr<mg::Buffer> const& buffer)
+{
+    submit(buffer, std::experimental::nullopt);
+}
+
+void mc::Stream::submit_buffer(std::shared_ptr<mg::Buffer> const& buffer, geom::Rectangles const& damage)
+{
+    submit(buffer, damage);
+}
+
+void mc::Stream::submit(
+    std::shared_ptr<mg::Buffer> const& buffer,
+    std::experimental::optional<geom::Rectangles> const& damage)
 {
     if (!buffer)
         BOOST_THROW_EXCEPTION(std::invalid_argument("cannot submit null buffer"));
 
     {
         std::lock_guard<decltype(mutex)> lk(mutex);
+        if (latest_buffer_size != buffer->size())
+        {
+            // The previous contents can't be reused at a different size
+            damage_history.push_back({buffer->id(), std::experimental::nullopt});
+        }
+        else
+        {
+            damage_history.push_back({buffer->id(), damage});
+        }
+        if (damage_history.size() > max_damage_history)
+            damage_history.pop_front();
+
         first_frame_posted = true;
         pf = buffer->pixel_format();
         latest_buffer_size = buffer->size();
@@ -165,3 +196,30 @@ void mc::Stream::set_scale(float scale)
     std::lock_guard<decltype(mutex)> lk(mutex);
     scale_ = scale;
 }
+
+auto mc::Stream::buffer_damage(mg::BufferID since, mg::BufferID until) const
+    -> std::experimental::optional<geom::Rectangles>
+{
+    std::lock_guard<decltype(mutex)> lk(mutex);
+
+    auto const is = [](mg::BufferID id) { return [id](SubmittedDamage const& entry) { return entry.id == id; }; };
+
+    auto const first = std::find_if(damage_history.begin(), damage_history.end(), is(since));
+    if (first == damage_history.end())
+        return std::experimental::nullopt;
+
+    auto const last = std::find_if(first, damage_history.end(), is(until));
+    if (last == damage_history.end())
+        return std::experimental::nullopt;
+
+    geom::Rectangles result;
+    for (auto entry = std::next(first); entry != std::next(last); ++entry)
+    {
+        if (!entry->damage)
+            return std::experimental::nullopt;
+
+        for (auto const& rect : entry->damage.value())
+            result.add(rect);
+    }
+    return result;
+}
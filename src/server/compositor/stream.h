@@ -29,6 +29,7 @@
 #include <mutex>
 #include <memory>
 #include <set>
+#include <deque>
 
 namespace mir
 {
@@ -43,6 +44,9 @@ public:
     ~Stream();
 
     void submit_buffer(std::shared_ptr<graphics::Buffer> const& buffer) override;
+    void submit_buffer(
+        std::shared_ptr<graphics::Buffer> const& buffer,
+        geometry::Rectangles const& damage) override;
     void with_most_recent_buffer_do(std::function<void(graphics::Buffer&)> const& exec) override;
     MirPixelFormat pixel_format() const override;
     void set_frame_posted_callback(
@@ -56,10 +60,21 @@ public:
     void drop_old_buffers() override;
     bool has_submitted_buffer() const override;
     void set_scale(float scale) override;
+    auto buffer_damage(graphics::BufferID since, graphics::BufferID until) const
+        -> std::experimental::optional<geometry::Rectangles> override;
 
 private:
     enum class ScheduleMode;
     void transition_schedule(std::shared_ptr<Schedule>&& new_schedule, std::lock_guard<std::mutex> const&);
+    void submit(
+        std::shared_ptr<graphics::Buffer> const& buffer,
+        std::experimental::optional<geometry::Rectangles> const& damage);
+
+    struct SubmittedDamage
+    {
+        graphics::BufferID id;
+        std::experimental::optional<geometry::Rectangles> damage; ///< relative to the previous submission
+    };
 
     std::mutex mutable mutex;
     ScheduleMode schedule_mode;
@@ -69,6 +84,7 @@ private:
     float scale_{1.0f};
     MirPixelFormat pf;
     bool first_frame_posted;
+    std::deque<SubmittedDamage> damage_history; ///< oldest first
 
     std::mutex callback_mutex;
     std::function<void(geometry::Size const&)> frame_callback;
@@ -28,6 +28,7 @@
 #include "mir/frontend/wayland.h"
 
 #include "mir/logging/dumb_console_logger.h"
+#include "mir/logging/async_console_logger.h"
 #include "mir/options/program_option.h"
 #include "mir/frontend/session_credentials.h"
 #include "mir/frontend/session_authorizer.h"
@@ -47,6 +48,7 @@
 #include "mir/console_services.h"
 
 #include <type_traits>
+#include <cstdlib>
 
 namespace mc = mir::compositor;
 namespace geom = mir::geometry;
@@ -228,6 +230,10 @@ auto mir::DefaultServerConfiguration::the_logger()
     return logger(
         []() -> std::shared_ptr<ml::Logger>
         {
+            // Keeps formatting and console output off the compositor and input threads
+            if (getenv("MIR_ASYNC_LOGGING"))
+                return std::make_shared<ml::AsyncConsoleLogger>();
+
             return std::make_shared<ml::DumbConsoleLogger>();
         });
 }
@@ -20,29 +20,68 @@
 #include "mir/frontend/client_constants.h"
 #include "mir/variable_length_array.h"
 #include "mir/fd_socket_transmission.h"
+#include "mir/log.h"
 #include "mir/raii.h"
 
 #include <boost/throw_exception.hpp>
 
 #include <errno.h>
+#include <poll.h>
 #include <string.h>
+#include <sys/socket.h>
 
+#include <algorithm>
 #include <stdexcept>
+#include <system_error>
 
 namespace mf = mir::frontend;
 namespace mfd = mf::detail;
 namespace bs = boost::system;
 namespace ba = boost::asio;
 
-mfd::SocketMessenger::SocketMessenger(std::shared_ptr<ba::local::stream_protocol::socket> const& socket)
+namespace
+{
+/// Returns how much was written (0 if the socket is full) or -1 on error
+auto write_some(int socket_fd, iovec* iov, size_t iovcnt) -> ssize_t
+{
+    msghdr header{};
+    header.msg_iov = iov;
+    header.msg_iovlen = iovcnt;
+
+    for (;;)
+    {
+        auto const result = sendmsg(socket_fd, &header, MSG_DONTWAIT | MSG_NOSIGNAL);
+
+        if (result >= 0)
+            return result;
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return 0;
+        if (!mir::socket_error_is_transient(errno))
+            return -1;
+    }
+}
+
+/// mir::send_fds() writes a byte of its own, so only call it when there is room
+auto can_write(int socket_fd) -> bool
+{
+    pollfd pfd{socket_fd, POLLOUT, 0};
+    return poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLOUT);
+}
+}
+
+size_t const mfd::SocketMessenger::default_max_outbound_bytes{4 * 1024 * 1024};
+
+mfd::SocketMessenger::SocketMessenger(
+    std::shared_ptr<ba::local::stream_protocol::socket> const& socket,
+    size_t max_outbound_bytes)
     : socket(socket),
-      socket_fd{IntOwnedFd{socket->native_handle()}}
+      socket_fd{IntOwnedFd{socket->native_handle()}},
+      max_outbound_bytes{max_outbound_bytes}
 {
     // Make the socket non-blocking to avoid hanging the server when a client
     // is unresponsive. Also increase the send buffer size to 64KiB to allow
     // more leeway for transient client freezes.
     // See https://bugs.launchpad.net/mir/+bug/1350207
-    // TODO: Rework the messenger to support asynchronous sends
     socket->non_blocking(true);
     boost::asio::socket_base::send_buffer_size option(64*1024);
     socket->set_option(option);
@@ -80,17 +119,159 @@ void mfd::SocketMessenger::send(char const* data, size_t length, FdSets const& f
     whole_message.data()[1] = static_cast<unsigned char>((length >> 0) & 0xff);
     std::copy(data, data + length, whole_message.data() + header_size);
 
-    std::unique_lock<std::mutex> lg(message_lock);
+    std::lock_guard<std::mutex> lock(message_lock);
+
+    if (disconnected)
+        BOOST_THROW_EXCEPTION(std::runtime_error("Client has been disconnected"));
+
+    // Messages (and their fds) must reach the client in the order they were sent,
+    // which mf::SessionMediator relies on. So only write directly if nothing is queued.
+    size_t written{0};
+    if (outbound.empty())
+    {
+        iovec iov{whole_message.data(), whole_message.size()};
+        auto const result = write_some(socket_fd, &iov, 1);
+        if (result < 0)
+        {
+            auto const error = errno;
+            disconnect(lock);
+            BOOST_THROW_EXCEPTION(std::system_error(error, std::system_category(), "Failed to send message"));
+        }
+
+        written = result;
+        if (written == whole_message.size() && (fd_set.empty() || can_write(socket_fd)))
+        {
+            for (auto const& fds : fd_set)
+                mir::send_fds(socket_fd, fds);
+            return;
+        }
+    }
+
+    auto const remaining = whole_message.size() - written;
+    if (outbound_bytes + remaining > max_outbound_bytes)
+    {
+        mir::log_warning("Disconnecting client that has stopped reading its messages");
+        disconnect(lock);
+        BOOST_THROW_EXCEPTION(std::runtime_error("Client has stopped reading its messages"));
+    }
+
+    outbound.push_back({{whole_message.data() + written, whole_message.data() + whole_message.size()}, 0, fd_set});
+    outbound_bytes += remaining;
 
-    // TODO: This should be asynchronous, but we are not making sure
-    // that a potential call to send_fds is executed _after_ this
-    // function has completed (if it would be executed asynchronously.
-    // NOTE: we rely on this synchronous behavior as per the comment in
-    // mf::SessionMediator::create_surface
-    ba::write(*socket, ba::buffer(whole_message.data(), whole_message.size()));
+    await_writable(lock);
+}
+
+void mfd::SocketMessenger::flush(std::lock_guard<std::mutex> const& lock)
+{
+    static size_t const max_gather{64};
+
+    while (!outbound.empty())
+    {
+        // Write as many queued messages as possible in one go, stopping at
+        // any that has fds to follow it
+        iovec iov[max_gather];
+        size_t count{0};
+        size_t gathered{0};
+        for (auto& message : outbound)
+        {
+            if (count == max_gather)
+                break;
+
+            if (auto const unwritten = message.data.size() - message.written)
+            {
+                iov[count++] = {message.data.data() + message.written, unwritten};
+                gathered += unwritten;
+            }
+
+            if (!message.fds.empty())
+                break;
+        }
+
+        if (count > 0)
+        {
+            auto const result = write_some(socket_fd, iov, count);
+            if (result < 0)
+            {
+                disconnect(lock);
+                return;
+            }
+
+            outbound_bytes -= result;
+            for (auto remaining = static_cast<size_t>(result); remaining > 0;)
+            {
+                auto& message = *std::find_if(outbound.begin(), outbound.end(),
+                    [](auto const& message) { return message.written < message.data.size(); });
+                auto const advance = std::min(remaining, message.data.size() - message.written);
+                message.written += advance;
+                remaining -= advance;
+            }
+
+            if (static_cast<size_t>(result) < gathered)
+            {
+                await_writable(lock);
+                return;
+            }
+        }
+
+        while (!outbound.empty() && outbound.front().written == outbound.front().data.size())
+        {
+            if (auto const& fd_set = outbound.front().fds; !fd_set.empty())
+            {
+                if (!can_write(socket_fd))
+                {
+                    await_writable(lock);
+                    return;
+                }
+
+                try
+                {
+                    for (auto const& fds : fd_set)
+                        mir::send_fds(socket_fd, fds);
+                }
+                catch (std::exception const&)
+                {
+                    disconnect(lock);
+                    return;
+                }
+            }
+
+            outbound.pop_front();
+        }
+    }
+}
+
+void mfd::SocketMessenger::await_writable(std::lock_guard<std::mutex> const&)
+{
+    if (awaiting_writable)
+        return;
+
+    awaiting_writable = true;
+    socket->async_write_some(
+        ba::null_buffers(),
+        [weak_self = weak_from_this()](bs::error_code const& error, size_t)
+        {
+            if (auto const self = weak_self.lock())
+            {
+                std::lock_guard<std::mutex> lock(self->message_lock);
+                self->awaiting_writable = false;
+
+                if (error)
+                    self->disconnect(lock);
+                else
+                    self->flush(lock);
+            }
+        });
+}
+
+void mfd::SocketMessenger::disconnect(std::lock_guard<std::mutex> const&)
+{
+    disconnected = true;
+    outbound.clear();
+    outbound_bytes = 0;
 
-    for (auto const& fds : fd_set)
-        mir::send_fds(socket_fd, fds);
+    // The pending read sees the connection close, which tears down the session
+    bs::error_code ignored;
+    socket->shutdown(ba::local::stream_protocol::socket::shutdown_both, ignored);
 }
 
 void mfd::SocketMessenger::async_receive_msg(
@@ -21,7 +21,11 @@
 #include "message_sender.h"
 #include "message_receiver.h"
 #include "mir/frontend/session_credentials.h"
+
+#include <deque>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 namespace mir
 {
@@ -30,11 +34,20 @@ namespace frontend
 namespace detail
 {
 class SocketMessenger : public MessageSender,
-                        public MessageReceiver
+                        public MessageReceiver,
+                        public std::enable_shared_from_this<SocketMessenger>
 {
 public:
-    SocketMessenger(std::shared_ptr<boost::asio::local::stream_protocol::socket> const& socket);
+    /// The most a client may leave unread before it is considered unresponsive
+    static size_t const default_max_outbound_bytes;
+
+    SocketMessenger(
+        std::shared_ptr<boost::asio::local::stream_protocol::socket> const& socket,
+        size_t max_outbound_bytes = default_max_outbound_bytes);
 
+    /// Never blocks: whatever the socket won't accept yet is queued and sent, in
+    /// order, when the client catches up. If the client falls more than
+    /// max_outbound_bytes behind it is disconnected.
     void send(char const* data, size_t length, FdSets const& fds) override;
 
     void async_receive_msg(MirReadHandler const& handler, boost::asio::mutable_buffers_1 const& buffer) override;
@@ -48,10 +61,28 @@ private:
     void update_session_creds();
     SessionCredentials creator_creds() const;
 
+    /// A message the socket hasn't (fully) accepted yet
+    struct Outbound
+    {
+        std::vector<char> data;
+        size_t written;
+        FdSets fds;
+    };
+
+    /// Writes as much of the outbound queue as the socket will take without blocking
+    void flush(std::lock_guard<std::mutex> const&);
+    void await_writable(std::lock_guard<std::mutex> const&);
+    void disconnect(std::lock_guard<std::mutex> const&);
+
     std::shared_ptr<boost::asio::local::stream_protocol::socket> socket;
     mir::Fd socket_fd;
+    size_t const max_outbound_bytes;
 
     std::mutex message_lock;
+    std::deque<Outbound> outbound;
+    size_t outbound_bytes{0};
+    bool awaiting_writable{false};
+    bool disconnected{false};
     SessionCredentials session_creds{0, 0, 0};
 };
 }
@@ -0,0 +1,155 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "input_latency_tracker.h"
+
+#include "wayland_frontend.tp.h"
+
+#include "mir/graphics/frame.h"
+#include "mir/log.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+namespace mf = mir::frontend;
+namespace mg = mir::graphics;
+
+using namespace std::chrono;
+
+void mf::InputLatencyHistogram::record(nanoseconds latency)
+{
+    auto const bucket = std::min<std::size_t>(
+        std::max<int64_t>(duration_cast<milliseconds>(latency).count(), 0),
+        bucket_count - 1);
+
+    ++buckets[bucket];
+    ++total;
+    longest = std::max(longest, latency);
+}
+
+auto mf::InputLatencyHistogram::percentile(unsigned int p) const -> milliseconds
+{
+    // The rank of the sample at the given percentile, rounded up
+    auto const rank = std::max<uint64_t>((total * std::min(p, 100u) + 99) / 100, 1);
+
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i != bucket_count; ++i)
+    {
+        seen += buckets[i];
+        if (seen >= rank)
+        {
+            return milliseconds{i + 1};
+        }
+    }
+
+    return milliseconds{0};
+}
+
+auto mf::InputLatencyHistogram::summary() const -> std::string
+{
+    std::ostringstream out;
+    out << "input to photon latency over " << total << " responses:"
+        << " p50 " << percentile_label(50)
+        << " p90 " << percentile_label(90)
+        << " p99 " << percentile_label(99)
+        << " max " << std::fixed << std::setprecision(1)
+        << duration_cast<duration<double, std::milli>>(longest).count() << "ms";
+    return out.str();
+}
+
+auto mf::InputLatencyHistogram::percentile_label(unsigned int p) const -> std::string
+{
+    auto const bound = percentile(p).count();
+
+    // The last bucket has no upper bound
+    if (bound >= static_cast<milliseconds::rep>(bucket_count))
+    {
+        return "≥" + std::to_string(bucket_count - 1) + "ms";
+    }
+
+    return "<" + std::to_string(bound) + "ms";
+}
+
+void mf::InputLatencyHistogram::reset()
+{
+    buckets.fill(0);
+    total = 0;
+    longest = nanoseconds{0};
+}
+
+auto mf::InputLatencyTracker::enabled() -> bool
+{
+    static bool const trace{getenv("MIR_WAYLAND_TRACE_INPUT_LATENCY") != nullptr};
+    return trace;
+}
+
+mf::InputLatencyTracker::InputLatencyTracker(steady_clock::duration summary_interval)
+    : summary_interval{summary_interval},
+      last_summary{steady_clock::now()}
+{
+}
+
+void mf::InputLatencyTracker::response_consumed(
+    std::thread::id compositor,
+    std::shared_ptr<Response> const& response)
+{
+    if (!response->presented)
+    {
+        responses.content_consumed(compositor, response);
+    }
+}
+
+void mf::InputLatencyTracker::frame_posted(unsigned int output_id, std::thread::id compositor)
+{
+    responses.frame_posted(output_id, compositor);
+}
+
+void mf::InputLatencyTracker::frame_presented(unsigned int output_id, mg::Frame const& frame)
+{
+    auto const shown = responses.frame_presented(output_id);
+    if (!shown.empty())
+    {
+        // Input event times are CLOCK_MONOTONIC. Use the vblank time if the platform reports it in the same domain.
+        auto const presented = frame.ust.clock_id == CLOCK_MONOTONIC ?
+            frame.ust.nanoseconds :
+            mir::time::PosixTimestamp::now(CLOCK_MONOTONIC).nanoseconds;
+
+        for (auto const& response : shown)
+        {
+            // A response shown on several outputs is measured to whichever flips first
+            if (response->presented)
+                continue;
+
+            response->presented = true;
+            auto const latency = presented - response->input_time;
+            tracepoint(mir_server_wayland, input_to_photon_latency, response->client, latency.count());
+            histogram.record(latency);
+        }
+    }
+
+    auto const now = steady_clock::now();
+    if (now - last_summary >= summary_interval)
+    {
+        if (histogram.count())
+        {
+            mir::log_info("%s", histogram.summary().c_str());
+        }
+        histogram.reset();
+        last_summary = now;
+    }
+}
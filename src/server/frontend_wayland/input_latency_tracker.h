@@ -0,0 +1,100 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_FRONTEND_INPUT_LATENCY_TRACKER_H
+#define MIR_FRONTEND_INPUT_LATENCY_TRACKER_H
+
+#include "presented_content_tracker.h"
+
+#include "mir/graphics/presentation_observer.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+struct wl_client;
+
+namespace mir
+{
+namespace frontend
+{
+/// Accumulates input-to-photon latencies in 1ms buckets
+class InputLatencyHistogram
+{
+public:
+    void record(std::chrono::nanoseconds latency);
+
+    auto count() const -> uint64_t { return total; }
+
+    /// Upper bound of the bucket containing the given percentile (0-100) of recorded latencies
+    auto percentile(unsigned int p) const -> std::chrono::milliseconds;
+
+    auto max() const -> std::chrono::nanoseconds { return longest; }
+
+    /// A one-line summary suitable for logging
+    auto summary() const -> std::string;
+
+    void reset();
+
+private:
+    /// "<Nms" for the bucket containing the given percentile, or "≥99ms" for the last bucket
+    auto percentile_label(unsigned int p) const -> std::string;
+
+    static std::size_t const bucket_count = 100;    ///< The last bucket also holds everything longer
+
+    std::array<uint64_t, bucket_count> buckets{};
+    uint64_t total{0};
+    std::chrono::nanoseconds longest{0};
+};
+
+/// Follows input events delivered to a client to the page flip that shows the client's next buffer.
+/// Enabled by MIR_WAYLAND_TRACE_INPUT_LATENCY; results are emitted as LTTng tracepoints and a periodic log summary.
+/// Should only be used from the Wayland thread (and registered as a PresentationObserver on the Wayland executor)
+class InputLatencyTracker : public graphics::PresentationObserver
+{
+public:
+    /// The buffer a client committed after input at input_time
+    struct Response
+    {
+        wl_client* client;
+        std::chrono::nanoseconds input_time;
+        bool presented{false};
+    };
+
+    static auto enabled() -> bool;
+
+    InputLatencyTracker(std::chrono::steady_clock::duration summary_interval = std::chrono::seconds{10});
+
+    /// The \a compositor thread has composited the response. Only its first presentation is measured, so this
+    /// can be called for each use of the buffer.
+    void response_consumed(std::thread::id compositor, std::shared_ptr<Response> const& response);
+
+    void frame_posted(unsigned int output_id, std::thread::id compositor) override;
+    void frame_presented(unsigned int output_id, graphics::Frame const& frame) override;
+
+private:
+    std::chrono::steady_clock::duration const summary_interval;
+    std::chrono::steady_clock::time_point last_summary;
+    PresentedContentTracker<std::shared_ptr<Response>> responses;
+    InputLatencyHistogram histogram;
+};
+}
+}
+
+#endif // MIR_FRONTEND_INPUT_LATENCY_TRACKER_H
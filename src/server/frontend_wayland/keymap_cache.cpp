@@ -0,0 +1,111 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keymap_cache.h"
+
+#include "mir/input/keymap.h"
+
+#include <xkbcommon/xkbcommon.h>
+#include <boost/throw_exception.hpp>
+
+#include <stdexcept>
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/memfd.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace mf = mir::frontend;
+namespace mi = mir::input;
+
+namespace
+{
+/// A memfd holding text that nobody (including us) can modify, or an invalid fd
+auto create_sealed_file(std::string const& text) -> mir::Fd
+{
+    auto const raw_fd = static_cast<int>(
+        syscall(SYS_memfd_create, "mir-keymap", MFD_CLOEXEC | MFD_ALLOW_SEALING));
+    if (raw_fd == -1)
+        return mir::Fd{};
+
+    mir::Fd fd{raw_fd};
+
+    for (size_t written = 0; written < text.size();)
+    {
+        auto const result = write(fd, text.data() + written, text.size() - written);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return mir::Fd{};
+        }
+        written += result;
+    }
+
+    // Sealing against writes is what makes it safe to hand the same file to every client
+    if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) == -1)
+        return mir::Fd{};
+
+    return fd;
+}
+}
+
+mf::KeymapCache::KeymapCache()
+    : context{xkb_context_new(XKB_CONTEXT_NO_FLAGS), &xkb_context_unref}
+{
+}
+
+mf::KeymapCache::~KeymapCache() = default;
+
+auto mf::KeymapCache::get(mi::Keymap const& keymap) -> std::shared_ptr<CompiledKeymap const>
+{
+    Key const key{keymap.model, keymap.layout, keymap.variant, keymap.options};
+
+    auto const cached = keymaps.find(key);
+    if (cached != keymaps.end())
+        return cached->second;
+
+    xkb_rule_names const names = {
+        "evdev",
+        keymap.model.c_str(),
+        keymap.layout.c_str(),
+        keymap.variant.c_str(),
+        keymap.options.c_str()
+    };
+    std::shared_ptr<xkb_keymap> const compiled{
+        xkb_keymap_new_from_names(
+            context.get(),
+            &names,
+            XKB_KEYMAP_COMPILE_NO_FLAGS),
+        &xkb_keymap_unref};
+
+    if (!compiled)
+    {
+        BOOST_THROW_EXCEPTION(std::runtime_error("Failed to compile keymap"));
+    }
+
+    std::unique_ptr<char, void(*)(void*)> buffer{
+        xkb_keymap_get_as_string(compiled.get(), XKB_KEYMAP_FORMAT_TEXT_V1),
+        free};
+    std::string text{buffer.get()};
+
+    auto const sealed_file = create_sealed_file(text);
+    auto const result = std::make_shared<CompiledKeymap const>(
+        CompiledKeymap{compiled, std::move(text), sealed_file});
+
+    keymaps.emplace(key, result);
+    return result;
+}
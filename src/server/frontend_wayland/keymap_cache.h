@@ -0,0 +1,72 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_FRONTEND_KEYMAP_CACHE_H
+#define MIR_FRONTEND_KEYMAP_CACHE_H
+
+#include "mir/fd.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+
+// from <xkbcommon/xkbcommon.h>
+struct xkb_keymap;
+struct xkb_context;
+
+namespace mir
+{
+namespace input
+{
+class Keymap;
+}
+
+namespace frontend
+{
+/**
+ * Compiles each distinct keymap once for all the Wayland keyboards of a seat.
+ *
+ * Only used on the Wayland thread.
+ */
+class KeymapCache
+{
+public:
+    struct CompiledKeymap
+    {
+        std::shared_ptr<xkb_keymap> const keymap;
+        /// The keymap as sent to clients (XKB_KEYMAP_FORMAT_TEXT_V1)
+        std::string const text;
+        /// A sealed, read-only memfd holding text that can be sent to every
+        /// client, or an invalid fd if the kernel does not support sealing
+        Fd const sealed_file;
+    };
+
+    KeymapCache();
+    ~KeymapCache();
+
+    auto get(input::Keymap const& keymap) -> std::shared_ptr<CompiledKeymap const>;
+
+private:
+    using Key = std::tuple<std::string, std::string, std::string, std::string>;
+
+    std::unique_ptr<xkb_context, void (*)(xkb_context *)> const context;
+    std::map<Key, std::shared_ptr<CompiledKeymap const>> keymaps;
+};
+}
+}
+
+#endif // MIR_FRONTEND_KEYMAP_CACHE_H
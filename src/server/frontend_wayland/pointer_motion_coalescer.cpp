@@ -0,0 +1,112 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pointer_motion_coalescer.h"
+
+#include "mir/events/event_builders.h"
+#include "mir/events/event_private.h"
+#include "mir_toolkit/mir_blob.h"
+
+#include <cstdlib>
+
+namespace mf = mir::frontend;
+namespace mev = mir::events;
+
+namespace
+{
+auto pure_motion(MirEvent const* event) -> MirPointerEvent const*
+{
+    if (mir_event_get_type(event) != mir_event_type_input)
+        return nullptr;
+
+    auto const input_event = mir_event_get_input_event(event);
+    if (mir_input_event_get_type(input_event) != mir_input_event_type_pointer ||
+        mir_input_event_has_cookie(input_event))
+        return nullptr;
+
+    auto const pointer_event = mir_input_event_get_pointer_event(input_event);
+    if (mir_pointer_event_action(pointer_event) != mir_pointer_action_motion ||
+        mir_pointer_event_axis_value(pointer_event, mir_pointer_axis_hscroll) != 0.0f ||
+        mir_pointer_event_axis_value(pointer_event, mir_pointer_axis_vscroll) != 0.0f)
+        return nullptr;
+
+    if (auto const handle = pointer_event->dnd_handle())
+    {
+        mir_blob_release(handle);
+        return nullptr;
+    }
+
+    return pointer_event;
+}
+
+auto can_merge(MirPointerEvent const* into, MirPointerEvent const* from) -> bool
+{
+    auto const into_input = mir_pointer_event_input_event(into);
+    auto const from_input = mir_pointer_event_input_event(from);
+
+    return mir_input_event_get_device_id(into_input) == mir_input_event_get_device_id(from_input) &&
+           mir_pointer_event_buttons(into) == mir_pointer_event_buttons(from) &&
+           mir_pointer_event_modifiers(into) == mir_pointer_event_modifiers(from);
+}
+}
+
+auto mf::PointerMotionCoalescer::enabled() -> bool
+{
+    static bool const coalesce{getenv("MIR_WAYLAND_COALESCE_POINTER_MOTION") != nullptr};
+    return coalesce;
+}
+
+auto mf::PointerMotionCoalescer::queue(std::shared_ptr<MirEvent const> const& event)
+    -> std::shared_ptr<MirEvent const>
+{
+    auto const motion = pure_motion(event.get());
+
+    std::lock_guard<std::mutex> lock{mutex};
+
+    if (!motion)
+    {
+        // Later motion must not jump ahead of this event
+        pending_motion.reset();
+        return event;
+    }
+
+    if (pending_motion)
+    {
+        auto const pending = pending_motion->to_input()->to_pointer();
+        if (can_merge(pending, motion))
+        {
+            pending->set_x(motion->x());
+            pending->set_y(motion->y());
+            pending->set_dx(pending->dx() + motion->dx());
+            pending->set_dy(pending->dy() + motion->dy());
+            pending_motion->to_input()->set_event_time(
+                std::chrono::nanoseconds{mir_input_event_get_event_time(mir_event_get_input_event(event.get()))});
+            return nullptr;
+        }
+    }
+
+    // The queued event may be modified by later motion, so it can't be shared
+    pending_motion = mev::clone_event(*event);
+    return pending_motion;
+}
+
+void mf::PointerMotionCoalescer::dequeue(std::shared_ptr<MirEvent const> const& event)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    if (pending_motion == event)
+        pending_motion.reset();
+}
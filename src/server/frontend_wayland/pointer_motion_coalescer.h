@@ -0,0 +1,59 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_FRONTEND_POINTER_MOTION_COALESCER_H_
+#define MIR_FRONTEND_POINTER_MOTION_COALESCER_H_
+
+#include "mir_toolkit/event.h"
+
+#include <memory>
+#include <mutex>
+
+namespace mir
+{
+namespace frontend
+{
+/// Merges pointer motion that is still waiting to be delivered to a client
+///
+/// Input arrives on the input thread and is queued for the Wayland thread. If a
+/// busy Wayland thread falls behind a high rate mouse, each queued motion would
+/// otherwise become its own wl_pointer.motion and frame. Instead, motion arriving
+/// while an earlier motion is still queued is folded into it: the position is
+/// replaced and the relative deltas are summed. Events are never delayed, and
+/// motion is never merged across button, axis or any other event.
+class PointerMotionCoalescer
+{
+public:
+    /// Whether coalescing has been enabled with MIR_WAYLAND_COALESCE_POINTER_MOTION
+    static auto enabled() -> bool;
+
+    /// Called for each event before it is queued for the Wayland thread
+    /// \returns the event to queue, or nullptr if it was merged into a queued event
+    auto queue(std::shared_ptr<MirEvent const> const& event) -> std::shared_ptr<MirEvent const>;
+
+    /// Called on the Wayland thread before delivering a queued event
+    /// After this no more motion will be merged into event.
+    void dequeue(std::shared_ptr<MirEvent const> const& event);
+
+private:
+    std::mutex mutex;
+    /// A queued motion event that later motion can still be merged into
+    std::shared_ptr<MirEvent> pending_motion;
+};
+}
+}
+
+#endif // MIR_FRONTEND_POINTER_MOTION_COALESCER_H_
@@ -0,0 +1,241 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "presentation_time.h"
+#include "wl_surface.h"
+#include "deleted_for_resource.h"
+
+#include "mir/executor.h"
+#include "mir/observer_registrar.h"
+
+#include <time.h>
+
+namespace mf = mir::frontend;
+namespace mg = mir::graphics;
+namespace mw = mir::wayland;
+
+namespace mir
+{
+namespace frontend
+{
+class WpPresentation : public wayland::Presentation
+{
+public:
+    WpPresentation(wl_resource* new_resource, std::shared_ptr<PresentationTracker> const& tracker);
+
+    class Global : public wayland::Presentation::Global
+    {
+    public:
+        Global(
+            wl_display* display,
+            std::shared_ptr<Executor> const& wayland_executor,
+            std::shared_ptr<ObserverRegistrar<graphics::PresentationObserver>> const& registrar);
+        ~Global();
+
+    private:
+        void bind(wl_resource* new_wp_presentation) override;
+
+        std::shared_ptr<Executor> const wayland_executor;
+        std::shared_ptr<ObserverRegistrar<graphics::PresentationObserver>> const registrar;
+        std::shared_ptr<PresentationTracker> const tracker;
+    };
+
+private:
+    void destroy() override;
+    void feedback(wl_resource* surface, wl_resource* callback) override;
+
+    std::shared_ptr<PresentationTracker> const tracker;
+};
+}
+}
+
+void mf::PresentationTracker::content_consumed(
+    std::thread::id compositor,
+    std::shared_ptr<WpPresentationFeedback> const& feedback)
+{
+    content.content_consumed(compositor, feedback);
+}
+
+void mf::PresentationTracker::frame_posted(unsigned int output_id, std::thread::id compositor)
+{
+    content.frame_posted(output_id, compositor);
+}
+
+void mf::PresentationTracker::frame_presented(unsigned int output_id, mg::Frame const& frame)
+{
+    // The refresh interval is only known when we have seen the previous vblank of the same output
+    uint32_t refresh_ns = 0;
+    auto const previous = last_frame.find(output_id);
+    if (previous != last_frame.end() &&
+        previous->second.ust.clock_id == frame.ust.clock_id &&
+        frame.msc == previous->second.msc + 1)
+    {
+        auto const interval = frame.ust.nanoseconds - previous->second.ust.nanoseconds;
+        if (interval > std::chrono::nanoseconds::zero() && interval < std::chrono::seconds{1})
+        {
+            refresh_ns = interval.count();
+        }
+    }
+    last_frame[output_id] = frame;
+
+    for (auto const& feedback : content.frame_presented(output_id))
+    {
+        feedback->send_presented(frame, refresh_ns);
+    }
+}
+
+mf::WpPresentationFeedback::WpPresentationFeedback(
+    wl_resource* new_resource,
+    std::shared_ptr<PresentationTracker> const& tracker)
+    : wayland::PresentationFeedback{new_resource, Version<1>()},
+      tracker{tracker},
+      destroyed{deleted_flag_for_resource(resource)}
+{
+}
+
+void mf::WpPresentationFeedback::content_consumed(std::thread::id compositor)
+{
+    if (resolved)
+        return;
+
+    consumed = true;
+    tracker->content_consumed(compositor, shared_from_this());
+}
+
+void mf::WpPresentationFeedback::content_discarded()
+{
+    if (consumed || resolved)
+        return;
+
+    resolved = true;
+    if (!*destroyed)
+    {
+        send_discarded_event();
+        destroy_wayland_object();
+    }
+}
+
+void mf::WpPresentationFeedback::send_presented(mg::Frame const& frame, uint32_t refresh_ns)
+{
+    // Content shown on several outputs is presented by whichever flips first
+    if (resolved)
+        return;
+
+    resolved = true;
+    if (*destroyed)
+        return;
+
+    uint32_t flags = Kind::vsync;
+    auto timestamp = frame.ust;
+    if (timestamp.clock_id == CLOCK_MONOTONIC)
+    {
+        // The platform reported the kernel's vblank timestamp
+        flags |= Kind::hw_clock | Kind::hw_completion;
+    }
+    else
+    {
+        // We advertise CLOCK_MONOTONIC, so the best we can do is when we heard about the flip
+        timestamp = mir::time::PosixTimestamp::now(CLOCK_MONOTONIC);
+    }
+
+    auto const nanoseconds = timestamp.nanoseconds.count();
+    uint64_t const tv_sec = nanoseconds / 1000000000;
+    uint32_t const tv_nsec = nanoseconds % 1000000000;
+    uint64_t const seq = frame.msc;
+
+    send_presented_event(
+        tv_sec >> 32, tv_sec & 0xffffffff,
+        tv_nsec,
+        refresh_ns,
+        seq >> 32, seq & 0xffffffff,
+        flags);
+    destroy_wayland_object();
+}
+
+mf::CommitPresentationFeedback::CommitPresentationFeedback(
+    std::vector<std::shared_ptr<WpPresentationFeedback>> const& feedbacks,
+    std::shared_ptr<Executor> const& executor)
+    : feedbacks{feedbacks},
+      executor{executor}
+{
+}
+
+mf::CommitPresentationFeedback::~CommitPresentationFeedback()
+{
+    executor->spawn([feedbacks = feedbacks]()
+        {
+            for (auto const& feedback : feedbacks)
+            {
+                feedback->content_discarded();
+            }
+        });
+}
+
+void mf::CommitPresentationFeedback::buffer_consumed(std::thread::id compositor)
+{
+    for (auto const& feedback : feedbacks)
+    {
+        feedback->content_consumed(compositor);
+    }
+}
+
+mf::WpPresentation::WpPresentation(wl_resource* new_resource, std::shared_ptr<PresentationTracker> const& tracker)
+    : wayland::Presentation{new_resource, Version<1>()},
+      tracker{tracker}
+{
+    send_clock_id_event(CLOCK_MONOTONIC);
+}
+
+void mf::WpPresentation::destroy()
+{
+    destroy_wayland_object();
+}
+
+void mf::WpPresentation::feedback(wl_resource* surface, wl_resource* callback)
+{
+    WlSurface::from(surface)->add_presentation_feedback(
+        std::make_shared<WpPresentationFeedback>(callback, tracker));
+}
+
+mf::WpPresentation::Global::Global(
+    wl_display* display,
+    std::shared_ptr<Executor> const& wayland_executor,
+    std::shared_ptr<ObserverRegistrar<mg::PresentationObserver>> const& registrar)
+    : wayland::Presentation::Global{display, Version<1>()},
+      wayland_executor{wayland_executor},
+      registrar{registrar},
+      tracker{std::make_shared<PresentationTracker>()}
+{
+    registrar->register_interest(tracker, *wayland_executor);
+}
+
+mf::WpPresentation::Global::~Global()
+{
+    registrar->unregister_interest(*tracker);
+}
+
+void mf::WpPresentation::Global::bind(wl_resource* new_wp_presentation)
+{
+    new WpPresentation{new_wp_presentation, tracker};
+}
+
+auto mf::create_wp_presentation(
+    wl_display* display,
+    std::shared_ptr<Executor> const& wayland_executor,
+    std::shared_ptr<ObserverRegistrar<mg::PresentationObserver>> const& registrar) -> std::shared_ptr<void>
+{
+    return std::make_shared<WpPresentation::Global>(display, wayland_executor, registrar);
+}
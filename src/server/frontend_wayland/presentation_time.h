@@ -0,0 +1,112 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_FRONTEND_PRESENTATION_TIME_H
+#define MIR_FRONTEND_PRESENTATION_TIME_H
+
+#include "presentation-time_wrapper.h"
+#include "presented_content_tracker.h"
+
+#include "mir/graphics/frame.h"
+#include "mir/graphics/presentation_observer.h"
+
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct wl_display;
+
+namespace mir
+{
+class Executor;
+template<class Observer>
+class ObserverRegistrar;
+
+namespace frontend
+{
+class WpPresentationFeedback;
+
+/// Holds consumed feedback until the page flip that presents it. Only accessed on the Wayland thread: observer
+/// notifications are delivered on the Wayland executor.
+class PresentationTracker : public graphics::PresentationObserver
+{
+public:
+    /// The \a compositor thread has consumed the content \a feedback is for
+    void content_consumed(std::thread::id compositor, std::shared_ptr<WpPresentationFeedback> const& feedback);
+
+    void frame_posted(unsigned int output_id, std::thread::id compositor) override;
+    void frame_presented(unsigned int output_id, graphics::Frame const& frame) override;
+
+private:
+    PresentedContentTracker<std::shared_ptr<WpPresentationFeedback>> content;
+    std::unordered_map<unsigned int, graphics::Frame> last_frame;
+};
+
+/// Reports the outcome of a single wl_surface.commit to the client
+class WpPresentationFeedback
+    : public wayland::PresentationFeedback,
+      public std::enable_shared_from_this<WpPresentationFeedback>
+{
+public:
+    WpPresentationFeedback(wl_resource* new_resource, std::shared_ptr<PresentationTracker> const& tracker);
+
+    /// The \a compositor thread has composited the committed content; it is presented by the next page flip of
+    /// an output that thread posts it to
+    void content_consumed(std::thread::id compositor);
+
+    /// The committed content will never reach the screen. Ignored once the content has been consumed.
+    void content_discarded();
+
+    /// Sends the presented event for the given page flip and destroys this feedback
+    void send_presented(graphics::Frame const& frame, uint32_t refresh_ns);
+
+private:
+    std::shared_ptr<PresentationTracker> const tracker;
+    std::shared_ptr<bool> const destroyed;
+    bool consumed{false};
+    bool resolved{false};
+};
+
+/// The presentation feedback requested for a commit with a new buffer. It is presented once the compositor has
+/// consumed the buffer and posted it to an output, or discarded if the buffer is released without being consumed
+/// (e.g. it was superseded).
+class CommitPresentationFeedback
+{
+public:
+    CommitPresentationFeedback(
+        std::vector<std::shared_ptr<WpPresentationFeedback>> const& feedbacks,
+        std::shared_ptr<Executor> const& executor);
+
+    /// The buffer can be released on any thread
+    ~CommitPresentationFeedback();
+
+    /// Must be called on the Wayland thread, for each time the \a compositor thread consumes the buffer
+    void buffer_consumed(std::thread::id compositor);
+
+private:
+    std::vector<std::shared_ptr<WpPresentationFeedback>> const feedbacks;
+    std::shared_ptr<Executor> const executor;
+};
+
+auto create_wp_presentation(
+    wl_display* display,
+    std::shared_ptr<Executor> const& wayland_executor,
+    std::shared_ptr<ObserverRegistrar<graphics::PresentationObserver>> const& registrar) -> std::shared_ptr<void>;
+}
+}
+
+#endif // MIR_FRONTEND_PRESENTATION_TIME_H
@@ -0,0 +1,91 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_FRONTEND_PRESENTED_CONTENT_TRACKER_H
+#define MIR_FRONTEND_PRESENTED_CONTENT_TRACKER_H
+
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace mir
+{
+namespace frontend
+{
+/**
+ * Follows content from the compositor thread that consumed it to the page flip that puts it on screen
+ *
+ * Content consumed by a compositor thread is part of the next frame that thread posts, and is on screen from the
+ * next flip of an output that frame was posted to. Consumption must be reported before the post it is part of,
+ * which must be reported before its flip; reporting everything through the Wayland executor keeps that order.
+ *
+ * The same content can be presented more than once: by each output its frame went to, and again if the thread
+ * posts without consuming anything new. Only the first presentation counts.
+ */
+template<typename Content>
+class PresentedContentTracker
+{
+public:
+    void content_consumed(std::thread::id compositor, Content const& content)
+    {
+        auto& frame = frames[compositor];
+        if (frame.posted)
+        {
+            frame = Frame{};
+        }
+        frame.content.push_back(content);
+    }
+
+    void frame_posted(unsigned int output_id, std::thread::id compositor)
+    {
+        auto const frame = frames.find(compositor);
+        if (frame == frames.end())
+        {
+            return;
+        }
+
+        frame->second.posted = true;
+        auto& awaiting = awaiting_flip[output_id];
+        awaiting.insert(awaiting.end(), frame->second.content.begin(), frame->second.content.end());
+    }
+
+    /// The content put on screen by this flip of the output
+    auto frame_presented(unsigned int output_id) -> std::vector<Content>
+    {
+        std::vector<Content> presented;
+        auto const awaiting = awaiting_flip.find(output_id);
+        if (awaiting != awaiting_flip.end())
+        {
+            presented = std::move(awaiting->second);
+            awaiting_flip.erase(awaiting);
+        }
+        return presented;
+    }
+
+private:
+    struct Frame
+    {
+        std::vector<Content> content;
+        bool posted{false};
+    };
+
+    std::unordered_map<std::thread::id, Frame> frames;  ///< The latest frame of each compositor thread
+    std::unordered_map<unsigned int, std::vector<Content>> awaiting_flip;
+};
+}
+}
+
+#endif // MIR_FRONTEND_PRESENTED_CONTENT_TRACKER_H
@@ -30,6 +30,7 @@
 
 #include "output_manager.h"
 #include "wayland_executor.h"
+#include "input_latency_tracker.h"
 
 #include "wayland_wrapper.h"
 
@@ -57,6 +58,7 @@
 #include "mir/input/mir_keyboard_config.h"
 #include "mir/input/input_device_hub.h"
 #include "mir/input/input_device_observer.h"
+#include "mir/observer_registrar.h"
 
 #include <system_error>
 #include <sys/eventfd.h>
@@ -105,10 +107,12 @@ public:
     WlCompositor(
         struct wl_display* display,
         std::shared_ptr<mir::Executor> const& executor,
-        std::shared_ptr<mg::GraphicBufferAllocator> const& allocator)
+        std::shared_ptr<mg::GraphicBufferAllocator> const& allocator,
+        std::shared_ptr<InputLatencyTracker> const& input_latency)
         : Global(display, Version<4>()),
           allocator{allocator},
-          executor{executor}
+          executor{executor},
+          input_latency{input_latency}
     {
     }
 
@@ -117,6 +121,7 @@ public:
 private:
     std::shared_ptr<mg::GraphicBufferAllocator> const allocator;
     std::shared_ptr<mir::Executor> const executor;
+    std::shared_ptr<InputLatencyTracker> const input_latency;
     std::map<std::pair<wl_client*, uint32_t>, std::vector<std::function<void(WlSurface*)>>> surface_callbacks;
 
     class Instance : wayland::Compositor
@@ -156,7 +161,11 @@ void WlCompositor::on_surface_created(wl_client* client, uint32_t id, std::funct
 
 void WlCompositor::Instance::create_surface(wl_resource* new_surface)
 {
-    auto const surface = new WlSurface{new_surface, compositor->executor, compositor->allocator};
+    auto const surface = new WlSurface{
+        new_surface,
+        compositor->executor,
+        compositor->allocator,
+        compositor->input_latency};
     auto const key = std::make_pair(wl_resource_get_client(new_surface), wl_resource_get_id(new_surface));
     auto const callbacks = compositor->surface_callbacks.find(key);
     if (callbacks != compositor->surface_callbacks.end())
@@ -493,6 +502,7 @@ mf::WaylandConnector::WaylandConnector(
     std::shared_ptr<mf::SessionAuthorizer> const& session_authorizer,
     std::shared_ptr<SurfaceStack> const& surface_stack,
     std::shared_ptr<ms::Clipboard> const& clipboard,
+    std::shared_ptr<ObserverRegistrar<mg::PresentationObserver>> const& presentation_observer_registrar,
     bool arw_socket,
     std::unique_ptr<WaylandExtensions> extensions_,
     WaylandProtocolExtensionFilter const& extension_filter)
@@ -501,6 +511,7 @@ mf::WaylandConnector::WaylandConnector(
       executor{std::make_shared<WaylandExecutor>(wl_display_get_event_loop(display.get()))},
       allocator{allocator_for_display(allocator, display.get(), executor)},
       shell{shell},
+      presentation_observer_registrar{presentation_observer_registrar},
       extensions{std::move(extensions_)},
       extension_filter{extension_filter}
 {
@@ -539,10 +550,17 @@ mf::WaylandConnector::WaylandConnector(
      * So far I've only found ones which expect wl_compositor before anything else,
      * so stick that first.
      */
+    if (InputLatencyTracker::enabled())
+    {
+        input_latency = std::make_shared<InputLatencyTracker>();
+        presentation_observer_registrar->register_interest(input_latency, *executor);
+    }
+
     compositor_global = std::make_unique<mf::WlCompositor>(
         display.get(),
         executor,
-        this->allocator);
+        this->allocator,
+        input_latency);
     subcompositor_global = std::make_unique<mf::WlSubcompositor>(display.get());
     seat_global = std::make_unique<mf::WlSeat>(display.get(), input_hub, seat);
     output_manager = std::make_unique<mf::OutputManager>(
@@ -559,7 +577,8 @@ mf::WaylandConnector::WaylandConnector(
         clipboard,
         seat_global.get(),
         output_manager.get(),
-        surface_stack});
+        surface_stack,
+        presentation_observer_registrar});
 
     wl_display_init_shm(display.get());
 
@@ -630,6 +649,11 @@ mf::WaylandConnector::~WaylandConnector()
         stop();
     }
     wl_event_source_remove(pause_source);
+
+    if (input_latency)
+    {
+        presentation_observer_registrar->unregister_interest(*input_latency);
+    }
 }
 
 void mf::WaylandConnector::start()
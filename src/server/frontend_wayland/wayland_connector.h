@@ -32,6 +32,8 @@
 namespace mir
 {
 class Executor;
+template<class Observer>
+class ObserverRegistrar;
 
 namespace input
 {
@@ -41,6 +43,7 @@ class Seat;
 namespace graphics
 {
 class GraphicBufferAllocator;
+class PresentationObserver;
 }
 namespace geometry
 {
@@ -66,6 +69,7 @@ class SessionAuthorizer;
 class WlDataDeviceManager;
 class WlSurface;
 class SurfaceStack;
+class InputLatencyTracker;
 
 class WaylandExtensions
 {
@@ -80,6 +84,7 @@ public:
         WlSeat* seat;
         OutputManager* output_manager;
         std::shared_ptr<SurfaceStack> surface_stack;
+        std::shared_ptr<ObserverRegistrar<graphics::PresentationObserver>> presentation_observer_registrar;
     };
 
     WaylandExtensions() = default;
@@ -116,6 +121,7 @@ public:
         std::shared_ptr<SessionAuthorizer> const& session_authorizer,
         std::shared_ptr<SurfaceStack> const& surface_stack,
         std::shared_ptr<scene::Clipboard> const& clipboard,
+        std::shared_ptr<ObserverRegistrar<graphics::PresentationObserver>> const& presentation_observer_registrar,
         bool arw_socket,
         std::unique_ptr<WaylandExtensions> extensions,
         WaylandProtocolExtensionFilter const& extension_filter);
@@ -154,6 +160,8 @@ private:
     std::shared_ptr<Executor> const executor;
     std::shared_ptr<graphics::GraphicBufferAllocator> const allocator;
     std::shared_ptr<shell::Shell> const shell;
+    std::shared_ptr<ObserverRegistrar<graphics::PresentationObserver>> const presentation_observer_registrar;
+    std::shared_ptr<InputLatencyTracker> input_latency;
     std::unique_ptr<WaylandExtensions> const extensions;
     std::thread dispatch_thread;
     wl_event_source* pause_source;
@@ -34,6 +34,8 @@
 #include "pointer_constraints_unstable_v1.h"
 #include "relative-pointer-unstable-v1_wrapper.h"
 #include "relative_pointer_unstable_v1.h"
+#include "presentation-time_wrapper.h"
+#include "presentation_time.h"
 
 #include "mir/graphics/platform.h"
 #include "mir/options/default_configuration.h"
@@ -123,6 +125,15 @@ std::vector<ExtensionBuilder> const internal_extension_builders = {
         mw::PointerConstraintsV1::interface_name, [](auto const& ctx) -> std::shared_ptr<void>
             { return mf::create_pointer_constraints_unstable_v1(ctx.display, *ctx.wayland_executor, ctx.shell); }
     },
+    {
+        mw::Presentation::interface_name, [](auto const& ctx) -> std::shared_ptr<void>
+            {
+                return mf::create_wp_presentation(
+                    ctx.display,
+                    ctx.wayland_executor,
+                    ctx.presentation_observer_registrar);
+            }
+    },
 };
 
 ExtensionBuilder const xwayland_builder {
@@ -217,7 +228,8 @@ auto mf::get_standard_extensions() -> std::vector<std::string>
         mw::Shell::interface_name,
         mw::XdgWmBase::interface_name,
         mw::XdgShellV6::interface_name,
-        mw::XdgOutputManagerV1::interface_name};
+        mw::XdgOutputManagerV1::interface_name,
+        mw::Presentation::interface_name};
 }
 
 auto mf::get_supported_extensions() -> std::vector<std::string>
@@ -256,6 +268,7 @@ std::shared_ptr<mf::Connector>
                 the_session_authorizer(),
                 the_frontend_surface_stack(),
                 the_clipboard(),
+                the_presentation_observer_registrar(),
                 arw_socket,
                 configure_wayland_extensions(
                     wayland_extensions,
@@ -26,10 +26,10 @@
 #include <boost/throw_exception.hpp>
 
 #include <cstring>
-#include <deque>
 #include <functional>
 #include <mutex>
 #include <system_error>
+#include <vector>
 
 namespace mf = mir::frontend;
 
@@ -88,22 +88,24 @@ public:
         std::lock_guard<std::mutex> lock{mutex};
         if (state == ExecutionState::Running)
         {
-            workqueue.emplace_front(std::move(terminator));
+            workqueue.emplace(workqueue.begin(), std::move(terminator));
             on_wayland_thread = false;
             state = ExecutionState::TerminationRequested;
         }
     }
 
-    std::function<void()> get_work()
+    /*
+     * Takes everything queued so far in one go, so producers contend the lock
+     * once per item and the Wayland thread once per batch rather than per item.
+     *
+     * The batch is swapped rather than moved so both vectors keep their capacity
+     * and a steady stream of work doesn't allocate queue storage.
+     */
+    bool take_work(std::vector<std::function<void()>>& batch)
     {
         std::lock_guard<std::mutex> lock{mutex};
-        if (!workqueue.empty())
-        {
-            auto const work = std::move(workqueue.front());
-            workqueue.pop_front();
-            return work;
-        }
-        return {};
+        std::swap(workqueue, batch);
+        return !batch.empty();
     }
 
     std::unique_lock<std::mutex> drain()
@@ -136,7 +138,8 @@ private:
     std::mutex mutex;
     ExecutionState state{ExecutionState::Running};
     wl_event_loop* const loop;
-    std::deque<std::function<void()>> workqueue;
+    std::vector<std::function<void()>> workqueue;
+    std::vector<std::function<void()>> batch;   // Only touched by on_notify()
 };
 
 thread_local bool mf::WaylandExecutor::State::on_wayland_thread{false};
@@ -233,20 +236,24 @@ int mf::WaylandExecutor::State::on_notify(int fd, uint32_t, void* data)
             err);
     }
 
-    while (auto work = state->get_work())
+    while (state->take_work(state->batch))
     {
-        try
+        for (auto& work : state->batch)
         {
-            work();
-        }
-        catch (...)
-        {
-            mir::log(
-                mir::logging::Severity::critical,
-                MIR_LOG_COMPONENT,
-                std::current_exception(),
-                "Exception processing Wayland event loop work item");
+            try
+            {
+                work();
+            }
+            catch (...)
+            {
+                mir::log(
+                    mir::logging::Severity::critical,
+                    MIR_LOG_COMPONENT,
+                    std::current_exception(),
+                    "Exception processing Wayland event loop work item");
+            }
         }
+        state->batch.clear();
     }
     if (state->state != ExecutionState::Running)
     {
@@ -260,7 +267,8 @@ int mf::WaylandExecutor::State::on_notify(int fd, uint32_t, void* data)
 
 mf::WaylandExecutor::WaylandExecutor(wl_event_loop* loop)
     : state{std::make_shared<State>(loop)},
-      notify_fd{eventfd(0, EFD_CLOEXEC | EFD_SEMAPHORE | EFD_NONBLOCK)},
+      // Not a semaphore: one read consumes every pending wakeup, as one notification drains the whole queue
+      notify_fd{eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)},
       source{wl_event_loop_add_fd(
           loop,
           notify_fd,
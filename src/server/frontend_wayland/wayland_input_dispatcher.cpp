@@ -22,6 +22,8 @@
 #include "wl_pointer.h"
 #include "wl_keyboard.h"
 #include "wl_touch.h"
+#include "wl_client.h"
+#include "input_latency_tracker.h"
 
 #include <mir/input/keymap.h>
 #include <mir/log.h>
@@ -86,6 +88,14 @@ void mf::WaylandInputDispatcher::handle_event(MirInputEvent const* event)
         timestamp = std::chrono::nanoseconds{mir_input_event_get_event_time(event)};
     }
 
+    if (InputLatencyTracker::enabled())
+    {
+        if (auto const wl_client = WlClient::from(client))
+        {
+            wl_client->input_delivered(std::chrono::nanoseconds{mir_input_event_get_event_time(event)});
+        }
+    }
+
     switch (mir_input_event_get_type(event))
     {
     case mir_input_event_type_key:
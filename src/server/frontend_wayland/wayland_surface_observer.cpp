@@ -22,14 +22,12 @@
 #include "window_wl_surface_role.h"
 
 #include <mir/executor.h>
-#include <mir/events/event_builders.h>
 #include <mir/input/keymap.h>
 #include <mir/log.h>
 
 namespace mf = mir::frontend;
 namespace ms = mir::scene;
 namespace geom = mir::geometry;
-namespace mev = mir::events;
 namespace mi = mir::input;
 namespace mw = mir::wayland;
 
@@ -126,18 +124,22 @@ void mf::WaylandSurfaceObserver::placed_relative(ms::Surface const*, geometry::R
         });
 }
 
-void mf::WaylandSurfaceObserver::input_consumed(ms::Surface const*, MirEvent const* event)
+void mf::WaylandSurfaceObserver::input_consumed(ms::Surface const*, std::shared_ptr<MirEvent const> const& event)
 {
-    if (mir_event_get_type(event) == mir_event_type_input)
+    if (mir_event_get_type(event.get()) == mir_event_type_input)
     {
-        std::shared_ptr<MirEvent> owned_event = mev::clone_event(*event);
+        auto const queued = PointerMotionCoalescer::enabled() ? impl->motion_coalescer.queue(event) : event;
 
-        run_on_wayland_thread_unless_window_destroyed(
-            [owned_event](Impl* impl, WindowWlSurfaceRole*)
-            {
-                auto const input_event = mir_event_get_input_event(owned_event.get());
-                impl->input_dispatcher->handle_event(input_event);
-            });
+        if (queued)
+        {
+            run_on_wayland_thread_unless_window_destroyed(
+                [queued](Impl* impl, WindowWlSurfaceRole*)
+                {
+                    impl->motion_coalescer.dequeue(queued);
+                    auto const input_event = mir_event_get_input_event(queued.get());
+                    impl->input_dispatcher->handle_event(input_event);
+                });
+        }
     }
 }
 
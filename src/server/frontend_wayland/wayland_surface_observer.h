@@ -21,6 +21,7 @@
 #define MIR_FRONTEND_WAYLAND_SURFACE_OBSERVER_H_
 
 #include "wayland_input_dispatcher.h"
+#include "pointer_motion_coalescer.h"
 #include <mir/scene/null_surface_observer.h>
 
 #include <memory>
@@ -59,7 +60,7 @@ public:
         std::string const& variant,
         std::string const& options) override;
     void placed_relative(scene::Surface const*, geometry::Rectangle const& placement) override;
-    void input_consumed(scene::Surface const*, MirEvent const* event) override;
+    void input_consumed(scene::Surface const*, std::shared_ptr<MirEvent const> const& event) override;
     ///@}
 
     /// Should only be called from the Wayland thread
@@ -100,6 +101,9 @@ private:
         geometry::Size window_size{};
         std::experimental::optional<geometry::Size> requested_size{};
         MirWindowState current_state{mir_window_state_unknown};
+
+        /// Used from the input thread as well as the Wayland thread (it has its own locking)
+        PointerMotionCoalescer motion_coalescer;
     };
 
     void run_on_wayland_thread_unless_window_destroyed(
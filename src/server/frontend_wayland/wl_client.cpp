@@ -132,6 +132,21 @@ mf::WlClient::WlClient(wl_client* client, std::shared_ptr<ms::Session> const& se
 {
 }
 
+void mf::WlClient::input_delivered(std::chrono::nanoseconds event_time)
+{
+    if (!input_awaiting_response)
+    {
+        input_awaiting_response = event_time;
+    }
+}
+
+auto mf::WlClient::take_input_awaiting_response() -> std::experimental::optional<std::chrono::nanoseconds>
+{
+    auto const result = input_awaiting_response;
+    input_awaiting_response = std::experimental::nullopt;
+    return result;
+}
+
 void mf::WlClient::handle_client_created(wl_listener* listener, void* data)
 {
     auto client = reinterpret_cast<wl_client*>(data);
@@ -25,6 +25,8 @@ struct wl_display;
 
 #include <memory>
 #include <functional>
+#include <chrono>
+#include <experimental/optional>
 
 namespace mir
 {
@@ -74,6 +76,12 @@ public:
     auto output_geometry_scale() -> float { return output_geometry_scale_; }
     /// @}
 
+    /// Input latency tracing: the oldest input delivered to this client that is still waiting for a new buffer
+    /// @{
+    void input_delivered(std::chrono::nanoseconds event_time);
+    auto take_input_awaiting_response() -> std::experimental::optional<std::chrono::nanoseconds>;
+    /// @}
+
 private:
     WlClient(wl_client* client, std::shared_ptr<scene::Session> const& session, shell::Shell* shell);
 
@@ -85,6 +93,7 @@ private:
     std::shared_ptr<scene::Session> const session;
 
     float output_geometry_scale_{1};
+    std::experimental::optional<std::chrono::nanoseconds> input_awaiting_response;
 };
 }
 }
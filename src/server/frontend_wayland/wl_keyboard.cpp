@@ -21,6 +21,7 @@
 #include "wayland_utils.h"
 #include "wl_surface.h"
 #include "wl_seat.h"
+#include "keymap_cache.h"
 
 #include "mir/executor.h"
 #include "mir/anonymous_shm_file.h"
@@ -41,11 +42,11 @@ namespace mi = mir::input;
 mf::WlKeyboard::WlKeyboard(
     wl_resource* new_resource,
     mir::input::Keymap const& initial_keymap,
+    std::shared_ptr<KeymapCache> const& keymap_cache,
     std::function<std::vector<uint32_t>()> const& acquire_current_keyboard_state)
     : Keyboard(new_resource, Version<6>()),
-      keymap{nullptr, &xkb_keymap_unref},
+      keymap_cache{keymap_cache},
       state{nullptr, &xkb_state_unref},
-      context{xkb_context_new(XKB_CONTEXT_NO_FLAGS), &xkb_context_unref},
       acquire_current_keyboard_state{acquire_current_keyboard_state}
 {
     // TODO: We should really grab the keymap for the focused surface when
@@ -198,32 +199,28 @@ void mf::WlKeyboard::update_keyboard_state(std::vector<uint32_t> const& keyboard
 
 void mf::WlKeyboard::set_keymap(mi::Keymap const& new_keymap)
 {
-    xkb_rule_names const names = {
-        "evdev",
-        new_keymap.model.c_str(),
-        new_keymap.layout.c_str(),
-        new_keymap.variant.c_str(),
-        new_keymap.options.c_str()
-    };
-    keymap = decltype(keymap){
-        xkb_keymap_new_from_names(
-            context.get(),
-            &names,
-            XKB_KEYMAP_COMPILE_NO_FLAGS),
-        &xkb_keymap_unref};
+    auto const compiled = keymap_cache->get(new_keymap);
+    keymap = compiled->keymap;
 
     // TODO: We might need to copy across the existing depressed keys?
     state = decltype(state)(xkb_state_new(keymap.get()), &xkb_state_unref);
 
-    std::unique_ptr<char, void(*)(void*)> buffer{xkb_keymap_get_as_string(keymap.get(), XKB_KEYMAP_FORMAT_TEXT_V1), free};
-    auto length = strlen(buffer.get());
+    auto const length = compiled->text.size();
 
-    mir::AnonymousShmFile shm_buffer{length};
-    memcpy(shm_buffer.base_ptr(), buffer.get(), length);
+    if (compiled->sealed_file != mir::Fd::invalid)
+    {
+        send_keymap_event(KeymapFormat::xkb_v1, compiled->sealed_file, length);
+    }
+    else
+    {
+        // Without sealing each client needs its own copy it can't use to affect others
+        mir::AnonymousShmFile shm_buffer{length};
+        memcpy(shm_buffer.base_ptr(), compiled->text.data(), length);
 
-    send_keymap_event(KeymapFormat::xkb_v1,
-                      Fd{IntOwnedFd{shm_buffer.fd()}},
-                      length);
+        send_keymap_event(KeymapFormat::xkb_v1,
+                          Fd{IntOwnedFd{shm_buffer.fd()}},
+                          length);
+    }
 }
 
 void mf::WlKeyboard::update_modifier_state()
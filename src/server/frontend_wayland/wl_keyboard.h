@@ -21,6 +21,7 @@
 
 #include "wayland_wrapper.h"
 
+#include <memory>
 #include <vector>
 #include <functional>
 #include <chrono>
@@ -30,7 +31,6 @@ struct MirKeyboardEvent;
 // from <xkbcommon/xkbcommon.h>
 struct xkb_keymap;
 struct xkb_state;
-struct xkb_context;
 
 namespace mir
 {
@@ -45,6 +45,7 @@ class Keymap;
 namespace frontend
 {
 class WlSurface;
+class KeymapCache;
 
 class WlKeyboard : public wayland::Keyboard
 {
@@ -52,6 +53,7 @@ public:
     WlKeyboard(
         wl_resource* new_resource,
         mir::input::Keymap const& initial_keymap,
+        std::shared_ptr<KeymapCache> const& keymap_cache,
         std::function<std::vector<uint32_t>()> const& acquire_current_keyboard_state);
 
     ~WlKeyboard();
@@ -65,9 +67,9 @@ private:
     void update_modifier_state();
     void update_keyboard_state(std::vector<uint32_t> const& keyboard_state);
 
-    std::unique_ptr<xkb_keymap, void (*)(xkb_keymap *)> keymap;
+    std::shared_ptr<KeymapCache> const keymap_cache;
+    std::shared_ptr<xkb_keymap> keymap;
     std::unique_ptr<xkb_state, void (*)(xkb_state *)> state;
-    std::unique_ptr<xkb_context, void (*)(xkb_context *)> const context;
 
     std::function<std::vector<uint32_t>()> const acquire_current_keyboard_state;
 
@@ -19,8 +19,6 @@
 
 #include "wl_region.h"
 
-#include <mir/log.h>
-
 namespace mf = mir::frontend;
 namespace geom = mir::geometry;
 namespace mw = mir::wayland;
@@ -55,9 +53,36 @@ void mf::WlRegion::add(int32_t x, int32_t y, int32_t width, int32_t height)
 
 void mf::WlRegion::subtract(int32_t x, int32_t y, int32_t width, int32_t height)
 {
-    (void)x;
-    (void)y;
-    (void)width;
-    (void)height;
-    log_warning("WlRegion::subtract not implemented. ignoring.");
+    if (width <= 0 || height <= 0)
+        return;
+
+    geom::Rectangle const removed{{x, y}, {width, height}};
+    std::vector<geom::Rectangle> remaining;
+
+    for (auto const& rect : rects)
+    {
+        auto const overlap = rect.intersection_with(removed);
+        if (overlap == geom::Rectangle{})
+        {
+            remaining.push_back(rect);
+            continue;
+        }
+
+        // Keep the parts of rect above, below, left and right of the overlap
+        auto const rect_width = rect.size.width.as_int();
+        auto const overlap_height = overlap.size.height.as_int();
+        geom::Rectangle const pieces[] = {
+            {rect.top_left, {rect_width, (overlap.top() - rect.top()).as_int()}},
+            {{rect.left(), overlap.bottom()}, {rect_width, (rect.bottom() - overlap.bottom()).as_int()}},
+            {{rect.left(), overlap.top()}, {(overlap.left() - rect.left()).as_int(), overlap_height}},
+            {{overlap.right(), overlap.top()}, {(rect.right() - overlap.right()).as_int(), overlap_height}}};
+
+        for (auto const& piece : pieces)
+        {
+            if (piece.size.width.as_int() > 0 && piece.size.height.as_int() > 0)
+                remaining.push_back(piece);
+        }
+    }
+
+    rects = std::move(remaining);
 }
@@ -23,6 +23,7 @@
 #include "wayland_utils.h"
 #include "wl_surface.h"
 #include "wl_keyboard.h"
+#include "keymap_cache.h"
 #include "wl_pointer.h"
 #include "wl_touch.h"
 
@@ -154,6 +155,7 @@ mf::WlSeat::WlSeat(
     std::shared_ptr<mi::Seat> const& seat)
     :   Global(display, Version<6>()),
         keymap{std::make_unique<input::Keymap>()},
+        keymap_cache{std::make_shared<KeymapCache>()},
         config_observer{
             std::make_shared<ConfigObserver>(
                 *keymap,
@@ -237,6 +239,7 @@ void mf::WlSeat::Instance::get_keyboard(wl_resource* new_keyboard)
     auto const keyboard = new WlKeyboard{
         new_keyboard,
         *seat->keymap,
+        seat->keymap_cache,
         [seat = seat->seat]()
         {
             std::unordered_set<uint32_t> pressed_keys;
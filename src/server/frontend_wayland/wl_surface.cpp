@@ -23,12 +23,16 @@
 #include "wl_subcompositor.h"
 #include "wl_region.h"
 #include "deleted_for_resource.h"
+#include "presentation_time.h"
+#include "input_latency_tracker.h"
+#include "wl_client.h"
 
 #include "wayland_wrapper.h"
 
 #include "wayland_frontend.tp.h"
 
 #include "mir/graphics/buffer_properties.h"
+#include "mir/graphics/buffer.h"
 #include "mir/scene/session.h"
 #include "mir/frontend/wayland.h"
 #include "mir/compositor/buffer_stream.h"
@@ -38,6 +42,8 @@
 #include "mir/log.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <thread>
 #include <boost/throw_exception.hpp>
 #include <wayland-server-protocol.h>
 
@@ -66,10 +72,25 @@ void mf::WlSurfaceState::update_from(WlSurfaceState const& source)
     if (source.input_shape)
         input_shape = source.input_shape;
 
+    if (source.opaque_region)
+        opaque_region = source.opaque_region;
+
     frame_callbacks.insert(end(frame_callbacks),
                            begin(source.frame_callbacks),
                            end(source.frame_callbacks));
 
+    presentation_feedbacks.insert(end(presentation_feedbacks),
+                                  begin(source.presentation_feedbacks),
+                                  end(source.presentation_feedbacks));
+
+    surface_damage.insert(end(surface_damage),
+                          begin(source.surface_damage),
+                          end(source.surface_damage));
+
+    buffer_damage.insert(end(buffer_damage),
+                         begin(source.buffer_damage),
+                         end(source.buffer_damage));
+
     if (source.surface_data_invalidated)
         surface_data_invalidated = true;
 }
@@ -78,18 +99,21 @@ bool mf::WlSurfaceState::surface_data_needs_refresh() const
 {
     return offset ||
            input_shape ||
+           opaque_region ||
            surface_data_invalidated;
 }
 
 mf::WlSurface::WlSurface(
     wl_resource* new_resource,
     std::shared_ptr<Executor> const& executor,
-    std::shared_ptr<graphics::GraphicBufferAllocator> const& allocator)
+    std::shared_ptr<graphics::GraphicBufferAllocator> const& allocator,
+    std::shared_ptr<InputLatencyTracker> const& input_latency)
     : Surface(new_resource, Version<4>()),
         session{get_session(client)},
         stream{session->create_buffer_stream({{}, mir_pixel_format_invalid, graphics::BufferUsage::undefined})},
         allocator{allocator},
         executor{executor},
+        input_latency{input_latency},
         null_role{this},
         role{&null_role}
 {
@@ -99,6 +123,10 @@ mf::WlSurface::WlSurface(
 
 mf::WlSurface::~WlSurface()
 {
+    for (auto const& feedback : pending.presentation_feedbacks)
+    {
+        feedback->content_discarded();
+    }
     role->destroy();
     session->destroy_buffer_stream(stream);
 }
@@ -185,7 +213,16 @@ void mf::WlSurface::populate_surface_data(std::vector<shell::StreamSpecification
 {
     geometry::Displacement offset = parent_offset + offset_;
 
-    buffer_streams.push_back(msh::StreamSpecification{stream, offset, {}});
+    geom::Rectangle const stream_rect = {{}, buffer_size_.value_or(geom::Size{})};
+    std::vector<geom::Rectangle> clipped_opaque_region;
+    for (auto const& rect : opaque_region)
+    {
+        auto const clipped = rect.intersection_with(stream_rect);
+        if (clipped != geom::Rectangle{})
+            clipped_opaque_region.push_back(clipped);
+    }
+
+    buffer_streams.push_back(msh::StreamSpecification{stream, offset, {}, std::move(clipped_opaque_region)});
     geom::Rectangle surface_rect = {geom::Point{} + offset, buffer_size_.value_or(geom::Size{})};
     if (input_shape)
     {
@@ -253,20 +290,14 @@ void mf::WlSurface::attach(std::experimental::optional<wl_resource*> const& buff
 
 void mf::WlSurface::damage(int32_t x, int32_t y, int32_t width, int32_t height)
 {
-    (void)x;
-    (void)y;
-    (void)width;
-    (void)height;
-    // This isn't essential, but could enable optimizations
+    if (width > 0 && height > 0)
+        pending.surface_damage.push_back({{x, y}, {width, height}});
 }
 
 void mf::WlSurface::damage_buffer(int32_t x, int32_t y, int32_t width, int32_t height)
 {
-    (void)x;
-    (void)y;
-    (void)width;
-    (void)height;
-    // This isn't essential, but could enable optimizations
+    if (width > 0 && height > 0)
+        pending.buffer_damage.push_back({{x, y}, {width, height}});
 }
 
 void mf::WlSurface::frame(wl_resource* new_callback)
@@ -274,10 +305,17 @@ void mf::WlSurface::frame(wl_resource* new_callback)
     pending.frame_callbacks.push_back(std::make_shared<WlSurfaceState::Callback>(new_callback));
 }
 
+void mf::WlSurface::add_presentation_feedback(std::shared_ptr<WpPresentationFeedback> const& feedback)
+{
+    pending.presentation_feedbacks.push_back(feedback);
+}
+
 void mf::WlSurface::set_opaque_region(std::experimental::optional<wl_resource*> const& region)
 {
-    (void)region;
-    // This isn't essential, but could enable optimizations
+    if (region)
+        pending.opaque_region = WlRegion::from(region.value())->rectangle_vector();
+    else
+        pending.opaque_region = std::vector<geom::Rectangle>{};
 }
 
 void mf::WlSurface::set_input_region(std::experimental::optional<wl_resource*> const& region)
@@ -323,6 +361,37 @@ MirPixelFormat wl_format_to_mir_format(uint32_t format)
             return mir_pixel_format_invalid;
     }
 }
+
+/// Converts a damaged rectangle to buffer coordinates (multiplying by \a scale) and clips it to the buffer
+auto damage_within_buffer(geom::Rectangle const& rect, int scale, geom::Size const& buffer_size) -> geom::Rectangle
+{
+    // Clients commonly damage {0, 0, INT32_MAX, INT32_MAX}, so we must not overflow
+    auto const clamp = [](int64_t value, int limit)
+        {
+            return static_cast<int>(std::min<int64_t>(std::max<int64_t>(value, 0), limit));
+        };
+
+    int64_t const x = rect.left().as_int();
+    int64_t const y = rect.top().as_int();
+    auto const width = buffer_size.width.as_int();
+    auto const height = buffer_size.height.as_int();
+
+    auto const left = clamp(x * scale, width);
+    auto const top = clamp(y * scale, height);
+    auto const right = clamp((x + rect.size.width.as_int()) * scale, width);
+    auto const bottom = clamp((y + rect.size.height.as_int()) * scale, height);
+
+    return {{left, top}, {right - left, bottom - top}};
+}
+
+/// A commit without new content has nothing to present
+void discard_presentation_feedbacks(std::vector<std::shared_ptr<mf::WpPresentationFeedback>> const& feedbacks)
+{
+    for (auto const& feedback : feedbacks)
+    {
+        feedback->content_discarded();
+    }
+}
 }
 
 void mf::WlSurface::commit(WlSurfaceState const& state)
@@ -338,8 +407,14 @@ void mf::WlSurface::commit(WlSurfaceState const& state)
     if (state.input_shape)
         input_shape = state.input_shape.value();
 
+    if (state.opaque_region)
+        opaque_region = state.opaque_region.value();
+
     if (state.scale)
+    {
+        buffer_scale = state.scale.value();
         stream->set_scale(state.scale.value());
+    }
 
     if (state.buffer)
     {
@@ -350,13 +425,46 @@ void mf::WlSurface::commit(WlSurfaceState const& state)
             // TODO: unmap surface, and unmap all subsurfaces
             buffer_size_ = std::experimental::nullopt;
             send_frame_callbacks();
+            discard_presentation_feedbacks(state.presentation_feedbacks);
         }
         else
         {
-            auto const executor_send_frame_callbacks = [executor = executor, weak_self = mw::make_weak(this)]()
+            std::shared_ptr<CommitPresentationFeedback> presentation;
+            if (!state.presentation_feedbacks.empty())
+            {
+                presentation = std::make_shared<CommitPresentationFeedback>(state.presentation_feedbacks, executor);
+            }
+
+            // This buffer is the client's response to any input it was sent since its last buffer
+            std::shared_ptr<InputLatencyTracker::Response> input_response;
+            if (input_latency)
+            {
+                if (auto const wl_client = WlClient::from(client))
+                {
+                    if (auto const input_time = wl_client->take_input_awaiting_response())
+                    {
+                        input_response = std::make_shared<InputLatencyTracker::Response>(
+                            InputLatencyTracker::Response{client, input_time.value()});
+                    }
+                }
+            }
+
+            auto const executor_send_frame_callbacks =
+                [executor = executor, weak_self = mw::make_weak(this), presentation,
+                 input_latency = input_latency, input_response]()
                 {
-                    executor->spawn([weak_self]()
+                    // Called on the thread compositing the buffer, which is the thread that posts it to an output
+                    auto const compositor = std::this_thread::get_id();
+                    executor->spawn([weak_self, presentation, input_latency, input_response, compositor]()
                         {
+                            if (presentation)
+                            {
+                                presentation->buffer_consumed(compositor);
+                            }
+                            if (input_response)
+                            {
+                                input_latency->response_consumed(compositor, input_response);
+                            }
                             if (weak_self)
                             {
                                 weak_self.value().send_frame_callbacks();
@@ -364,6 +472,24 @@ void mf::WlSurface::commit(WlSurfaceState const& state)
                         });
                 };
 
+            // What the client has damaged, in the coordinates of a buffer of buffer_size
+            auto const damage_within = [&](geom::Size const& buffer_size)
+                -> std::experimental::optional<geom::Rectangles>
+                {
+                    if (state.surface_damage.empty() && state.buffer_damage.empty())
+                    {
+                        // Strictly the contents are unchanged, but no client relies on that
+                        return std::experimental::nullopt;
+                    }
+
+                    geom::Rectangles damage;
+                    for (auto const& rect : state.surface_damage)
+                        damage.add(damage_within_buffer(rect, buffer_scale, buffer_size));
+                    for (auto const& rect : state.buffer_damage)
+                        damage.add(damage_within_buffer(rect, 1, buffer_size));
+                    return damage;
+                };
+
             std::shared_ptr<graphics::Buffer> mir_buffer;
 
             if (auto const shm_buffer = wl_shm_buffer_get(buffer))
@@ -382,10 +508,22 @@ void mf::WlSurface::commit(WlSurfaceState const& state)
                     BOOST_THROW_EXCEPTION((
                                               std::runtime_error{"Buffer has invalid stride"}));
                 }
-                mir_buffer = allocator->buffer_from_shm(
-                    buffer,
-                    executor,
-                    std::move(executor_send_frame_callbacks));
+                geom::Size const size{width, wl_shm_buffer_get_height(shm_buffer)};
+                if (auto const damage = damage_within(size))
+                {
+                    mir_buffer = allocator->buffer_from_shm(
+                        buffer,
+                        executor,
+                        std::move(executor_send_frame_callbacks),
+                        damage.value());
+                }
+                else
+                {
+                    mir_buffer = allocator->buffer_from_shm(
+                        buffer,
+                        executor,
+                        std::move(executor_send_frame_callbacks));
+                }
                 tracepoint(
                     mir_server_wayland,
                     sw_buffer_committed,
@@ -414,7 +552,14 @@ void mf::WlSurface::commit(WlSurfaceState const& state)
                     mir_buffer->id().as_value());
             }
 
-            stream->submit_buffer(mir_buffer);
+            if (auto const damage = damage_within(mir_buffer->size()))
+            {
+                stream->submit_buffer(mir_buffer, damage.value());
+            }
+            else
+            {
+                stream->submit_buffer(mir_buffer);
+            }
             auto const new_buffer_size = stream->stream_size();
 
             if (!input_shape && std::experimental::make_optional(new_buffer_size) != buffer_size_)
@@ -428,6 +573,7 @@ void mf::WlSurface::commit(WlSurfaceState const& state)
     else
     {
         send_frame_callbacks();
+        discard_presentation_feedbacks(state.presentation_feedbacks);
     }
 
     for (WlSubsurface* child: children)
@@ -447,6 +593,9 @@ void mf::WlSurface::commit()
     if (pending.input_shape && *pending.input_shape == input_shape)
         pending.input_shape = std::experimental::nullopt;
 
+    if (pending.opaque_region && *pending.opaque_region == opaque_region)
+        pending.opaque_region = std::experimental::nullopt;
+
     // order is important
     auto const state = std::move(pending);
     pending = WlSurfaceState();
@@ -58,6 +58,8 @@ namespace frontend
 {
 class WlSurface;
 class WlSubsurface;
+class WpPresentationFeedback;
+class InputLatencyTracker;
 
 struct WlSurfaceState
 {
@@ -83,7 +85,11 @@ struct WlSurfaceState
     std::experimental::optional<int> scale;
     std::experimental::optional<geometry::Displacement> offset;
     std::experimental::optional<std::experimental::optional<std::vector<geometry::Rectangle>>> input_shape;
+    std::experimental::optional<std::vector<geometry::Rectangle>> opaque_region;
     std::vector<std::shared_ptr<Callback>> frame_callbacks;
+    std::vector<std::shared_ptr<WpPresentationFeedback>> presentation_feedbacks;
+    std::vector<geometry::Rectangle> surface_damage; ///< in surface coordinates
+    std::vector<geometry::Rectangle> buffer_damage;  ///< in buffer coordinates
 
 private:
     // only set to true if invalidate_surface_data() is called
@@ -111,7 +117,8 @@ class WlSurface : public wayland::Surface
 public:
     WlSurface(wl_resource* new_resource,
               std::shared_ptr<mir::Executor> const& executor,
-              std::shared_ptr<graphics::GraphicBufferAllocator> const& allocator);
+              std::shared_ptr<graphics::GraphicBufferAllocator> const& allocator,
+              std::shared_ptr<InputLatencyTracker> const& input_latency);
 
     ~WlSurface();
 
@@ -130,6 +137,7 @@ public:
     void remove_subsurface(WlSubsurface* child);
     void refresh_surface_data_now();
     void pending_invalidate_surface_data() { pending.invalidate_surface_data(); }
+    void add_presentation_feedback(std::shared_ptr<WpPresentationFeedback> const& feedback);
     void populate_surface_data(std::vector<shell::StreamSpecification>& buffer_streams,
                                std::vector<mir::geometry::Rectangle>& input_shape_accumulator,
                                geometry::Displacement const& parent_offset) const;
@@ -143,6 +151,7 @@ public:
 private:
     std::shared_ptr<mir::graphics::GraphicBufferAllocator> const allocator;
     std::shared_ptr<mir::Executor> const executor;
+    std::shared_ptr<InputLatencyTracker> const input_latency; ///< null unless input latency tracing is enabled
 
     NullWlSurfaceRole null_role;
     WlSurfaceRole* role;
@@ -151,8 +160,10 @@ private:
     WlSurfaceState pending;
     geometry::Displacement offset_;
     std::experimental::optional<geometry::Size> buffer_size_;
+    int buffer_scale{1};
     std::vector<std::shared_ptr<WlSurfaceState::Callback>> frame_callbacks;
     std::experimental::optional<std::vector<mir::geometry::Rectangle>> input_shape;
+    std::vector<mir::geometry::Rectangle> opaque_region;
 
     void send_frame_callbacks();
 
@@ -114,12 +114,18 @@ void mf::XWaylandSurfaceObserver::keymap_changed(
         });
 }
 
-void mf::XWaylandSurfaceObserver::input_consumed(ms::Surface const*, MirEvent const* event)
+void mf::XWaylandSurfaceObserver::input_consumed(ms::Surface const*, std::shared_ptr<MirEvent const> const& event)
 {
-    if (mir_event_get_type(event) == mir_event_type_input)
+    if (mir_event_get_type(event.get()) == mir_event_type_input)
     {
-        std::shared_ptr<MirEvent> owned_event = mev::clone_event(*event);
-        mev::scale_positions(*owned_event, scale);
+        // Events are shared with other consumers, so only copy one if it needs rescaling
+        std::shared_ptr<MirEvent const> owned_event = event;
+        if (scale != 1.0f)
+        {
+            std::shared_ptr<MirEvent> scaled_event = mev::clone_event(*event);
+            mev::scale_positions(*scaled_event, scale);
+            owned_event = std::move(scaled_event);
+        }
 
         aquire_input_dispatcher(
             [owned_event](auto input_dispatcher)
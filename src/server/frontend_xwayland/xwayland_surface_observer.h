@@ -65,7 +65,7 @@ public:
         std::string const& layout,
         std::string const& variant,
         std::string const& options) override;
-    void input_consumed(scene::Surface const*, MirEvent const* event) override;
+    void input_consumed(scene::Surface const*, std::shared_ptr<MirEvent const> const& event) override;
     ///@}
 
     /// Can be called from any thread
@@ -28,6 +28,9 @@
 
 #include <boost/throw_exception.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace mf = mir::frontend;
 namespace mc = mir::compositor;
 namespace geom = mir::geometry;
@@ -87,6 +90,16 @@ void mf::XWaylandSurfaceRole::populate_surface_data_scaled(
                 stream.size = stream.size.value() * inv_scale;
             }
             stream.displacement = stream.displacement * inv_scale;
+
+            // Round inwards: wrongly claiming a pixel is opaque is visible, wrongly claiming it is not is harmless
+            for (auto& rect : stream.opaque_region)
+            {
+                auto const left = static_cast<int>(std::ceil(rect.left().as_int() * inv_scale));
+                auto const top = static_cast<int>(std::ceil(rect.top().as_int() * inv_scale));
+                auto const right = static_cast<int>(std::floor(rect.right().as_int() * inv_scale));
+                auto const bottom = static_cast<int>(std::floor(rect.bottom().as_int() * inv_scale));
+                rect = geom::Rectangle{{left, top}, {std::max(right - left, 0), std::max(bottom - top, 0)}};
+            }
         }
 
         for (auto& rect : spec.input_shape.value())
@@ -32,6 +32,7 @@
 #include "mir/graphics/platform.h"
 #include "mir/graphics/cursor.h"
 #include "display_configuration_observer_multiplexer.h"
+#include "presentation_observer_multiplexer.h"
 
 #include "mir/shared_library.h"
 #include "mir/shared_library_prober.h"
@@ -124,7 +125,9 @@ std::shared_ptr<mg::Platform> mir::DefaultServerConfiguration::the_graphics_plat
                     the_options(),
                     the_emergency_cleanup(),
                     the_console_services(),
-                    the_display_report(),
+                    std::make_shared<mg::PresentationNotifyingDisplayReport>(
+                        the_display_report(),
+                        the_presentation_observer()),
                     the_logger());
             }
             catch(...)
@@ -251,3 +254,23 @@ mir::DefaultServerConfiguration::the_display_configuration_observer()
             return std::make_shared<mg::DisplayConfigurationObserverMultiplexer>(default_executor);
         });
 }
+
+std::shared_ptr<mir::ObserverRegistrar<mg::PresentationObserver>>
+mir::DefaultServerConfiguration::the_presentation_observer_registrar()
+{
+    return presentation_observer_multiplexer(
+        [default_executor = the_main_loop()]
+        {
+            return std::make_shared<mg::PresentationObserverMultiplexer>(default_executor);
+        });
+}
+
+std::shared_ptr<mg::PresentationObserver>
+mir::DefaultServerConfiguration::the_presentation_observer()
+{
+    return presentation_observer_multiplexer(
+        [default_executor = the_main_loop()]
+        {
+            return std::make_shared<mg::PresentationObserverMultiplexer>(default_executor);
+        });
+}
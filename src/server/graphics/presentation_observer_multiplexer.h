@@ -0,0 +1,69 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GRAPHICS_PRESENTATION_OBSERVER_MULTIPLEXER_H_
+#define MIR_GRAPHICS_PRESENTATION_OBSERVER_MULTIPLEXER_H_
+
+#include "mir/observer_multiplexer.h"
+#include "mir/graphics/presentation_observer.h"
+#include "mir/graphics/display_report.h"
+
+#include <memory>
+
+namespace mir
+{
+namespace graphics
+{
+class PresentationObserverMultiplexer : public ObserverMultiplexer<PresentationObserver>
+{
+public:
+    PresentationObserverMultiplexer(std::shared_ptr<Executor> const& default_executor);
+
+    void frame_presented(unsigned int output_id, Frame const& frame) override;
+    void frame_posted(unsigned int output_id, std::thread::id compositor) override;
+
+private:
+    std::shared_ptr<Executor> const executor;
+};
+
+/// Forwards everything to the wrapped report, and posts and page flips to the presentation observer too
+class PresentationNotifyingDisplayReport : public DisplayReport
+{
+public:
+    PresentationNotifyingDisplayReport(
+        std::shared_ptr<DisplayReport> const& wrapped,
+        std::shared_ptr<PresentationObserver> const& observer);
+
+    void report_successful_setup_of_native_resources() override;
+    void report_successful_egl_make_current_on_construction() override;
+    void report_successful_egl_buffer_swap_on_construction() override;
+    void report_successful_display_construction() override;
+    void report_egl_configuration(EGLDisplay disp, EGLConfig cfg) override;
+    void report_vsync(unsigned int output_id, Frame const& frame) override;
+    void report_frame_posted(unsigned int output_id) override;
+    void report_successful_drm_mode_set_crtc_on_construction() override;
+    void report_drm_master_failure(int error) override;
+    void report_vt_switch_away_failure() override;
+    void report_vt_switch_back_failure() override;
+
+private:
+    std::shared_ptr<DisplayReport> const wrapped;
+    std::shared_ptr<PresentationObserver> const observer;
+};
+}
+}
+
+#endif //MIR_GRAPHICS_PRESENTATION_OBSERVER_MULTIPLEXER_H_
@@ -261,7 +261,10 @@ mir::DefaultServerConfiguration::the_input_reading_multiplexer()
     return input_reading_multiplexer(
         []() -> std::shared_ptr<mir::dispatch::MultiplexingDispatchable>
         {
-            return std::make_shared<mir::dispatch::MultiplexingDispatchable>();
+            auto const multiplexer = std::make_shared<mir::dispatch::MultiplexingDispatchable>();
+            // Only the input reading thread dispatches this, so batching ready devices costs no parallelism
+            multiplexer->set_max_events_per_dispatch(16);
+            return multiplexer;
         }
     );
 }
@@ -127,22 +127,31 @@ void deliver_without_relative_motion(
     mev::transform_positions(*to_deliver, geom::Displacement{bounds.top_left.x.as_int(), bounds.top_left.y.as_int()});
     if (!drag_and_drop_handle.empty())
         mev::set_drag_and_drop_handle(*to_deliver, drag_and_drop_handle);
-    surface->consume(to_deliver.get());
+    surface->consume(std::move(to_deliver));
 }
 
 void deliver(
     std::shared_ptr<mi::Surface> const& surface,
-    MirEvent const* ev,
+    std::shared_ptr<MirEvent const> const& ev,
     std::vector<uint8_t> const& drag_and_drop_handle)
 {
+    auto const& bounds = surface->input_bounds();
+    geom::Displacement const displacement{bounds.top_left.x.as_int(), bounds.top_left.y.as_int()};
+
+    // The event is shared with the rest of the pipeline: only copy it if it needs changing
+    if (displacement == geom::Displacement{} && drag_and_drop_handle.empty())
+    {
+        surface->consume(ev);
+        return;
+    }
+
     auto to_deliver = mev::clone_event(*ev);
 
     if (!drag_and_drop_handle.empty())
         mev::set_drag_and_drop_handle(*to_deliver, drag_and_drop_handle);
 
-    auto const& bounds = surface->input_bounds();
-    mev::transform_positions(*to_deliver, geom::Displacement{bounds.top_left.x.as_int(), bounds.top_left.y.as_int()});
-    surface->consume(to_deliver.get());
+    mev::transform_positions(*to_deliver, displacement);
+    surface->consume(std::move(to_deliver));
 }
 
 }
@@ -401,7 +410,7 @@ void mi::SurfaceInputDispatcher::device_reset(MirInputDeviceId reset_device_id,
         touch_state_by_id.erase(touch_it);
 }
 
-bool mi::SurfaceInputDispatcher::dispatch_key(MirEvent const* kev)
+bool mi::SurfaceInputDispatcher::dispatch_key(std::shared_ptr<MirEvent const> const& kev)
 {
     std::lock_guard<std::mutex> lg(dispatcher_mutex);
 
@@ -442,12 +451,7 @@ bool is_gesture_terminator(MirPointerEvent const* pev)
 
 std::shared_ptr<mi::Surface> mi::SurfaceInputDispatcher::find_target_surface(geom::Point const& point)
 {
-    std::shared_ptr<mi::Surface> top_target = nullptr;
-    scene->for_each([&top_target, &point](std::shared_ptr<mi::Surface> const& target) {
-            if (target->input_area_contains(point))
-                top_target = target;
-    });
-    return top_target;
+    return scene->input_surface_at(point);
 }
 
 void mi::SurfaceInputDispatcher::send_enter_exit_event(std::shared_ptr<mi::Surface> const& surface,
@@ -471,7 +475,7 @@ void mi::SurfaceInputDispatcher::send_enter_exit_event(std::shared_ptr<mi::Surfa
 
     if (!drag_and_drop_handle.empty())
         mev::set_drag_and_drop_handle(*event, drag_and_drop_handle);
-    surface->consume(event.get());
+    surface->consume(std::move(event));
 }
 
 mi::SurfaceInputDispatcher::PointerInputState& mi::SurfaceInputDispatcher::ensure_pointer_state(MirInputDeviceId id)
@@ -500,7 +504,7 @@ bool mi::SurfaceInputDispatcher::dispatch_pointer(MirInputDeviceId id, std::shar
 
     if (pointer_state.gesture_owner)
     {
-        deliver(pointer_state.gesture_owner, ev, drag_and_drop_handle);
+        deliver(pointer_state.gesture_owner, event, drag_and_drop_handle);
 
         auto const gesture_terminated = is_gesture_terminator(pev);
 
@@ -565,7 +569,7 @@ bool mi::SurfaceInputDispatcher::dispatch_pointer(MirInputDeviceId id, std::shar
         }
         else
         {
-            deliver(target, ev, drag_and_drop_handle);
+            deliver(target, event, drag_and_drop_handle);
         }
         return true;
     }
@@ -597,10 +601,10 @@ bool is_gesture_end(MirTouchEvent const* tev)
 }
 }
 
-bool mi::SurfaceInputDispatcher::dispatch_touch(MirInputDeviceId id, MirEvent const* ev)
+bool mi::SurfaceInputDispatcher::dispatch_touch(MirInputDeviceId id, std::shared_ptr<MirEvent const> const& event)
 {
     std::lock_guard<std::mutex> lg(dispatcher_mutex);
-    auto const* input_ev = mir_event_get_input_event(ev);
+    auto const* input_ev = mir_event_get_input_event(event.get());
     auto const* tev = mir_input_event_get_touch_event(input_ev);
 
     auto& gesture_owner = ensure_touch_state(id).gesture_owner;
@@ -621,7 +625,7 @@ bool mi::SurfaceInputDispatcher::dispatch_touch(MirInputDeviceId id, MirEvent co
 
     if (gesture_owner)
     {
-        deliver(gesture_owner, ev, drag_and_drop_handle);
+        deliver(gesture_owner, event, drag_and_drop_handle);
 
         if (is_gesture_end(tev))
             gesture_owner.reset();
@@ -642,9 +646,9 @@ bool mi::SurfaceInputDispatcher::dispatch(std::shared_ptr<MirEvent const> const&
     switch (mir_input_event_get_type(iev))
     {
     case mir_input_event_type_key:
-        return dispatch_key(event.get());
+        return dispatch_key(event);
     case mir_input_event_type_touch:
-        return dispatch_touch(id, event.get());
+        return dispatch_touch(id, event);
     case mir_input_event_type_pointer:
         return dispatch_pointer(id, event);
     default:
@@ -147,7 +147,7 @@ void ms::SurfaceObservers::placed_relative(Surface const* surf, geometry::Rectan
                  { observer->placed_relative(surf, placement); });
 }
 
-void ms::SurfaceObservers::input_consumed(Surface const* surf, MirEvent const* event)
+void ms::SurfaceObservers::input_consumed(Surface const* surf, std::shared_ptr<MirEvent const> const& event)
 {
     for_each([&](std::shared_ptr<SurfaceObserver> const& observer)
                  { observer->input_consumed(surf, event); });
@@ -171,6 +171,12 @@ void ms::SurfaceObservers::application_id_set_to(Surface const* surf, std::strin
                  { observer->application_id_set_to(surf, application_id); });
 }
 
+void ms::SurfaceObservers::input_region_set_to(Surface const* surf, std::vector<geometry::Rectangle> const& region)
+{
+    for_each([&](std::shared_ptr<SurfaceObserver> const& observer)
+                 { observer->input_region_set_to(surf, region); });
+}
+
 ms::BasicSurface::ProofOfMutexLock::ProofOfMutexLock(std::unique_lock<std::mutex> const& lock)
 {
     if (!lock.owns_lock())
@@ -366,8 +372,11 @@ std::shared_ptr<mf::BufferStream> ms::BasicSurface::primary_buffer_stream() cons
 
 void ms::BasicSurface::set_input_region(std::vector<geom::Rectangle> const& input_rectangles)
 {
-    std::lock_guard<std::mutex> lock(guard);
-    custom_input_rectangles = input_rectangles;
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        custom_input_rectangles = input_rectangles;
+    }
+    observers->input_region_set_to(this, input_rectangles);
 }
 
 void ms::BasicSurface::resize(geom::Size const& desired_size)
@@ -808,6 +817,7 @@ public:
         std::experimental::optional<geom::Rectangle> const& clip_area,
         glm::mat4 const& transform,
         float alpha,
+        geom::Rectangles const& opaque_region,
         mg::Renderable::ID id)
     : underlying_buffer_stream{stream},
       compositor_id{compositor_id},
@@ -815,6 +825,7 @@ public:
       screen_position_(position),
       clip_area_(clip_area),
       transformation_(transform),
+      opaque_region_(opaque_region),
       id_(id)
     {
     }
@@ -852,6 +863,12 @@ public:
 
     mg::Renderable::ID id() const override
     { return id_; }
+
+    std::experimental::optional<geom::Rectangles> buffer_damage_since(mg::BufferID previous) const override
+    { return underlying_buffer_stream->buffer_damage(previous, buffer()->id()); }
+
+    geom::Rectangles opaque_region() const override
+    { return opaque_region_; }
 private:
     std::shared_ptr<mc::BufferStream> const underlying_buffer_stream;
     std::shared_ptr<mg::Buffer> mutable compositor_buffer;
@@ -860,6 +877,7 @@ private:
     geom::Rectangle const screen_position_;
     std::experimental::optional<geom::Rectangle> const clip_area_;
     glm::mat4 const transformation_;
+    geom::Rectangles const opaque_region_;
     mg::Renderable::ID const id_;
 };
 }
@@ -873,7 +891,7 @@ int ms::BasicSurface::buffers_ready_for_compositor(void const* id) const
     return max_buf;
 }
 
-void ms::BasicSurface::consume(MirEvent const* event)
+void ms::BasicSurface::consume(std::shared_ptr<MirEvent const> const& event)
 {
     observers->input_consumed(this, event);
 }
@@ -941,11 +959,22 @@ mg::RenderableList ms::BasicSurface::generate_renderables(mc::CompositorID id) c
             else
                 size = info.stream->stream_size();
 
+            geom::Rectangle const position{content_top_left_ + info.displacement, std::move(size)};
+
+            geom::Rectangles opaque_region;
+            for (auto const& rect : info.opaque_region)
+            {
+                auto const opaque = geom::Rectangle{position.top_left + as_displacement(rect.top_left), rect.size}
+                    .intersection_with(position);
+                if (opaque != geom::Rectangle{})
+                    opaque_region.add(opaque);
+            }
+
             list.emplace_back(std::make_shared<SurfaceSnapshot>(
                 info.stream, id,
-                geom::Rectangle{content_top_left_ + info.displacement, std::move(size)},
+                position,
                 clip_area_,
-                transformation_matrix, surface_alpha, info.stream.get()));
+                transformation_matrix, surface_alpha, opaque_region, info.stream.get()));
         }
     }
     return list;
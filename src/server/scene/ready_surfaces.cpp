@@ -0,0 +1,67 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ready_surfaces.h"
+
+namespace ms = mir::scene;
+namespace mc = mir::compositor;
+
+void ms::ReadySurfaces::add_compositor(mc::CompositorID cid, Surfaces const& surfaces)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    ready[cid].insert(surfaces.begin(), surfaces.end());
+}
+
+void ms::ReadySurfaces::remove_compositor(mc::CompositorID cid)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    ready.erase(cid);
+}
+
+void ms::ReadySurfaces::posted(Surface const* surface)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    for (auto& surfaces : ready)
+        surfaces.second.insert(surface);
+}
+
+void ms::ReadySurfaces::remove(Surface const* surface)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    for (auto& surfaces : ready)
+        surfaces.second.erase(surface);
+}
+
+auto ms::ReadySurfaces::take(mc::CompositorID cid, Surfaces& surfaces) -> bool
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    auto const p = ready.find(cid);
+    if (p == ready.end())
+        return false;
+
+    // Anything posted from now on lands in the (empty) tracked set, so isn't lost
+    surfaces.clear();
+    surfaces.swap(p->second);
+    return true;
+}
+
+void ms::ReadySurfaces::restore(mc::CompositorID cid, Surfaces const& surfaces)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    auto const p = ready.find(cid);
+    if (p != ready.end())
+        p->second.insert(surfaces.begin(), surfaces.end());
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_SCENE_READY_SURFACES_H_
+#define MIR_SCENE_READY_SURFACES_H_
+
+#include "mir/compositor/compositor_id.h"
+
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace mir
+{
+namespace scene
+{
+class Surface;
+
+/// For each compositor, the surfaces that may have frames ready for it.
+///
+/// Surfaces are added when they post a frame and only leave once a
+/// compositor finds they have nothing more for it, so checking for pending
+/// frames costs in proportion to the surfaces that changed rather than to
+/// all the surfaces in the scene.
+class ReadySurfaces
+{
+public:
+    using Surfaces = std::unordered_set<Surface const*>;
+
+    /// Starts tracking cid, with every one of surfaces possibly ready
+    void add_compositor(compositor::CompositorID cid, Surfaces const& surfaces);
+    void remove_compositor(compositor::CompositorID cid);
+
+    /// surface may have a frame ready for every compositor
+    void posted(Surface const* surface);
+    void remove(Surface const* surface);
+
+    /// Moves the surfaces that may be ready for cid into surfaces; false if cid isn't tracked
+    auto take(compositor::CompositorID cid, Surfaces& surfaces) -> bool;
+    /// Returns surfaces that still (may) have frames ready after take()
+    void restore(compositor::CompositorID cid, Surfaces const& surfaces);
+
+private:
+    std::mutex mutex;
+    std::unordered_map<compositor::CompositorID, Surfaces> ready;
+};
+}
+}
+
+#endif /* MIR_SCENE_READY_SURFACES_H_ */
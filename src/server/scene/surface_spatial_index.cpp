@@ -0,0 +1,240 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "surface_spatial_index.h"
+#include "mir/scene/surface.h"
+#include "mir/geometry/rectangles.h"
+
+#include <algorithm>
+
+namespace ms = mir::scene;
+namespace geom = mir::geometry;
+
+namespace
+{
+/// Chosen so that a typical window spans a handful of cells
+int const cell_size{256};
+/// A surface spanning more cells than this is checked for every query instead
+int const max_cells_per_surface{256};
+
+auto cell_of(int coordinate) -> int32_t
+{
+    // Round towards negative infinity, so that cells are all the same size
+    return coordinate >= 0 ? coordinate / cell_size : (coordinate - cell_size + 1) / cell_size;
+}
+
+auto key_of(int32_t cell_x, int32_t cell_y) -> uint64_t
+{
+    return uint64_t{static_cast<uint32_t>(cell_x)} << 32 | static_cast<uint32_t>(cell_y);
+}
+
+/// The cells covered by a rectangle (inclusive)
+struct CellRange
+{
+    explicit CellRange(geom::Rectangle const& bounds)
+        : empty{bounds.size.width.as_int() <= 0 || bounds.size.height.as_int() <= 0},
+          left{cell_of(bounds.left().as_int())},
+          right{empty ? left : cell_of(bounds.right().as_int() - 1)},
+          top{cell_of(bounds.top().as_int())},
+          bottom{empty ? top : cell_of(bounds.bottom().as_int() - 1)}
+    {
+    }
+
+    auto count() const -> int64_t
+    {
+        return empty ? 0 : (int64_t{right} - left + 1) * (int64_t{bottom} - top + 1);
+    }
+
+    bool const empty;
+    int32_t const left;
+    int32_t const right;
+    int32_t const top;
+    int32_t const bottom;
+};
+
+auto bounds_of(ms::Surface const& surface, std::vector<geom::Rectangle> const& input_region) -> geom::Rectangle
+{
+    auto const content = surface.input_bounds();
+
+    // An empty input region means the whole of the content accepts input
+    if (input_region.empty())
+        return content;
+
+    geom::Rectangles rects;
+    for (auto const& rect : input_region)
+        rects.add({content.top_left + as_displacement(rect.top_left), rect.size});
+
+    return rects.bounding_rectangle();
+}
+}
+
+template<typename F>
+void ms::SurfaceSpatialIndex::for_each_cell(geom::Rectangle const& bounds, F const& f)
+{
+    CellRange const range{bounds};
+    if (range.empty)
+        return;
+
+    for (auto x = range.left; x <= range.right; ++x)
+        for (auto y = range.top; y <= range.bottom; ++y)
+            f(key_of(x, y));
+}
+
+void ms::SurfaceSpatialIndex::insert_into_grid(Entry& entry)
+{
+    auto const key = entry.surface.get();
+
+    entry.oversized = CellRange{entry.bounds}.count() > max_cells_per_surface;
+    if (entry.oversized)
+    {
+        oversized.push_back(key);
+    }
+    else
+    {
+        for_each_cell(entry.bounds, [&](CellKey cell) { cells[cell].push_back(key); });
+    }
+}
+
+void ms::SurfaceSpatialIndex::remove_from_grid(Entry const& entry)
+{
+    auto const key = entry.surface.get();
+    auto const erase_from = [key](std::vector<Surface const*>& surfaces)
+        {
+            surfaces.erase(std::remove(surfaces.begin(), surfaces.end(), key), surfaces.end());
+        };
+
+    if (entry.oversized)
+    {
+        erase_from(oversized);
+    }
+    else
+    {
+        for_each_cell(entry.bounds, [&](CellKey cell)
+            {
+                auto const i = cells.find(cell);
+                if (i != cells.end())
+                {
+                    erase_from(i->second);
+                    if (i->second.empty())
+                        cells.erase(i);
+                }
+            });
+    }
+}
+
+void ms::SurfaceSpatialIndex::add(std::shared_ptr<Surface> const& surface)
+{
+    auto const bounds = bounds_of(*surface, {});
+
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto const inserted = entries.emplace(surface.get(), Entry{surface, {}, bounds, false, 0});
+    if (inserted.second)
+        insert_into_grid(inserted.first->second);
+}
+
+void ms::SurfaceSpatialIndex::remove(Surface const* surface)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto const i = entries.find(surface);
+    if (i != entries.end())
+    {
+        remove_from_grid(i->second);
+        entries.erase(i);
+    }
+}
+
+void ms::SurfaceSpatialIndex::update(Surface const* surface)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto const i = entries.find(surface);
+    if (i == entries.end())
+        return;
+
+    auto& entry = i->second;
+    auto const bounds = bounds_of(*surface, entry.input_region);
+    if (bounds != entry.bounds)
+    {
+        remove_from_grid(entry);
+        entry.bounds = bounds;
+        insert_into_grid(entry);
+    }
+}
+
+void ms::SurfaceSpatialIndex::update(Surface const* surface, std::vector<geom::Rectangle> const& input_region)
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+
+        auto const i = entries.find(surface);
+        if (i == entries.end())
+            return;
+
+        i->second.input_region = input_region;
+    }
+
+    update(surface);
+}
+
+void ms::SurfaceSpatialIndex::restack(Layers const& layers)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    size_t position{0};
+    for (auto const& layer : layers)
+    {
+        for (auto const& surface : layer)
+        {
+            auto const i = entries.find(surface.get());
+            if (i != entries.end())
+                i->second.stacking_position = position++;
+        }
+    }
+}
+
+auto ms::SurfaceSpatialIndex::candidates_at(geom::Point point) const -> std::vector<std::shared_ptr<Surface>>
+{
+    std::vector<Entry const*> hits;
+
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto const collect = [&](std::vector<Surface const*> const& surfaces)
+        {
+            for (auto const surface : surfaces)
+            {
+                auto const& entry = entries.at(surface);
+                if (entry.bounds.contains(point))
+                    hits.push_back(&entry);
+            }
+        };
+
+    auto const cell = cells.find(key_of(cell_of(point.x.as_int()), cell_of(point.y.as_int())));
+    if (cell != cells.end())
+        collect(cell->second);
+    collect(oversized);
+
+    std::sort(hits.begin(), hits.end(),
+        [](Entry const* lhs, Entry const* rhs) { return lhs->stacking_position > rhs->stacking_position; });
+
+    std::vector<std::shared_ptr<Surface>> candidates;
+    candidates.reserve(hits.size());
+    for (auto const entry : hits)
+        candidates.push_back(entry->surface);
+
+    return candidates;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_SCENE_SURFACE_SPATIAL_INDEX_H_
+#define MIR_SCENE_SURFACE_SPATIAL_INDEX_H_
+
+#include "mir/geometry/point.h"
+#include "mir/geometry/rectangle.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace mir
+{
+namespace scene
+{
+class Surface;
+
+/// A grid over the bounds of each surface's input area, so that hit-testing
+/// doesn't need to ask every surface in the scene.
+///
+/// The bounds are conservative: a surface that is hidden, clipped or has a
+/// sparse input region is still a candidate, so callers must confirm a hit
+/// with Surface::input_area_contains().
+class SurfaceSpatialIndex
+{
+public:
+    using Layers = std::vector<std::vector<std::shared_ptr<Surface>>>;
+
+    void add(std::shared_ptr<Surface> const& surface);
+    void remove(Surface const* surface);
+
+    /// Recalculates the bounds of surface after it moves or resizes
+    void update(Surface const* surface);
+    /// Records surface's input region (relative to its content) and recalculates its bounds
+    void update(Surface const* surface, std::vector<geometry::Rectangle> const& input_region);
+
+    /// Records the stacking order (layers bottom to top, each bottom to top)
+    void restack(Layers const& layers);
+
+    /// Surfaces whose input area may contain point, topmost first
+    auto candidates_at(geometry::Point point) const -> std::vector<std::shared_ptr<Surface>>;
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<Surface> surface;
+        std::vector<geometry::Rectangle> input_region;
+        geometry::Rectangle bounds;
+        bool oversized;
+        size_t stacking_position;
+    };
+
+    using CellKey = uint64_t;
+
+    void insert_into_grid(Entry& entry);
+    void remove_from_grid(Entry const& entry);
+    template<typename F>
+    void for_each_cell(geometry::Rectangle const& bounds, F const& f);
+
+    std::mutex mutable mutex;
+    std::unordered_map<Surface const*, Entry> entries;
+    std::unordered_map<CellKey, std::vector<Surface const*>> cells;
+    /// Surfaces too big to be worth adding to individual cells
+    std::vector<Surface const*> oversized;
+};
+}
+}
+
+#endif /* MIR_SCENE_SURFACE_SPATIAL_INDEX_H_ */
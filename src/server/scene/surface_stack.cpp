@@ -48,14 +48,12 @@ class SurfaceSceneElement : public mc::SceneElement
 {
 public:
     SurfaceSceneElement(
-        std::string name,
         std::shared_ptr<mg::Renderable> const& renderable,
         std::shared_ptr<ms::RenderingTracker> const& tracker,
         mc::CompositorID id)
         : renderable_{renderable},
           tracker{tracker},
-          cid{id},
-          surface_name(name)
+          cid{id}
     {
     }
 
@@ -78,7 +76,6 @@ private:
     std::shared_ptr<mg::Renderable> const renderable_;
     std::shared_ptr<ms::RenderingTracker> const tracker;
     mc::CompositorID cid;
-    std::string const surface_name;
 };
 
 //note: something different than a 2D/HWC overlay
@@ -86,7 +83,7 @@ class OverlaySceneElement : public mc::SceneElement
 {
 public:
     OverlaySceneElement(
-        std::shared_ptr<mg::Renderable> renderable)
+        std::shared_ptr<mg::Renderable> const& renderable)
         : renderable_{renderable}
     {
     }
@@ -109,33 +106,74 @@ private:
 };
 
 /**
- * A SurfaceDepthLayerObserver must not outlive the SurfaceStack it was created for
+ * A StackedSurfaceObserver must not outlive the SurfaceStack it was created for
  */
-struct SurfaceDepthLayerObserver : ms::NullSurfaceObserver
-{
-    SurfaceDepthLayerObserver(ms::SurfaceStack* stack)
-        : stack{stack}
+struct StackedSurfaceObserver : ms::NullSurfaceObserver
+{
+    StackedSurfaceObserver(
+        ms::SurfaceStack* stack,
+        ms::SurfaceSpatialIndex& input_index,
+        ms::ReadySurfaces& ready_surfaces)
+        : stack{stack},
+          input_index{input_index},
+          ready_surfaces{ready_surfaces}
     {
     }
 
+    void frame_posted(ms::Surface const* surface, int /*frames_available*/, geom::Size const& /*size*/) override
+    {
+        ready_surfaces.posted(surface);
+    }
+
     void depth_layer_set_to(ms::Surface const* surface, MirDepthLayer /*z_index*/) override
     {
         // move the surface to the top of it's new layer
         stack->raise(surface);
     }
 
+    void moved_to(ms::Surface const* surface, geom::Point const& /*top_left*/) override
+    {
+        input_index.update(surface);
+    }
+
+    void window_resized_to(ms::Surface const* surface, geom::Size const& /*window_size*/) override
+    {
+        input_index.update(surface);
+    }
+
+    void content_resized_to(ms::Surface const* surface, geom::Size const& /*content_size*/) override
+    {
+        input_index.update(surface);
+    }
+
+    void input_region_set_to(ms::Surface const* surface, std::vector<geom::Rectangle> const& region) override
+    {
+        input_index.update(surface, region);
+    }
+
 private:
     ms::SurfaceStack* stack;
+    ms::SurfaceSpatialIndex& input_index;
+    ms::ReadySurfaces& ready_surfaces;
 };
 
 }
 
+struct ms::SurfaceStack::Snapshot
+{
+    std::vector<std::vector<std::shared_ptr<Surface>>> surface_layers;
+    std::map<Surface const*,std::shared_ptr<RenderingTracker>> rendering_trackers;
+    std::vector<std::shared_ptr<graphics::Renderable>> overlays;
+};
+
 ms::SurfaceStack::SurfaceStack(
     std::shared_ptr<SceneReport> const& report) :
     report{report},
     scene_changed{false},
-    surface_observer{std::make_shared<SurfaceDepthLayerObserver>(this)}
+    surface_observer{std::make_shared<StackedSurfaceObserver>(this, input_index, ready_surfaces)}
 {
+    RecursiveWriteLock lg(guard);
+    publish_snapshot();
 }
 
 ms::SurfaceStack::~SurfaceStack() noexcept(true)
@@ -152,29 +190,31 @@ ms::SurfaceStack::~SurfaceStack() noexcept(true)
 
 mc::SceneElementSequence ms::SurfaceStack::scene_elements_for(mc::CompositorID id)
 {
-    RecursiveReadLock lg(guard);
-
+    // Clear the flag before taking the snapshot, so a change published meanwhile isn't lost
     scene_changed = false;
+
+    auto const state = snapshot();
+
     mc::SceneElementSequence elements;
-    for (auto const& layer : surface_layers)
+    elements.reserve(state->rendering_trackers.size() + state->overlays.size());
+    for (auto const& layer : state->surface_layers)
     {
         for (auto const& surface : layer)
         {
             if (surface->visible())
             {
+                // Every surface in a snapshot has its tracker published alongside it
+                auto const& tracker = state->rendering_trackers.at(surface.get());
+
                 for (auto& renderable : surface->generate_renderables(id))
                 {
                     elements.emplace_back(
-                        std::make_shared<SurfaceSceneElement>(
-                            surface->name(),
-                            renderable,
-                            rendering_trackers[surface.get()],
-                            id));
+                        std::make_shared<SurfaceSceneElement>(renderable, tracker, id));
                 }
             }
         }
     }
-    for (auto const& renderable : overlays)
+    for (auto const& renderable : state->overlays)
     {
         elements.emplace_back(std::make_shared<OverlaySceneElement>(renderable));
     }
@@ -183,28 +223,49 @@ mc::SceneElementSequence ms::SurfaceStack::scene_elements_for(mc::CompositorID i
 
 int ms::SurfaceStack::frames_pending(mc::CompositorID id) const
 {
-    RecursiveReadLock lg(guard);
-
     int result = scene_changed ? 1 : 0;
-    for (auto const& layer : surface_layers)
+
+    // Take the candidates before the snapshot: any surface that posted a frame
+    // has been published by then
+    ReadySurfaces::Surfaces candidates;
+    bool const tracked = ready_surfaces.take(id, candidates);
+
+    auto const state = snapshot();
+
+    if (!tracked)
     {
-        for (auto const& surface : layer)
+        // Not a registered compositor, so every surface is a candidate
+        for (auto const& layer : state->surface_layers)
         {
-            if (surface->visible())
-            {
-                auto const tracker = rendering_trackers.find(surface.get());
-                if (tracker != rendering_trackers.end() && tracker->second->is_exposed_in(id))
-                {
-                    // Note that we ask the surface and not a Renderable.
-                    // This is because we don't want to waste time and resources
-                    // on a snapshot till we're sure we need it...
-                    int ready = surface->buffers_ready_for_compositor(id);
-                    if (ready > result)
-                        result = ready;
-                }
-            }
+            for (auto const& surface : layer)
+                candidates.insert(surface.get());
         }
     }
+
+    ReadySurfaces::Surfaces still_ready;
+    for (auto const surface : candidates)
+    {
+        auto const tracker = state->rendering_trackers.find(surface);
+        if (tracker == state->rendering_trackers.end())
+            continue;   // No longer in the stack
+
+        // Note that we ask the surface and not a Renderable.
+        // This is because we don't want to waste time and resources
+        // on a snapshot till we're sure we need it...
+        int const ready = surface->buffers_ready_for_compositor(id);
+        if (ready <= 0)
+            continue;
+
+        // A hidden or occluded surface keeps its place until its frames are consumed
+        still_ready.insert(surface);
+
+        if (ready > result && surface->visible() && tracker->second->is_exposed_in(id))
+            result = ready;
+    }
+
+    if (tracked)
+        ready_surfaces.restore(id, still_ready);
+
     return result;
 }
 
@@ -215,6 +276,15 @@ void ms::SurfaceStack::register_compositor(mc::CompositorID cid)
     registered_compositors.insert(cid);
 
     update_rendering_tracker_compositors();
+    publish_snapshot();
+
+    ReadySurfaces::Surfaces surfaces;
+    for (auto const& layer : surface_layers)
+    {
+        for (auto const& surface : layer)
+            surfaces.insert(surface.get());
+    }
+    ready_surfaces.add_compositor(cid, surfaces);
 }
 
 void ms::SurfaceStack::unregister_compositor(mc::CompositorID cid)
@@ -222,8 +292,10 @@ void ms::SurfaceStack::unregister_compositor(mc::CompositorID cid)
     RecursiveWriteLock lg(guard);
 
     registered_compositors.erase(cid);
+    ready_surfaces.remove_compositor(cid);
 
     update_rendering_tracker_compositors();
+    publish_snapshot();
 }
 
 void ms::SurfaceStack::add_input_visualization(
@@ -232,6 +304,7 @@ void ms::SurfaceStack::add_input_visualization(
     {
         RecursiveWriteLock lg(guard);
         overlays.push_back(overlay);
+        publish_snapshot();
     }
     emit_scene_changed();
 }
@@ -248,6 +321,7 @@ void ms::SurfaceStack::remove_input_visualization(
             BOOST_THROW_EXCEPTION(std::runtime_error("Attempt to remove an overlay which was never added or which has been previously removed"));
         }
         overlays.erase(p);
+        publish_snapshot();
     }
     
     emit_scene_changed();
@@ -255,10 +329,7 @@ void ms::SurfaceStack::remove_input_visualization(
 
 void ms::SurfaceStack::emit_scene_changed()
 {
-    {
-        RecursiveWriteLock lg(guard);
-        scene_changed = true;
-    }
+    scene_changed = true;
     observers.scene_changed();
 }
 
@@ -270,6 +341,11 @@ void ms::SurfaceStack::add_surface(
         RecursiveWriteLock lg(guard);
         insert_surface_at_top_of_depth_layer(surface);
         create_rendering_tracker_for(surface);
+        input_index.add(surface);
+        input_index.restack(surface_layers);
+        publish_snapshot();
+        // The surface may have posted frames before it was added
+        ready_surfaces.posted(surface.get());
         surface->add_observer(surface_observer);
     }
     surface->set_reception_mode(input_mode);
@@ -295,6 +371,9 @@ void ms::SurfaceStack::remove_surface(std::weak_ptr<Surface> const& surface)
                 layer.erase(surface);
                 rendering_trackers.erase(keep_alive.get());
                 keep_alive->remove_observer(surface_observer);
+                input_index.remove(keep_alive.get());
+                ready_surfaces.remove(keep_alive.get());
+                publish_snapshot();
                 found_surface = true;
                 break;
             }
@@ -309,43 +388,32 @@ void ms::SurfaceStack::remove_surface(std::weak_ptr<Surface> const& surface)
     // TODO: error logging when surface not found
 }
 
-namespace
-{
-template <typename Container>
-struct InReverse {
-    Container& container;
-    auto begin() -> decltype(container.rbegin()) { return container.rbegin(); }
-    auto end() -> decltype(container.rend()) { return container.rend(); }
-};
-
-template <typename Container>
-InReverse<Container> in_reverse(Container& container) { return InReverse<Container>{container}; }
-}
-
 auto ms::SurfaceStack::surface_at(geometry::Point cursor) const
 -> std::shared_ptr<Surface>
 {
-    RecursiveReadLock lg(guard);
-    for (auto const& layer : in_reverse(surface_layers))
+    for (auto const& surface : input_index.candidates_at(cursor))
     {
-        for (auto const& surface : in_reverse(layer))
-        {
-            // TODO There's a lack of clarity about how the input area will
-            // TODO be maintained and whether this test will detect clicks on
-            // TODO decorations (it should) as these may be outside the area
-            // TODO known to the client.  But it works for now.
-            if (surface->input_area_contains(cursor))
-                    return surface;
-        }
+        // TODO There's a lack of clarity about how the input area will
+        // TODO be maintained and whether this test will detect clicks on
+        // TODO decorations (it should) as these may be outside the area
+        // TODO known to the client.  But it works for now.
+        if (surface->input_area_contains(cursor))
+            return surface;
     }
 
     return {};
 }
 
+auto ms::SurfaceStack::input_surface_at(geometry::Point point)
+-> std::shared_ptr<mi::Surface>
+{
+    return surface_at(point);
+}
+
 void ms::SurfaceStack::for_each(std::function<void(std::shared_ptr<mi::Surface> const&)> const& callback)
 {
-    RecursiveReadLock lg(guard);
-    for (auto const& layer : surface_layers)
+    auto const state = snapshot();
+    for (auto const& layer : state->surface_layers)
     {
         for (auto const& surface : layer)
         {
@@ -376,6 +444,8 @@ void ms::SurfaceStack::raise(Surface const* surface)
                 layer.erase(p);
                 insert_surface_at_top_of_depth_layer(surface_shared);
                 affected_surfaces.insert(surface_shared);
+                input_index.restack(surface_layers);
+                publish_snapshot();
                 break;
             }
         }
@@ -426,6 +496,12 @@ void ms::SurfaceStack::raise(SurfaceSet const& ss)
             if (old_layer != layer)
                 surfaces_reordered = true;
         }
+
+        if (surfaces_reordered)
+        {
+            input_index.restack(surface_layers);
+            publish_snapshot();
+        }
     }
 
     if (surfaces_reordered)
@@ -451,6 +527,19 @@ void ms::SurfaceStack::update_rendering_tracker_compositors()
         pair.second->active_compositors(registered_compositors);
 }
 
+void ms::SurfaceStack::publish_snapshot()
+{
+    auto const state = std::make_shared<Snapshot const>(
+        Snapshot{surface_layers, rendering_trackers, overlays});
+
+    std::atomic_store(&published, state);
+}
+
+auto ms::SurfaceStack::snapshot() const -> std::shared_ptr<Snapshot const>
+{
+    return std::atomic_load(&published);
+}
+
 void ms::SurfaceStack::insert_surface_at_top_of_depth_layer(std::shared_ptr<Surface> const& surface)
 {
     unsigned int depth_index = mir_depth_layer_get_index(surface->depth_layer());
@@ -489,8 +578,8 @@ auto ms::SurfaceStack::stacking_order_of(SurfaceSet const& surfaces) const -> Su
 {
     SurfaceList result;
 
-    RecursiveReadLock lk(guard);
-    for (auto const& layer : surface_layers)
+    auto const state = snapshot();
+    for (auto const& layer : state->surface_layers)
     {
         for (auto const& surface : layer)
         {
@@ -22,6 +22,9 @@
 #include "mir/shell/surface_stack.h"
 #include "mir/frontend/surface_stack.h"
 
+#include "surface_spatial_index.h"
+#include "ready_surfaces.h"
+
 #include "mir/compositor/scene.h"
 #include "mir/scene/observer.h"
 #include "mir/input/scene.h"
@@ -85,6 +88,7 @@ public:
 
     // From Scene
     void for_each(std::function<void(std::shared_ptr<input::Surface> const&)> const& callback) override;
+    auto input_surface_at(geometry::Point point) -> std::shared_ptr<input::Surface> override;
 
     virtual void remove_surface(std::weak_ptr<Surface> const& surface) override;
 
@@ -116,6 +120,14 @@ private:
     void update_rendering_tracker_compositors();
     void insert_surface_at_top_of_depth_layer(std::shared_ptr<Surface> const& surface);
 
+    /// An immutable copy of the stack, so that compositor and input threads
+    /// can read it without waiting for the shell to finish changing it
+    struct Snapshot;
+    /// Publishes the current state for readers; guard must be held for writing
+    void publish_snapshot();
+    auto snapshot() const -> std::shared_ptr<Snapshot const>;
+
+    /// Serialises changes to the stack (readers use the published snapshot)
     RecursiveReadWriteMutex mutable guard;
 
     std::shared_ptr<SceneReport> const report;
@@ -128,11 +140,19 @@ private:
      * The inner vectors contain the list of surfaces on each layer (bottom to top)
      */
     std::vector<std::vector<std::shared_ptr<Surface>>> surface_layers;
-    std::map<Surface*,std::shared_ptr<RenderingTracker>> rendering_trackers;
+    std::map<Surface const*,std::shared_ptr<RenderingTracker>> rendering_trackers;
     std::set<compositor::CompositorID> registered_compositors;
     
     std::vector<std::shared_ptr<graphics::Renderable>> overlays;
 
+    /// Only accessed through std::atomic_load() and std::atomic_store()
+    std::shared_ptr<Snapshot const> published;
+
+    /// Speeds up hit-testing; kept up to date by surface_observer
+    SurfaceSpatialIndex input_index;
+    /// Speeds up frames_pending(); kept up to date by surface_observer
+    ReadySurfaces mutable ready_surfaces;
+
     Observers observers;
     std::atomic<bool> scene_changed;
     std::shared_ptr<SurfaceObserver> surface_observer;
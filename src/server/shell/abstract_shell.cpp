@@ -472,7 +472,7 @@ void msh::AbstractShell::notify_focus_locked(
 
             // Ensure the surface has really taken the focus before notifying it that it is focused
             input_targeter->set_focus(surface);
-            surface->consume(seat->create_device_state().get());
+            surface->consume(seat->create_device_state());
             surface->add_observer(focus_surface_observer);
 
             for (auto const& item : new_focus_tree)
@@ -85,10 +85,11 @@ public:
     MOCK_METHOD2(renamed, void(msc::Surface const*, char const* name));
     MOCK_METHOD1(cursor_image_removed, void(msc::Surface const*));
     MOCK_METHOD2(placed_relative, void(msc::Surface const*, geom::Rectangle const& placement));
-    MOCK_METHOD2(input_consumed, void(msc::Surface const*, MirEvent const*));
+    MOCK_METHOD2(input_consumed, void(msc::Surface const*, std::shared_ptr<MirEvent const> const&));
     MOCK_METHOD2(start_drag_and_drop, void(msc::Surface const*, std::vector<uint8_t> const& handle));
     MOCK_METHOD2(depth_layer_set_to, void(msc::Surface const*, MirDepthLayer depth_layer));
     MOCK_METHOD2(application_id_set_to, void(msc::Surface const*, std::string const& application_id));
+    MOCK_METHOD2(input_region_set_to, void(msc::Surface const*, std::vector<geom::Rectangle> const& region));
 };
 
 
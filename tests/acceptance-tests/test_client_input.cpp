@@ -739,7 +739,7 @@ TEST_F(TestClientInput, send_mir_input_events_through_surface)
     auto key_event = mir::events::make_event(MirInputDeviceId{0}, 0ns, std::vector<uint8_t>{}, mir_keyboard_action_down, 0, KEY_M,
                                              mir_input_event_modifier_none);
 
-    server.the_shell()->focused_surface()->consume(key_event.get());
+    server.the_shell()->focused_surface()->consume(std::move(key_event));
 
     first_client.all_events_received.wait_for(2s);
 }
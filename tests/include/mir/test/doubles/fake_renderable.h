@@ -95,9 +95,14 @@ public:
         return rect;
     }
     
+    void set_clip_area(geometry::Rectangle const& area)
+    {
+        clip = area;
+    }
+
     std::experimental::optional<geometry::Rectangle> clip_area() const override
     {
-        return std::experimental::optional<geometry::Rectangle>();
+        return clip;
     }
 
     unsigned int swap_interval() const override
@@ -105,11 +110,23 @@ public:
         return 1u;
     }
 
+    void set_opaque_region(geometry::Rectangles const& region)
+    {
+        opaque = region;
+    }
+
+    geometry::Rectangles opaque_region() const override
+    {
+        return opaque;
+    }
+
 private:
     std::shared_ptr<graphics::Buffer> buf;
     mir::geometry::Rectangle rect;
     float opacity;
     bool rectangular;
+    geometry::Rectangles opaque;
+    std::experimental::optional<geometry::Rectangle> clip;
 };
 
 } // namespace doubles
@@ -38,6 +38,7 @@ struct MockGLBuffer : public MockBuffer,
     MOCK_METHOD0(gl_bind_to_texture, void());
     MOCK_METHOD0(secure_for_render, void());
     MOCK_METHOD0(bind, void());
+    MOCK_METHOD1(bind_damaged, void(geometry::Rectangles const&));
 };
 
 }
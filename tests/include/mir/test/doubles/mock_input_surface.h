@@ -38,7 +38,7 @@ public:
     MOCK_CONST_METHOD1(input_area_contains, bool(geometry::Point const&));
     MOCK_CONST_METHOD0(cursor_image, std::shared_ptr<graphics::CursorImage>());
     MOCK_CONST_METHOD0(reception_mode, input::InputReceptionMode());
-    MOCK_METHOD1(consume, void(MirEvent const*));
+    MOCK_METHOD1(consume, void(std::shared_ptr<MirEvent const> const&));
 };
 
 }
@@ -56,6 +56,9 @@ struct MockRenderable : public graphics::Renderable
     MOCK_CONST_METHOD0(visible, bool());
     MOCK_CONST_METHOD0(shaped, bool());
     MOCK_CONST_METHOD0(swap_interval, unsigned int());
+    MOCK_CONST_METHOD1(buffer_damage_since,
+        std::experimental::optional<geometry::Rectangles>(graphics::BufferID));
+    MOCK_CONST_METHOD0(opaque_region, geometry::Rectangles());
 };
 }
 }
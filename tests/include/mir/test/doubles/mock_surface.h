@@ -64,7 +64,7 @@ struct MockSurface : public scene::BasicSurface
     MOCK_METHOD2(configure, int(MirWindowAttrib, int));
     MOCK_METHOD1(add_observer, void(std::shared_ptr<scene::SurfaceObserver> const&));
     MOCK_METHOD1(remove_observer, void(std::weak_ptr<scene::SurfaceObserver> const&));
-    MOCK_METHOD1(consume, void(MirEvent const*));
+    MOCK_METHOD1(consume, void(std::shared_ptr<MirEvent const> const&));
 
     MOCK_CONST_METHOD0(primary_buffer_stream, std::shared_ptr<frontend::BufferStream>());
     MOCK_METHOD1(set_streams, void(std::list<scene::StreamInfo> const&));
@@ -63,19 +63,36 @@ public:
     void drop_old_buffers() override {}
     void submit_buffer(std::shared_ptr<graphics::Buffer> const& b) override
     {
-        if (b) ++nready;
+        if (b)
+        {
+            ++nready;
+            frame_posted_callback(b->size());
+        }
+    }
+    void submit_buffer(std::shared_ptr<graphics::Buffer> const& b, geometry::Rectangles const&) override
+    {
+        submit_buffer(b);
     }
     void with_most_recent_buffer_do(std::function<void(graphics::Buffer&)> const& fn) override
     {
         fn(*stub_compositor_buffer);
     }
     MirPixelFormat pixel_format() const override { return mir_pixel_format_abgr_8888; }
-    void set_frame_posted_callback(std::function<void(geometry::Size const&)> const&) override {}
+    void set_frame_posted_callback(std::function<void(geometry::Size const&)> const& callback) override
+    {
+        frame_posted_callback = callback;
+    }
     bool has_submitted_buffer() const override { return true; }
     void set_scale(float) override {}
+    std::experimental::optional<geometry::Rectangles>
+        buffer_damage(graphics::BufferID, graphics::BufferID) const override
+    {
+        return {};
+    }
 
     std::shared_ptr<graphics::Buffer> stub_compositor_buffer;
     int nready = 0;
+    std::function<void(geometry::Size const&)> frame_posted_callback = [](auto){};
 };
 
 }
@@ -37,7 +37,7 @@ struct StubInputSurface : public mir::input::Surface
     }
 
     mir::input::InputReceptionMode reception_mode() const { return mir::input::InputReceptionMode::normal; }
-    void consume(MirEvent const&) override  {}
+    void consume(std::shared_ptr<MirEvent const> const&) override  {}
     std::string name() const { return {}; }
     mir::geometry::Rectangle input_bounds() const override { return {{},{}}; }
     bool input_area_contains(mir::geometry::Point const&) const { return false; }
@@ -341,6 +341,12 @@ void glBufferData(GLenum target, GLsizeiptr size, const GLvoid *data, GLenum usa
     global_mock_gl->glBufferData(target, size, data, usage);
 }
 
+void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid *data)
+{
+    CHECK_GLOBAL_VOID_MOCK();
+    global_mock_gl->glBufferSubData(target, offset, size, data);
+}
+
 void glGetProgramiv(GLuint program, GLenum pname, GLint *params)
 {
     CHECK_GLOBAL_VOID_MOCK();
@@ -361,6 +367,14 @@ void glTexImage2D(GLenum target, GLint level, GLint internalformat,
     global_mock_gl->glTexImage2D(target, level, internalformat, width, height, border, format, type, pixels);
 }
 
+void glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset,
+                     GLsizei width, GLsizei height,
+                     GLenum format, GLenum type, const GLvoid* pixels)
+{
+    CHECK_GLOBAL_VOID_MOCK();
+    global_mock_gl->glTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels);
+}
+
 void glGenFramebuffers(GLsizei n, GLuint *framebuffers)
 {
     CHECK_GLOBAL_VOID_MOCK();
@@ -453,6 +467,12 @@ void glFinish()
     global_mock_gl->glFinish();
 }
 
+void glFlush()
+{
+    CHECK_GLOBAL_VOID_MOCK();
+    global_mock_gl->glFlush();
+}
+
 void glGenerateMipmap(GLenum target)
 {
     CHECK_GLOBAL_VOID_MOCK();
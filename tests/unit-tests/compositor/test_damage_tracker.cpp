@@ -0,0 +1,150 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/compositor/damage_tracker.h"
+#include "mir/test/doubles/fake_renderable.h"
+#include "mir/test/doubles/stub_buffer.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace testing;
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+namespace mtd = mir::test::doubles;
+namespace geom = mir::geometry;
+
+namespace
+{
+struct MutableRenderable : mtd::FakeRenderable
+{
+    MutableRenderable(int x, int y, int width, int height)
+        : FakeRenderable{x, y, width, height},
+          position{{x, y}, {width, height}}
+    {
+    }
+
+    geom::Rectangle screen_position() const override
+    {
+        return position;
+    }
+
+    std::experimental::optional<geom::Rectangles> buffer_damage_since(mg::BufferID) const override
+    {
+        return damage;
+    }
+
+    geom::Rectangle position;
+    std::experimental::optional<geom::Rectangles> damage;
+};
+
+struct DamageTracker : Test
+{
+    geom::Rectangle const view_area{{0, 0}, {1920, 1080}};
+    mc::DamageTracker tracker;
+};
+}
+
+TEST_F(DamageTracker, first_frame_damages_whole_view_area)
+{
+    auto const window = std::make_shared<mtd::FakeRenderable>(10, 10, 100, 100);
+
+    EXPECT_THAT(tracker.damage_for({window}, view_area), Eq(geom::Rectangles{view_area}));
+}
+
+TEST_F(DamageTracker, change_of_view_area_damages_whole_view_area)
+{
+    auto const window = std::make_shared<mtd::FakeRenderable>(10, 10, 100, 100);
+    geom::Rectangle const new_view_area{{0, 0}, {1280, 1024}};
+    tracker.damage_for({window}, view_area);
+
+    EXPECT_THAT(tracker.damage_for({window}, new_view_area), Eq(geom::Rectangles{new_view_area}));
+}
+
+TEST_F(DamageTracker, unchanged_renderables_cause_no_damage)
+{
+    auto const window = std::make_shared<mtd::FakeRenderable>(10, 10, 100, 100);
+    tracker.damage_for({window}, view_area);
+
+    EXPECT_THAT(tracker.damage_for({window}, view_area), Eq(geom::Rectangles{}));
+}
+
+TEST_F(DamageTracker, new_renderable_damages_its_visible_area)
+{
+    auto const window = std::make_shared<mtd::FakeRenderable>(10, 10, 100, 100);
+    auto const partly_offscreen = std::make_shared<mtd::FakeRenderable>(-50, 20, 100, 100);
+    tracker.damage_for({window}, view_area);
+
+    EXPECT_THAT(
+        tracker.damage_for({window, partly_offscreen}, view_area),
+        Eq(geom::Rectangles{{{0, 20}, {50, 100}}}));
+}
+
+TEST_F(DamageTracker, removed_renderable_damages_where_it_was)
+{
+    auto const window = std::make_shared<mtd::FakeRenderable>(10, 10, 100, 100);
+    auto const other = std::make_shared<mtd::FakeRenderable>(200, 200, 50, 50);
+    tracker.damage_for({window, other}, view_area);
+
+    EXPECT_THAT(tracker.damage_for({window}, view_area), Eq(geom::Rectangles{{{200, 200}, {50, 50}}}));
+}
+
+TEST_F(DamageTracker, moved_renderable_damages_old_and_new_positions)
+{
+    auto const window = std::make_shared<MutableRenderable>(10, 10, 100, 100);
+    tracker.damage_for({window}, view_area);
+
+    window->position.top_left = {20, 10};
+
+    EXPECT_THAT(
+        tracker.damage_for({window}, view_area),
+        Eq(geom::Rectangles{{{10, 10}, {100, 100}}, {{20, 10}, {100, 100}}}));
+}
+
+TEST_F(DamageTracker, restacking_damages_restacked_renderables)
+{
+    auto const bottom = std::make_shared<mtd::FakeRenderable>(10, 10, 100, 100);
+    auto const top = std::make_shared<mtd::FakeRenderable>(50, 50, 100, 100);
+    tracker.damage_for({bottom, top}, view_area);
+
+    auto const damage = tracker.damage_for({top, bottom}, view_area);
+
+    EXPECT_THAT(damage.bounding_rectangle(), Eq(geom::Rectangle{{10, 10}, {140, 140}}));
+}
+
+TEST_F(DamageTracker, new_buffer_only_damages_the_damaged_part_of_the_buffer)
+{
+    auto const window = std::make_shared<MutableRenderable>(10, 10, 100, 100);
+    window->set_buffer(std::make_shared<mtd::StubBuffer>(geom::Size{100, 100}));
+    tracker.damage_for({window}, view_area);
+
+    window->set_buffer(std::make_shared<mtd::StubBuffer>(geom::Size{100, 100}));
+    window->damage = geom::Rectangles{{{5, 5}, {10, 2}}};
+
+    EXPECT_THAT(tracker.damage_for({window}, view_area), Eq(geom::Rectangles{{{15, 15}, {10, 2}}}));
+}
+
+TEST_F(DamageTracker, new_buffer_without_damage_information_damages_whole_renderable)
+{
+    auto const window = std::make_shared<MutableRenderable>(10, 10, 100, 100);
+    window->set_buffer(std::make_shared<mtd::StubBuffer>(geom::Size{100, 100}));
+    tracker.damage_for({window}, view_area);
+
+    window->set_buffer(std::make_shared<mtd::StubBuffer>(geom::Size{100, 100}));
+    window->damage = std::experimental::nullopt;
+
+    EXPECT_THAT(tracker.damage_for({window}, view_area), Eq(geom::Rectangles{{{10, 10}, {100, 100}}}));
+}
@@ -22,6 +22,7 @@
 #include "mir/compositor/scene.h"
 #include "mir/renderer/renderer.h"
 #include "mir/geometry/rectangle.h"
+#include "mir/geometry/rectangles.h"
 #include "mir/test/doubles/mock_renderer.h"
 #include "mir/test/fake_shared.h"
 #include "mir/test/gmock_fixes.h"
@@ -210,6 +211,65 @@ TEST_F(DefaultDisplayBufferCompositor, calls_renderer_in_sequence)
     }));
 }
 
+TEST_F(DefaultDisplayBufferCompositor, damages_only_what_changed_since_the_previous_frame)
+{
+    using namespace testing;
+    auto const left = std::make_shared<mtd::FakeRenderable>(geom::Rectangle{{0, 0}, {10, 10}});
+    auto const right = std::make_shared<mtd::FakeRenderable>(geom::Rectangle{{100, 0}, {10, 10}});
+
+    Sequence render_seq;
+    EXPECT_CALL(mock_renderer, set_damage(Eq(geom::Rectangles{screen})))
+        .InSequence(render_seq);
+    EXPECT_CALL(mock_renderer, render(_))
+        .InSequence(render_seq);
+    EXPECT_CALL(mock_renderer, set_damage(Eq(geom::Rectangles{})))
+        .InSequence(render_seq);
+    EXPECT_CALL(mock_renderer, render(_))
+        .InSequence(render_seq);
+    EXPECT_CALL(mock_renderer, set_damage(Eq(geom::Rectangles{right->screen_position()})))
+        .InSequence(render_seq);
+    EXPECT_CALL(mock_renderer, render(_))
+        .InSequence(render_seq);
+
+    mc::DefaultDisplayBufferCompositor compositor(
+        display_buffer,
+        mt::fake_shared(mock_renderer),
+        mr::null_compositor_report());
+
+    compositor.composite(make_scene_elements({left, right}));
+    compositor.composite(make_scene_elements({left, right}));
+    compositor.composite(make_scene_elements({left}));
+}
+
+TEST_F(DefaultDisplayBufferCompositor, damage_spans_overlay_frames_since_the_previous_rendered_frame)
+{
+    using namespace testing;
+    auto const left = std::make_shared<mtd::FakeRenderable>(geom::Rectangle{{0, 0}, {10, 10}});
+    auto const right = std::make_shared<mtd::FakeRenderable>(geom::Rectangle{{100, 0}, {10, 10}});
+
+    EXPECT_CALL(display_buffer, overlay(_))
+        .WillOnce(Return(false))
+        .WillOnce(Return(true))
+        .WillOnce(Return(false));
+
+    Sequence render_seq;
+    EXPECT_CALL(mock_renderer, set_damage(Eq(geom::Rectangles{screen})))
+        .InSequence(render_seq);
+    EXPECT_CALL(mock_renderer, suspend())
+        .InSequence(render_seq);
+    EXPECT_CALL(mock_renderer, set_damage(Eq(geom::Rectangles{right->screen_position()})))
+        .InSequence(render_seq);
+
+    mc::DefaultDisplayBufferCompositor compositor(
+        display_buffer,
+        mt::fake_shared(mock_renderer),
+        mr::null_compositor_report());
+
+    compositor.composite(make_scene_elements({left, right}));
+    compositor.composite(make_scene_elements({left}));
+    compositor.composite(make_scene_elements({left}));
+}
+
 TEST_F(DefaultDisplayBufferCompositor, rotates_viewport)
 {   // Regression test for LP: #1643488
     using namespace testing;
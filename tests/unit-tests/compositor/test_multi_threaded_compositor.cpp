@@ -662,6 +662,60 @@ TEST(MultiThreadedCompositor, recommended_sleep_throttles_compositor_loop)
     compositor.stop();
 }
 
+namespace
+{
+class DisplayRecordingFramePacing : public mtd::NullDisplay
+{
+public:
+    void for_each_display_sync_group(std::function<void(mg::DisplaySyncGroup&)> const& f) override
+    {
+        f(recording_group);
+    }
+
+    auto calls() -> std::vector<std::string>
+    {
+        std::lock_guard<std::mutex> lock{recording_group.mutex};
+        return recording_group.calls;
+    }
+
+private:
+    struct RecordingDisplaySyncGroup : mtd::NullDisplaySyncGroup
+    {
+        void begin_frame() override { record("begin_frame"); }
+        void post() override { record("post"); }
+        void wait_for_frame_deadline() override { record("wait_for_frame_deadline"); }
+
+        void record(std::string const& call)
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            calls.push_back(call);
+        }
+
+        std::mutex mutex;
+        std::vector<std::string> calls;
+    } recording_group;
+};
+}
+
+TEST(MultiThreadedCompositor, each_frame_begins_before_compositing_and_waits_for_its_deadline_after_posting)
+{
+    using namespace testing;
+
+    auto display = std::make_shared<DisplayRecordingFramePacing>();
+    auto scene = std::make_shared<StubScene>();
+    auto db_compositor_factory = std::make_shared<RecordingDisplayBufferCompositorFactory>();
+    mc::MultiThreadedCompositor compositor{display, scene, db_compositor_factory, null_display_listener, null_report, default_delay, true};
+
+    compositor.start();
+
+    while (!db_compositor_factory->check_record_count_for_each_buffer(1, composites_per_update))
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    compositor.stop();
+
+    EXPECT_THAT(display->calls(), ElementsAre("begin_frame", "post", "wait_for_frame_deadline"));
+}
+
 TEST(MultiThreadedCompositor, when_no_initial_composite_is_needed_there_is_none)
 {
     using namespace testing;
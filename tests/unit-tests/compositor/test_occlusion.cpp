@@ -202,3 +202,56 @@ TEST_F(OcclusionFilterTest,
     EXPECT_THAT(renderables_from(occlusions), ElementsAre(partially_onscreen));
     EXPECT_THAT(renderables_from(elements), ElementsAre(covering));
 }
+
+TEST_F(OcclusionFilterTest, window_covered_by_union_of_windows_occluded)
+{
+    auto const left = std::make_shared<mtd::FakeRenderable>(0, 0, 50, 100);
+    auto const right = std::make_shared<mtd::FakeRenderable>(50, 0, 50, 100);
+    auto const bottom = std::make_shared<mtd::FakeRenderable>(10, 10, 80, 80);
+    auto elements = scene_elements_from({bottom, left, right});
+
+    auto const& occlusions = filter_occlusions_from(elements, monitor_rect);
+
+    EXPECT_THAT(renderables_from(occlusions), ElementsAre(bottom));
+    EXPECT_THAT(renderables_from(elements), ElementsAre(left, right));
+}
+
+TEST_F(OcclusionFilterTest, window_partly_uncovered_by_union_of_windows_not_occluded)
+{
+    auto const left = std::make_shared<mtd::FakeRenderable>(0, 0, 50, 100);
+    auto const right = std::make_shared<mtd::FakeRenderable>(51, 0, 50, 100);
+    auto const bottom = std::make_shared<mtd::FakeRenderable>(10, 10, 80, 80);
+    auto elements = scene_elements_from({bottom, left, right});
+
+    auto const& occlusions = filter_occlusions_from(elements, monitor_rect);
+
+    EXPECT_THAT(renderables_from(occlusions), IsEmpty());
+    EXPECT_THAT(renderables_from(elements), ElementsAre(bottom, left, right));
+}
+
+TEST_F(OcclusionFilterTest, shaped_window_occludes_what_its_opaque_region_covers)
+{
+    auto const top = std::make_shared<mtd::FakeRenderable>(Rectangle{{0, 0}, {100, 100}}, 1.0f, false);
+    top->set_opaque_region({Rectangle{{5, 5}, {90, 90}}});
+    auto const covered = std::make_shared<mtd::FakeRenderable>(10, 10, 50, 50);
+    auto const under_edge = std::make_shared<mtd::FakeRenderable>(0, 0, 50, 50);
+    auto elements = scene_elements_from({under_edge, covered, top});
+
+    auto const& occlusions = filter_occlusions_from(elements, monitor_rect);
+
+    EXPECT_THAT(renderables_from(occlusions), ElementsAre(covered));
+    EXPECT_THAT(renderables_from(elements), ElementsAre(under_edge, top));
+}
+
+TEST_F(OcclusionFilterTest, translucent_window_with_opaque_region_occludes_nothing)
+{
+    auto const top = std::make_shared<mtd::FakeRenderable>(Rectangle{{0, 0}, {100, 100}}, 0.5f, false);
+    top->set_opaque_region({Rectangle{{0, 0}, {100, 100}}});
+    auto const bottom = std::make_shared<mtd::FakeRenderable>(10, 10, 50, 50);
+    auto elements = scene_elements_from({bottom, top});
+
+    auto const& occlusions = filter_occlusions_from(elements, monitor_rect);
+
+    EXPECT_THAT(renderables_from(occlusions), IsEmpty());
+    EXPECT_THAT(renderables_from(elements), ElementsAre(bottom, top));
+}
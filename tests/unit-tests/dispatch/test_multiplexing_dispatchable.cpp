@@ -490,3 +490,82 @@ TEST(MultiplexingDispatchableTest, automatic_removals_are_threadsafe)
     
     dispatchee->trigger();
 }
+
+TEST(MultiplexingDispatchableTest, batched_dispatch_services_all_ready_dispatchees)
+{
+    int dispatch_count{0};
+    auto dispatchee_a = std::make_shared<mt::TestDispatchable>([&dispatch_count]() { ++dispatch_count; });
+    auto dispatchee_b = std::make_shared<mt::TestDispatchable>([&dispatch_count]() { ++dispatch_count; });
+    auto dispatchee_c = std::make_shared<mt::TestDispatchable>([&dispatch_count]() { ++dispatch_count; });
+
+    md::MultiplexingDispatchable dispatcher{dispatchee_a, dispatchee_b, dispatchee_c};
+    dispatcher.set_max_events_per_dispatch(16);
+
+    dispatchee_a->trigger();
+    dispatchee_b->trigger();
+    dispatchee_c->trigger();
+
+    ASSERT_TRUE(mt::fd_is_readable(dispatcher.watch_fd()));
+    dispatcher.dispatch(md::FdEvent::readable);
+
+    EXPECT_EQ(3, dispatch_count);
+    EXPECT_FALSE(mt::fd_is_readable(dispatcher.watch_fd()));
+}
+
+TEST(MultiplexingDispatchableTest, batched_dispatch_rearms_sequential_dispatchees)
+{
+    int dispatch_count{0};
+    auto dispatchee_a = std::make_shared<mt::TestDispatchable>([&dispatch_count]() { ++dispatch_count; });
+    auto dispatchee_b = std::make_shared<mt::TestDispatchable>([&dispatch_count]() { ++dispatch_count; });
+
+    md::MultiplexingDispatchable dispatcher{dispatchee_a, dispatchee_b};
+    dispatcher.set_max_events_per_dispatch(16);
+
+    dispatchee_a->trigger();
+    dispatchee_a->trigger();
+    dispatchee_b->trigger();
+    dispatchee_b->trigger();
+
+    ASSERT_TRUE(mt::fd_is_readable(dispatcher.watch_fd()));
+    dispatcher.dispatch(md::FdEvent::readable);
+    EXPECT_EQ(2, dispatch_count);
+
+    ASSERT_TRUE(mt::fd_is_readable(dispatcher.watch_fd()));
+    dispatcher.dispatch(md::FdEvent::readable);
+    EXPECT_EQ(4, dispatch_count);
+
+    EXPECT_FALSE(mt::fd_is_readable(dispatcher.watch_fd()));
+}
+
+TEST(MultiplexingDispatchableTest, batched_dispatch_skips_dispatchees_removed_earlier_in_the_batch)
+{
+    md::MultiplexingDispatchable dispatcher;
+    dispatcher.set_max_events_per_dispatch(16);
+
+    int dispatch_count{0};
+    std::vector<std::shared_ptr<mt::TestDispatchable>> dispatchees;
+    for (int i = 0; i != 3; ++i)
+    {
+        dispatchees.push_back(std::make_shared<mt::TestDispatchable>(
+            [&, i]()
+            {
+                ++dispatch_count;
+                for (int j = 0; j != 3; ++j)
+                {
+                    if (j != i)
+                        dispatcher.remove_watch(dispatchees[j]);
+                }
+            }));
+    }
+
+    for (auto const& dispatchee : dispatchees)
+    {
+        dispatcher.add_watch(dispatchee);
+        dispatchee->trigger();
+    }
+
+    ASSERT_TRUE(mt::fd_is_readable(dispatcher.watch_fd()));
+    dispatcher.dispatch(md::FdEvent::readable);
+
+    EXPECT_EQ(1, dispatch_count);
+}
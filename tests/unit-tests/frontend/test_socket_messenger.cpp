@@ -0,0 +1,132 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/frontend/socket_messenger.h"
+
+#include <boost/asio.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <string>
+#include <vector>
+
+namespace mfd = mir::frontend::detail;
+namespace ba = boost::asio;
+
+using namespace testing;
+
+namespace
+{
+struct SocketMessenger : Test
+{
+    SocketMessenger()
+    {
+        ba::local::connect_pair(*server_socket, client_socket);
+        // Keep the send buffer small so tests can fill it quickly
+        server_socket->set_option(ba::socket_base::send_buffer_size{4096});
+    }
+
+    auto make_messenger(size_t max_outbound_bytes = mfd::SocketMessenger::default_max_outbound_bytes)
+        -> std::shared_ptr<mfd::SocketMessenger>
+    {
+        auto const messenger = std::make_shared<mfd::SocketMessenger>(server_socket, max_outbound_bytes);
+        // The messenger sets its own send buffer size
+        server_socket->set_option(ba::socket_base::send_buffer_size{4096});
+        return messenger;
+    }
+
+    /// Reads a whole message, letting the messenger flush its queue while waiting
+    auto receive_message() -> std::string
+    {
+        unsigned char header[2];
+        read_from_client(header, sizeof(header));
+        std::string body(header[0] << 8 | header[1], '\0');
+        read_from_client(body.data(), body.size());
+        return body;
+    }
+
+    void read_from_client(void* buffer, size_t size)
+    {
+        auto const data = static_cast<char*>(buffer);
+        size_t received{0};
+        while (received < size)
+        {
+            io_service.poll();
+            io_service.reset();
+
+            boost::system::error_code error;
+            auto const available = client_socket.available(error);
+            ASSERT_FALSE(error);
+            if (available > 0)
+                received += client_socket.read_some(ba::buffer(data + received, size - received));
+        }
+    }
+
+    ba::io_service io_service;
+    std::shared_ptr<ba::local::stream_protocol::socket> const server_socket{
+        std::make_shared<ba::local::stream_protocol::socket>(io_service)};
+    ba::local::stream_protocol::socket client_socket{io_service};
+};
+}
+
+TEST_F(SocketMessenger, messages_are_received_in_order)
+{
+    auto const messenger = make_messenger();
+
+    messenger->send("first", 5, {});
+    messenger->send("second", 6, {});
+
+    EXPECT_THAT(receive_message(), Eq("first"));
+    EXPECT_THAT(receive_message(), Eq("second"));
+}
+
+TEST_F(SocketMessenger, send_does_not_block_when_client_is_not_reading)
+{
+    auto const messenger = make_messenger();
+    std::vector<std::string> sent;
+
+    // Many times the size of the socket buffer
+    for (auto i = 0; i != 256; ++i)
+    {
+        sent.push_back(std::to_string(i) + std::string(1000, 'x'));
+        messenger->send(sent.back().data(), sent.back().size(), {});
+    }
+
+    for (auto const& message : sent)
+        ASSERT_THAT(receive_message(), Eq(message));
+}
+
+TEST_F(SocketMessenger, client_that_stops_reading_is_disconnected)
+{
+    auto const messenger = make_messenger(64 * 1024);
+    std::string const message(1000, 'x');
+
+    EXPECT_THROW(
+        {
+            for (auto i = 0; i != 1024; ++i)
+                messenger->send(message.data(), message.size(), {});
+        },
+        std::runtime_error);
+
+    // Whatever was already in the socket can still be read, then the connection is closed
+    std::vector<char> buffer(64 * 1024);
+    boost::system::error_code error;
+    while (!error)
+        client_socket.read_some(ba::buffer(buffer), error);
+
+    EXPECT_THAT(error, Eq(ba::error::eof));
+}
@@ -0,0 +1,292 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/gl/recently_used_cache.h"
+
+#include "mir/test/doubles/mock_egl.h"
+#include "mir/test/doubles/mock_gl.h"
+#include "mir/test/doubles/mock_gl_buffer.h"
+#include "mir/test/doubles/mock_renderable.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace mg = mir::graphics;
+namespace mgl = mir::gl;
+namespace mtd = mir::test::doubles;
+namespace geom = mir::geometry;
+using namespace testing;
+
+namespace
+{
+struct RecentlyUsedCache : Test
+{
+    RecentlyUsedCache()
+    {
+        ON_CALL(renderable, id()).WillByDefault(Return(&renderable));
+        ON_CALL(*first_buffer, id()).WillByDefault(Return(mg::BufferID{1}));
+        ON_CALL(*second_buffer, id()).WillByDefault(Return(mg::BufferID{2}));
+        ON_CALL(mock_egl, eglCreateSyncKHR(_, EGL_SYNC_FENCE_KHR, _))
+            .WillByDefault(Invoke([this](auto, auto, auto) { return fake_fence(++fences_created); }));
+    }
+
+    static auto fake_fence(intptr_t n) -> EGLSyncKHR
+    {
+        return reinterpret_cast<EGLSyncKHR>(n);
+    }
+
+    auto make_buffer(geom::Size size) -> std::shared_ptr<mtd::MockGLBuffer>
+    {
+        return std::make_shared<NiceMock<mtd::MockGLBuffer>>(
+            size, geom::Stride{size.width.as_int() * 4}, mir_pixel_format_argb_8888);
+    }
+
+    NiceMock<mtd::MockEGL> mock_egl;
+    NiceMock<mtd::MockGL> mock_gl;
+    intptr_t fences_created{0};
+    NiceMock<mtd::MockRenderable> renderable;
+    geom::Size const size{640, 480};
+    std::shared_ptr<mtd::MockGLBuffer> const first_buffer{make_buffer(size)};
+    std::shared_ptr<mtd::MockGLBuffer> const second_buffer{make_buffer(size)};
+    geom::Rectangles const damage{{{10, 10}, {20, 20}}};
+
+    mgl::RecentlyUsedCache cache;
+
+    // The caches of two outputs whose renderers share textures
+    std::shared_ptr<mgl::RecentlyUsedTextures> const shared_textures{std::make_shared<mgl::RecentlyUsedTextures>()};
+    mgl::RecentlyUsedCache first_output{shared_textures};
+    mgl::RecentlyUsedCache second_output{shared_textures};
+};
+}
+
+TEST_F(RecentlyUsedCache, uploads_only_damage_when_buffer_changes)
+{
+    ON_CALL(renderable, buffer_damage_since(mg::BufferID{1})).WillByDefault(Return(damage));
+
+    EXPECT_CALL(renderable, buffer()).WillOnce(Return(first_buffer)).WillOnce(Return(second_buffer));
+    EXPECT_CALL(*first_buffer, bind());
+    EXPECT_CALL(*second_buffer, bind()).Times(0);
+    EXPECT_CALL(*second_buffer, bind_damaged(damage));
+
+    auto const first_texture = cache.load(renderable);
+    auto const second_texture = cache.load(renderable);
+
+    EXPECT_THAT(second_texture, Eq(first_texture));
+}
+
+TEST_F(RecentlyUsedCache, does_not_upload_unchanged_buffer)
+{
+    EXPECT_CALL(renderable, buffer()).WillRepeatedly(Return(first_buffer));
+    EXPECT_CALL(*first_buffer, bind());
+    EXPECT_CALL(*first_buffer, bind_damaged(_)).Times(0);
+
+    cache.load(renderable);
+    cache.load(renderable);
+}
+
+TEST_F(RecentlyUsedCache, uploads_everything_when_damage_is_unknown)
+{
+    ON_CALL(renderable, buffer_damage_since(_)).WillByDefault(Return(std::experimental::nullopt));
+
+    EXPECT_CALL(renderable, buffer()).WillOnce(Return(first_buffer)).WillOnce(Return(second_buffer));
+    EXPECT_CALL(*second_buffer, bind());
+    EXPECT_CALL(*second_buffer, bind_damaged(_)).Times(0);
+
+    cache.load(renderable);
+    cache.load(renderable);
+}
+
+TEST_F(RecentlyUsedCache, uploads_everything_when_buffer_size_changes)
+{
+    auto const resized_buffer = make_buffer({800, 600});
+    ON_CALL(*resized_buffer, id()).WillByDefault(Return(mg::BufferID{2}));
+    ON_CALL(renderable, buffer_damage_since(mg::BufferID{1})).WillByDefault(Return(damage));
+
+    EXPECT_CALL(renderable, buffer()).WillOnce(Return(first_buffer)).WillOnce(Return(resized_buffer));
+    EXPECT_CALL(*resized_buffer, bind());
+    EXPECT_CALL(*resized_buffer, bind_damaged(_)).Times(0);
+
+    cache.load(renderable);
+    cache.load(renderable);
+}
+
+TEST_F(RecentlyUsedCache, uploads_everything_after_invalidation)
+{
+    ON_CALL(renderable, buffer_damage_since(mg::BufferID{1})).WillByDefault(Return(damage));
+
+    EXPECT_CALL(renderable, buffer()).WillOnce(Return(first_buffer)).WillOnce(Return(second_buffer));
+    EXPECT_CALL(*second_buffer, bind());
+    EXPECT_CALL(*second_buffer, bind_damaged(_)).Times(0);
+
+    cache.load(renderable);
+    cache.invalidate();
+    cache.load(renderable);
+}
+
+TEST_F(RecentlyUsedCache, texture_outlives_its_buffer_until_drop_unused)
+{
+    EXPECT_CALL(renderable, buffer()).WillOnce(Return(first_buffer));
+    EXPECT_CALL(mock_gl, glDeleteTextures(_, _)).Times(0);
+
+    cache.load(renderable);
+    cache.drop_unused();
+    Mock::VerifyAndClearExpectations(&mock_gl);
+
+    // Unused since the last drop, so deleted now (when there is a current context)
+    EXPECT_CALL(mock_gl, glDeleteTextures(1, _));
+    cache.drop_unused();
+}
+
+TEST_F(RecentlyUsedCache, buffer_shown_on_several_outputs_is_uploaded_once)
+{
+    EXPECT_CALL(renderable, buffer()).WillRepeatedly(Return(first_buffer));
+    EXPECT_CALL(*first_buffer, bind());
+    EXPECT_CALL(*first_buffer, bind_damaged(_)).Times(0);
+
+    auto const first_texture = first_output.load(renderable);
+    auto const second_texture = second_output.load(renderable);
+
+    EXPECT_THAT(second_texture, Eq(first_texture));
+}
+
+TEST_F(RecentlyUsedCache, damage_uploaded_for_one_output_is_not_uploaded_again_for_another)
+{
+    ON_CALL(renderable, buffer_damage_since(mg::BufferID{1})).WillByDefault(Return(damage));
+
+    EXPECT_CALL(renderable, buffer())
+        .WillOnce(Return(first_buffer)).WillOnce(Return(first_buffer))
+        .WillOnce(Return(second_buffer)).WillOnce(Return(second_buffer));
+    EXPECT_CALL(*first_buffer, bind());
+    EXPECT_CALL(*second_buffer, bind()).Times(0);
+    EXPECT_CALL(*second_buffer, bind_damaged(damage));
+
+    first_output.load(renderable);
+    second_output.load(renderable);
+    first_output.drop_unused();
+    second_output.drop_unused();
+
+    first_output.load(renderable);
+    second_output.load(renderable);
+}
+
+TEST_F(RecentlyUsedCache, shared_texture_is_kept_while_any_output_uses_it)
+{
+    EXPECT_CALL(renderable, buffer()).WillRepeatedly(Return(first_buffer));
+    EXPECT_CALL(mock_gl, glDeleteTextures(_, _)).Times(0);
+
+    first_output.load(renderable);
+    second_output.load(renderable);
+
+    // The first output stops showing the renderable; the second still is
+    first_output.drop_unused();
+    first_output.drop_unused();
+    second_output.drop_unused();
+    second_output.load(renderable);
+    Mock::VerifyAndClearExpectations(&mock_gl);
+
+    EXPECT_CALL(mock_gl, glDeleteTextures(1, _));
+    second_output.drop_unused();
+    second_output.drop_unused();
+}
+
+TEST_F(RecentlyUsedCache, buffer_is_held_until_no_output_is_part_way_through_a_frame_with_it)
+{
+    EXPECT_CALL(renderable, buffer()).WillRepeatedly(Return(first_buffer));
+    auto const unheld_use_count = first_buffer.use_count();
+
+    first_output.load(renderable);
+    second_output.load(renderable);
+
+    // The second output has yet to finish its frame with the buffer
+    first_output.drop_unused();
+    EXPECT_THAT(first_buffer.use_count(), Gt(unheld_use_count));
+
+    second_output.drop_unused();
+    EXPECT_THAT(first_buffer.use_count(), Eq(unheld_use_count));
+}
+
+TEST_F(RecentlyUsedCache, output_waits_for_another_outputs_upload_before_sampling_it)
+{
+    EXPECT_CALL(renderable, buffer()).WillRepeatedly(Return(first_buffer));
+
+    first_output.load(renderable);
+    auto const upload = fake_fence(fences_created);
+
+    EXPECT_CALL(mock_egl, eglWaitSyncKHR(_, upload, 0));
+    second_output.load(renderable);
+}
+
+TEST_F(RecentlyUsedCache, upload_waits_for_other_outputs_frames_sampling_the_texture)
+{
+    ON_CALL(renderable, buffer_damage_since(mg::BufferID{1})).WillByDefault(Return(damage));
+    EXPECT_CALL(renderable, buffer())
+        .WillOnce(Return(first_buffer)).WillOnce(Return(first_buffer))
+        .WillOnce(Return(second_buffer));
+
+    first_output.load(renderable);
+    second_output.load(renderable);
+    second_output.drop_unused();
+    auto const second_output_frame = fake_fence(fences_created);
+    first_output.drop_unused();
+
+    EXPECT_CALL(mock_egl, eglWaitSyncKHR(_, second_output_frame, 0));
+    EXPECT_CALL(*second_buffer, bind_damaged(damage));
+    first_output.load(renderable);
+}
+
+TEST_F(RecentlyUsedCache, texture_is_not_overwritten_during_another_outputs_frame)
+{
+    EXPECT_CALL(renderable, buffer())
+        .WillOnce(Return(first_buffer)).WillOnce(Return(first_buffer))
+        .WillOnce(Return(second_buffer));
+    EXPECT_CALL(*second_buffer, bind());
+    EXPECT_CALL(*second_buffer, bind_damaged(_)).Times(0);
+
+    auto const first_texture = first_output.load(renderable);
+    second_output.load(renderable);
+    first_output.drop_unused();
+
+    // The second output is still drawing its frame with the first buffer
+    auto const second_texture = first_output.load(renderable);
+
+    EXPECT_THAT(second_texture, Ne(first_texture));
+}
+
+TEST_F(RecentlyUsedCache, outputs_showing_different_buffers_do_not_reupload_them)
+{
+    EXPECT_CALL(*first_buffer, bind());
+    EXPECT_CALL(*second_buffer, bind());
+    EXPECT_CALL(*first_buffer, bind_damaged(_)).Times(0);
+    EXPECT_CALL(*second_buffer, bind_damaged(_)).Times(0);
+
+    EXPECT_CALL(renderable, buffer()).WillRepeatedly(Return(first_buffer));
+    first_output.load(renderable);
+    second_output.load(renderable);
+    first_output.drop_unused();
+
+    // The first output moves on to the next buffer while the second lags behind
+    for (auto frame = 0; frame != 3; ++frame)
+    {
+        EXPECT_CALL(renderable, buffer()).WillOnce(Return(second_buffer)).WillOnce(Return(first_buffer));
+        first_output.load(renderable);
+        second_output.drop_unused();
+        second_output.load(renderable);
+        first_output.drop_unused();
+    }
+
+    EXPECT_CALL(renderable, buffer()).WillOnce(Return(second_buffer));
+    second_output.load(renderable);
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/platforms/common/server/pixel_unpack_stage.h"
+
+#include "mir/test/doubles/mock_gl.h"
+#include "mir/test/doubles/mock_egl.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace mgc = mir::graphics::common;
+namespace mtd = mir::test::doubles;
+using namespace testing;
+
+namespace
+{
+GLenum const pixel_unpack_buffer{0x88EC};
+GLenum const major_version{0x821B};
+
+struct PixelUnpackStage : Test
+{
+    PixelUnpackStage()
+    {
+        ON_CALL(mock_gl, glGetIntegerv(major_version, _))
+            .WillByDefault(SetArgPointee<1>(3));
+        ON_CALL(mock_gl, glGenBuffers(1, _))
+            .WillByDefault(SetArgPointee<1>(pixel_buffer));
+        ON_CALL(mock_egl, eglCreateSyncKHR(_, EGL_SYNC_FENCE_KHR, _))
+            .WillByDefault(Return(fence));
+    }
+
+    NiceMock<mtd::MockGL> mock_gl;
+    NiceMock<mtd::MockEGL> mock_egl;
+    GLuint const pixel_buffer{42};
+    EGLSyncKHR const fence{reinterpret_cast<EGLSyncKHR>(0xfe7ce)};
+    unsigned char const pixels[64]{};
+    std::vector<mgc::PixelUnpackStage::Span> const everything{{0, sizeof pixels}};
+
+    mgc::PixelUnpackStage stage;
+};
+}
+
+TEST_F(PixelUnpackStage, stages_pixels_in_a_pixel_unpack_buffer_and_fences_the_copy)
+{
+    InSequence seq;
+    EXPECT_CALL(mock_gl, glBindBuffer(pixel_unpack_buffer, pixel_buffer));
+    EXPECT_CALL(mock_gl, glBufferData(pixel_unpack_buffer, sizeof pixels, nullptr, GL_STREAM_DRAW));
+    EXPECT_CALL(mock_gl, glBufferSubData(pixel_unpack_buffer, 0, sizeof pixels, pixels));
+    EXPECT_CALL(mock_gl, glBindBuffer(pixel_unpack_buffer, 0));
+    EXPECT_CALL(mock_egl, eglCreateSyncKHR(_, EGL_SYNC_FENCE_KHR, _));
+    EXPECT_CALL(mock_gl, glFlush());
+
+    EXPECT_TRUE(stage.stage(pixels, sizeof pixels, everything));
+}
+
+TEST_F(PixelUnpackStage, stages_only_the_given_spans)
+{
+    EXPECT_CALL(mock_gl, glBufferData(pixel_unpack_buffer, sizeof pixels, nullptr, GL_STREAM_DRAW));
+    EXPECT_CALL(mock_gl, glBufferSubData(pixel_unpack_buffer, 8, 16, pixels + 8));
+    EXPECT_CALL(mock_gl, glBufferSubData(pixel_unpack_buffer, 48, 8, pixels + 48));
+
+    EXPECT_TRUE(stage.stage(pixels, sizeof pixels, {{8, 16}, {48, 8}}));
+}
+
+TEST_F(PixelUnpackStage, stages_nothing_without_pixel_unpack_buffers)
+{
+    // GLES 2 doesn't know GL_MAJOR_VERSION, so leaves the value untouched
+    ON_CALL(mock_gl, glGetIntegerv(major_version, _))
+        .WillByDefault(Return());
+
+    EXPECT_CALL(mock_gl, glGenBuffers(_, _)).Times(0);
+    EXPECT_CALL(mock_gl, glBufferData(_, _, _, _)).Times(0);
+
+    EXPECT_FALSE(stage.stage(pixels, sizeof pixels, everything));
+    EXPECT_FALSE(stage.upload([](GLintptr) { FAIL() << "Nothing was staged"; }));
+}
+
+TEST_F(PixelUnpackStage, upload_before_staging_does_nothing)
+{
+    EXPECT_CALL(mock_gl, glBindBuffer(_, _)).Times(0);
+
+    EXPECT_FALSE(stage.upload([](GLintptr) { FAIL() << "Nothing was staged"; }));
+}
+
+TEST_F(PixelUnpackStage, upload_makes_the_gpu_wait_for_the_staged_copy_then_reads_from_the_bound_stage)
+{
+    stage.stage(pixels, sizeof pixels, everything);
+
+    bool uploaded{false};
+    InSequence seq;
+    EXPECT_CALL(mock_egl, eglWaitSyncKHR(_, fence, 0));
+    EXPECT_CALL(mock_gl, glBindBuffer(pixel_unpack_buffer, pixel_buffer))
+        .WillOnce(InvokeWithoutArgs([&uploaded] { EXPECT_FALSE(uploaded); }));
+    EXPECT_CALL(mock_gl, glBindBuffer(pixel_unpack_buffer, 0))
+        .WillOnce(InvokeWithoutArgs([&uploaded] { EXPECT_TRUE(uploaded); }));
+
+    EXPECT_TRUE(stage.upload(
+        [&uploaded](GLintptr offset)
+        {
+            EXPECT_THAT(offset, Eq(0));
+            uploaded = true;
+        }));
+}
+
+TEST_F(PixelUnpackStage, each_upload_waits_for_the_staged_copy)
+{
+    stage.stage(pixels, sizeof pixels, everything);
+
+    EXPECT_CALL(mock_egl, eglClientWaitSyncKHR(_, _, _, _)).Times(0);
+    EXPECT_CALL(mock_egl, eglWaitSyncKHR(_, fence, 0)).Times(2);
+
+    EXPECT_TRUE(stage.upload([](GLintptr) {}));
+    EXPECT_TRUE(stage.upload([](GLintptr) {}));
+}
+
+TEST_F(PixelUnpackStage, release_deletes_the_pixel_buffer_and_fence)
+{
+    stage.stage(pixels, sizeof pixels, everything);
+
+    EXPECT_CALL(mock_egl, eglDestroySyncKHR(_, fence));
+    EXPECT_CALL(mock_gl, glDeleteBuffers(1, Pointee(pixel_buffer)));
+
+    stage.release();
+
+    EXPECT_FALSE(stage.upload([](GLintptr) { FAIL() << "Stage was released"; }));
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/graphics/presentation_observer_multiplexer.h"
+
+#include "mir/executor.h"
+#include "mir/graphics/frame.h"
+#include "mir/test/doubles/mock_display_report.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <deque>
+#include <thread>
+
+namespace mg = mir::graphics;
+namespace mtd = mir::test::doubles;
+
+using namespace testing;
+
+namespace
+{
+class QueuedExecutor : public mir::Executor
+{
+public:
+    void spawn(std::function<void()>&& work) override
+    {
+        queue.push_back(std::move(work));
+    }
+
+    void run_queued()
+    {
+        while (!queue.empty())
+        {
+            auto const work = std::move(queue.front());
+            queue.pop_front();
+            work();
+        }
+    }
+
+private:
+    std::deque<std::function<void()>> queue;
+};
+
+struct MockPresentationObserver : mg::PresentationObserver
+{
+    MOCK_METHOD2(frame_presented, void(unsigned int, mg::Frame const&));
+    MOCK_METHOD2(frame_posted, void(unsigned int, std::thread::id));
+};
+
+MATCHER_P(FrameWithMsc, msc, "")
+{
+    return arg.msc == msc;
+}
+
+struct PresentationObserverMultiplexer : Test
+{
+    std::shared_ptr<QueuedExecutor> const executor{std::make_shared<QueuedExecutor>()};
+    std::shared_ptr<mg::PresentationObserverMultiplexer> const multiplexer{
+        std::make_shared<mg::PresentationObserverMultiplexer>(executor)};
+    std::shared_ptr<NiceMock<mtd::MockDisplayReport>> const wrapped{
+        std::make_shared<NiceMock<mtd::MockDisplayReport>>()};
+    mg::PresentationNotifyingDisplayReport report{wrapped, multiplexer};
+};
+}
+
+TEST_F(PresentationObserverMultiplexer, vsync_is_reported_and_observed)
+{
+    auto const observer = std::make_shared<NiceMock<MockPresentationObserver>>();
+    multiplexer->register_interest(observer);
+
+    mg::Frame frame;
+    frame.msc = 42;
+
+    EXPECT_CALL(*wrapped, report_vsync(7, FrameWithMsc(42)));
+    EXPECT_CALL(*observer, frame_presented(7, FrameWithMsc(42)));
+
+    report.report_vsync(7, frame);
+    executor->run_queued();
+}
+
+TEST_F(PresentationObserverMultiplexer, post_is_reported_and_observed_with_the_posting_thread)
+{
+    auto const observer = std::make_shared<NiceMock<MockPresentationObserver>>();
+    multiplexer->register_interest(observer);
+
+    std::thread::id compositor;
+    EXPECT_CALL(*wrapped, report_frame_posted(7));
+
+    std::thread{[this, &compositor]
+        {
+            compositor = std::this_thread::get_id();
+            report.report_frame_posted(7);
+        }}.join();
+
+    // The observer is notified on the executor, not the posting thread
+    EXPECT_CALL(*observer, frame_posted(7, compositor));
+    executor->run_queued();
+}
+
+TEST_F(PresentationObserverMultiplexer, post_is_observed_before_its_flip)
+{
+    auto const observer = std::make_shared<NiceMock<MockPresentationObserver>>();
+    multiplexer->register_interest(observer);
+
+    InSequence seq;
+    EXPECT_CALL(*observer, frame_posted(3, _));
+    EXPECT_CALL(*observer, frame_presented(3, _));
+
+    report.report_frame_posted(3);
+    report.report_vsync(3, mg::Frame{});
+    executor->run_queued();
+}
+
+TEST_F(PresentationObserverMultiplexer, other_reports_are_only_forwarded)
+{
+    auto const observer = std::make_shared<NiceMock<MockPresentationObserver>>();
+    multiplexer->register_interest(observer);
+
+    EXPECT_CALL(*wrapped, report_drm_master_failure(13));
+    EXPECT_CALL(*wrapped, report_successful_display_construction());
+    EXPECT_CALL(*observer, frame_presented(_, _)).Times(0);
+
+    report.report_drm_master_failure(13);
+    report.report_successful_display_construction();
+    executor->run_queued();
+}
+
+TEST_F(PresentationObserverMultiplexer, unregistered_observer_sees_no_frames)
+{
+    auto const observer = std::make_shared<NiceMock<MockPresentationObserver>>();
+    multiplexer->register_interest(observer);
+    multiplexer->unregister_interest(*observer);
+
+    EXPECT_CALL(*observer, frame_presented(_, _)).Times(0);
+
+    report.report_vsync(1, mg::Frame{});
+    executor->run_queued();
+}
@@ -17,18 +17,14 @@
  */
 
 #include "src/platforms/common/server/shm_buffer.h"
-#include "src/platforms/common/server/egl_context_executor.h"
-#include "mir/renderer/gl/context.h"
 
 #include "mir/test/doubles/mock_gl.h"
-#include "mir/test/doubles/mock_egl.h"
 
 #include "check_gtest_version.h"
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include <GLES2/gl2ext.h>
-#include <EGL/egl.h>
 #include <endian.h>
 #include <boost/throw_exception.hpp>
 
@@ -41,39 +37,14 @@ using namespace testing;
 namespace
 {
 
-class DumbGLContext : public mir::renderer::gl::Context
-{
-public:
-    DumbGLContext(EGLContext ctx)
-        : ctx{ctx}
-    {
-    }
-
-    void make_current() const override
-    {
-        eglMakeCurrent(dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, ctx);
-    }
-
-    void release_current() const override
-    {
-        eglMakeCurrent(dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
-    }
-
-private:
-    EGLDisplay const dpy{reinterpret_cast<void*>(0xdeebbeed)};
-    EGLContext const ctx;
-};
-
 struct PlatformlessShmBuffer : mgc::MemoryBackedShmBuffer
 {
     PlatformlessShmBuffer(
         geom::Size const& size,
-        MirPixelFormat const& pixel_format,
-        std::shared_ptr<mgc::EGLContextExecutor> egl_delegate)
+        MirPixelFormat const& pixel_format)
         : MemoryBackedShmBuffer(
             size,
-            pixel_format,
-            std::move(egl_delegate))
+            pixel_format)
     {
     }
 
@@ -88,6 +59,12 @@ struct PlatformlessShmBuffer : mgc::MemoryBackedShmBuffer
         return buffer;
     }
 
+    // As a buffer staged in a bound pixel-unpack buffer, at offset 0, would upload
+    void bind_damaged_from_pixel_unpack_buffer(geom::Rectangles const& damage)
+    {
+        upload_damage_to_texture(nullptr, stride(), damage);
+    }
+
     std::shared_ptr<mg::NativeBuffer> native_buffer_handle() const override
     {
         return nullptr;
@@ -99,24 +76,16 @@ struct ShmBufferTest : public testing::Test
     ShmBufferTest()
         : size{150, 340},
           pixel_format{mir_pixel_format_bgr_888},
-          egl_delegate{
-            std::make_shared<mgc::EGLContextExecutor>(
-                std::make_unique<DumbGLContext>(dummy))},
           shm_buffer{
             size,
-            pixel_format,
-            std::make_shared<mgc::EGLContextExecutor>(
-                std::make_unique<DumbGLContext>(dummy))}
+            pixel_format}
     {
     }
 
-    testing::NiceMock<mtd::MockEGL> mock_egl;
     testing::NiceMock<mtd::MockGL> mock_gl;
 
     geom::Size const size;
     MirPixelFormat const pixel_format;
-    EGLContext const dummy{reinterpret_cast<void*>(0x0011223344)};
-    std::shared_ptr<mgc::EGLContextExecutor> const egl_delegate;
 
     PlatformlessShmBuffer shm_buffer;
 };
@@ -135,7 +104,7 @@ TEST_F(ShmBufferTest, has_correct_properties)
 
 TEST_F(ShmBufferTest, cant_upload_bgr_888)
 {
-    PlatformlessShmBuffer buf(size, mir_pixel_format_bgr_888, egl_delegate);
+    PlatformlessShmBuffer buf(size, mir_pixel_format_bgr_888);
     EXPECT_CALL(mock_gl, glTexImage2D(GL_TEXTURE_2D, 0, _,
                                       size.width.as_int(), size.height.as_int(),
                                       0, _, _,
@@ -165,8 +134,7 @@ TEST_P(UploadTest, uploads_correctly)
 {
     auto const desc = GetParam();
 
-    PlatformlessShmBuffer buf(
-        desc.size, desc.format, egl_delegate);
+    PlatformlessShmBuffer buf(desc.size, desc.format);
 
     ExpectationSet gl_setup;
     gl_setup +=
@@ -304,61 +272,85 @@ INSTANTIATE_TEST_SUITE_P(
     ValuesIn(test_cases));
 #endif
 
-namespace
-{
-void wait_for_egl_thread(mgc::EGLContextExecutor& egl_delegate)
+TEST_F(ShmBufferTest, bind_damaged_uploads_only_damaged_rows)
 {
-    auto egl_thread_started_promise = std::make_shared<std::promise<void>>();
-    auto const egl_thread_started = egl_thread_started_promise->get_future();
+    PlatformlessShmBuffer buf(default_size, mir_pixel_format_rgb_565);
+    auto const width = default_size.width.as_int();
+    auto const stride = buf.stride().as_int();
 
-    egl_delegate.spawn(
-        [promise = std::move(egl_thread_started_promise)]()
-        {
-            promise->set_value();
-        });
+    EXPECT_CALL(mock_gl, glTexImage2D(_, _, _, _, _, _, _, _, _)).Times(0);
 
-    if (egl_thread_started.wait_for(std::chrono::seconds{10}) != std::future_status::ready)
-    {
-        BOOST_THROW_EXCEPTION((std::runtime_error{"Timeout waiting for EGLContextDelegate"}));
-    }
-}
+    ExpectationSet gl_setup;
+    gl_setup +=
+        EXPECT_CALL(mock_gl, glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+    gl_setup +=
+        EXPECT_CALL(mock_gl, glPixelStorei(GL_UNPACK_ROW_LENGTH_EXT, width));
+
+    ExpectationSet gl_use;
+    gl_use += EXPECT_CALL(
+        mock_gl,
+        glTexSubImage2D(
+            GL_TEXTURE_2D, 0,
+            0, 10,
+            width, 12,
+            GL_RGB, GL_UNSIGNED_SHORT_5_6_5,
+            buf.pixel_buffer() + 10 * stride))
+        .After(gl_setup);
+    gl_use += EXPECT_CALL(
+        mock_gl,
+        glTexSubImage2D(
+            GL_TEXTURE_2D, 0,
+            0, 100,
+            width, 1,
+            GL_RGB, GL_UNSIGNED_SHORT_5_6_5,
+            buf.pixel_buffer() + 100 * stride))
+        .After(gl_setup);
+
+    EXPECT_CALL(mock_gl, glPixelStorei(GL_UNPACK_ALIGNMENT, 4))
+        .After(gl_use);
+    EXPECT_CALL(mock_gl, glPixelStorei(GL_UNPACK_ROW_LENGTH_EXT, 0))
+        .After(gl_use);
+
+    buf.bind_damaged({{{0, 10}, {5, 5}}, {{20, 12}, {5, 10}}, {{0, 100}, {10, 1}}});
 }
 
-TEST_F(ShmBufferTest, texture_is_destroyed_on_thread_with_current_context)
+TEST_F(ShmBufferTest, bind_damaged_with_empty_damage_uploads_nothing)
 {
-    GLint const tex_id{0x8086};
-    EXPECT_CALL(mock_gl, glGenTextures(1,_))
-        .WillOnce(SetArgPointee<1>(tex_id));
-    EXPECT_CALL(mock_gl, glDeleteTextures(1,Pointee(Eq(tex_id))))
-        .WillOnce(InvokeWithoutArgs(
-            [this]()
-            {
-                EXPECT_THAT(
-                    mock_egl.current_contexts[std::this_thread::get_id()],
-                    Ne(EGL_NO_CONTEXT));
-            }));
+    PlatformlessShmBuffer buf(default_size, mir_pixel_format_rgb_565);
 
-    EGLContext const dummy_ctx{reinterpret_cast<EGLContext>(0x66221144)};
-    EGLDisplay const dummy_dpy{reinterpret_cast<EGLDisplay>(0xaabbccdd)};
+    EXPECT_CALL(mock_gl, glTexImage2D(_, _, _, _, _, _, _, _, _)).Times(0);
+    EXPECT_CALL(mock_gl, glTexSubImage2D(_, _, _, _, _, _, _, _, _)).Times(0);
 
-    {
-        /* Use a locally-scoped EGLContextDelegate to make use of
-         * the fact that the destructor ensures the work-queue is drained.
-         */
-        auto egl_delegate = std::make_shared<mgc::EGLContextExecutor>(
-            std::make_unique<DumbGLContext>(reinterpret_cast<EGLContext>(42)));
+    buf.bind_damaged({});
+}
 
-        // Ensure that the EGL thread has actually spun up…
-        wait_for_egl_thread(*egl_delegate);
+TEST_F(ShmBufferTest, owns_no_texture_so_can_be_destroyed_on_any_thread)
+{
+    // The renderer's texture cache owns the texture, and only deletes it with a current context
+    EXPECT_CALL(mock_gl, glGenTextures(_, _)).Times(0);
+    EXPECT_CALL(mock_gl, glDeleteTextures(_, _)).Times(0);
 
-        // Ensure we have a “context” current for creation and bind
-        eglMakeCurrent(dummy_dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, dummy_ctx);
+    {
+        PlatformlessShmBuffer buf(default_size, mir_pixel_format_rgb_565);
+        buf.bind();
+        buf.bind_damaged({{{0, 0}, {5, 5}}});
+    }
+}
 
-        PlatformlessShmBuffer buffer{size, pixel_format, egl_delegate};
+TEST_F(ShmBufferTest, bind_damaged_from_pixel_unpack_buffer_uploads_rows_at_their_offsets)
+{
+    PlatformlessShmBuffer buf(default_size, mir_pixel_format_rgb_565);
+    auto const width = default_size.width.as_int();
+    auto const stride = buf.stride().as_int();
 
-        buffer.bind();
+    EXPECT_CALL(
+        mock_gl,
+        glTexSubImage2D(
+            GL_TEXTURE_2D, 0,
+            0, 10,
+            width, 5,
+            GL_RGB, GL_UNSIGNED_SHORT_5_6_5,
+            reinterpret_cast<void const*>(10 * stride)));
 
-        // Ensure this thread does *not* have a “context” current for destruction
-        eglMakeCurrent(dummy_dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
-    }
+    buf.bind_damaged_from_pixel_unpack_buffer({{{0, 10}, {5, 5}}});
 }
@@ -18,11 +18,13 @@
 
 #include "mir/events/event_builders.h"
 #include "mir/events/event_private.h" // only needed to validate motion_up/down mapping
+#include "mir_toolkit/mir_blob.h"
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
 #include <linux/input.h>
+#include <stdexcept>
 
 namespace mev = mir::events;
 using namespace ::testing;
@@ -283,3 +285,97 @@ TEST_F(InputEventBuilder, when_deserialized_input_device_state_event_has_supplie
         EXPECT_THAT(mir_input_device_state_event_device_pressed_keys_for_index(ids_event, 2, i), Eq(pressed_keys[i]));
     }
 }
+
+TEST_F(InputEventBuilder, key_event_survives_serialization)
+{
+    auto ev = mev::make_event(device_id, timestamp, {1, 2, 3}, mir_keyboard_action_down, 34, 17, modifiers);
+    ev->to_input()->to_keyboard()->set_text("ä");
+    ev->to_input()->set_window_id(5);
+
+    auto const deserialized = MirEvent::deserialize(MirEvent::serialize(ev.get()));
+
+    ASSERT_THAT(mir_event_get_type(deserialized.get()), Eq(mir_event_type_input));
+    auto const kev = deserialized->to_input()->to_keyboard();
+    ASSERT_THAT(kev->input_type(), Eq(mir_input_event_type_key));
+    EXPECT_THAT(kev->device_id(), Eq(device_id));
+    EXPECT_THAT(kev->event_time(), Eq(timestamp));
+    EXPECT_THAT(kev->modifiers(), Eq(modifiers));
+    EXPECT_THAT(kev->window_id(), Eq(5));
+    EXPECT_THAT(kev->cookie(), ElementsAre(1, 2, 3));
+    EXPECT_THAT(kev->action(), Eq(mir_keyboard_action_down));
+    EXPECT_THAT(kev->key_code(), Eq(34));
+    EXPECT_THAT(kev->scan_code(), Eq(17));
+    EXPECT_THAT(kev->text(), StrEq("ä"));
+}
+
+TEST_F(InputEventBuilder, pointer_event_survives_serialization)
+{
+    auto ev = mev::make_event(device_id, timestamp, cookie, modifiers,
+        mir_pointer_action_motion, mir_pointer_button_primary, 3.5f, 7.25f, 0.5f, 1.5f, 2.0f, -2.0f);
+    ev->to_input()->to_pointer()->set_dnd_handle({9, 8, 7});
+
+    auto const deserialized = MirEvent::deserialize(MirEvent::serialize(ev.get()));
+
+    ASSERT_THAT(mir_event_get_type(deserialized.get()), Eq(mir_event_type_input));
+    auto const pev = deserialized->to_input()->to_pointer();
+    ASSERT_THAT(pev->input_type(), Eq(mir_input_event_type_pointer));
+    EXPECT_THAT(pev->device_id(), Eq(device_id));
+    EXPECT_THAT(pev->action(), Eq(mir_pointer_action_motion));
+    EXPECT_THAT(pev->buttons(), Eq(mir_pointer_button_primary));
+    EXPECT_THAT(pev->x(), Eq(3.5f));
+    EXPECT_THAT(pev->y(), Eq(7.25f));
+    EXPECT_THAT(pev->hscroll(), Eq(0.5f));
+    EXPECT_THAT(pev->vscroll(), Eq(1.5f));
+    EXPECT_THAT(pev->dx(), Eq(2.0f));
+    EXPECT_THAT(pev->dy(), Eq(-2.0f));
+
+    std::unique_ptr<MirBlob, void(*)(MirBlob*)> const handle{pev->dnd_handle(), &mir_blob_release};
+    ASSERT_THAT(handle, NotNull());
+    EXPECT_THAT(mir_blob_size(handle.get()), Eq(3u));
+}
+
+TEST_F(InputEventBuilder, touch_event_survives_serialization)
+{
+    auto ev = mev::make_event(device_id, timestamp, cookie, modifiers);
+    mev::add_touch(*ev, 7, mir_touch_action_down, mir_touch_tooltype_finger, 1, 2, 3, 4, 5, 6);
+    mev::add_touch(*ev, 9, mir_touch_action_change, mir_touch_tooltype_stylus, 10, 20, 30, 40, 50, 60);
+
+    auto const deserialized = MirEvent::deserialize(MirEvent::serialize(ev.get()));
+
+    ASSERT_THAT(mir_event_get_type(deserialized.get()), Eq(mir_event_type_input));
+    auto const tev = deserialized->to_input()->to_touch();
+    ASSERT_THAT(tev->input_type(), Eq(mir_input_event_type_touch));
+    ASSERT_THAT(tev->pointer_count(), Eq(2u));
+    EXPECT_THAT(tev->id(1), Eq(9));
+    EXPECT_THAT(tev->action(1), Eq(mir_touch_action_change));
+    EXPECT_THAT(tev->tool_type(1), Eq(mir_touch_tooltype_stylus));
+    EXPECT_THAT(tev->x(1), Eq(10));
+    EXPECT_THAT(tev->y(1), Eq(20));
+    EXPECT_THAT(tev->pressure(1), Eq(30));
+    EXPECT_THAT(tev->touch_major(1), Eq(40));
+    EXPECT_THAT(tev->touch_minor(1), Eq(50));
+}
+
+TEST_F(InputEventBuilder, touch_event_rejects_index_past_its_contacts)
+{
+    auto ev = mev::make_event(device_id, timestamp, cookie, modifiers);
+    mev::add_touch(*ev, 7, mir_touch_action_down, mir_touch_tooltype_finger, 1, 2, 3, 4, 5, 6);
+    mev::add_touch(*ev, 9, mir_touch_action_change, mir_touch_tooltype_stylus, 10, 20, 30, 40, 50, 60);
+
+    auto const tev = ev->to_input()->to_touch();
+    EXPECT_NO_THROW(tev->id(1));
+    EXPECT_THROW(tev->id(2), std::out_of_range);
+    EXPECT_THROW(tev->set_x(2, 0), std::out_of_range);
+}
+
+TEST_F(InputEventBuilder, cloned_input_event_is_independent_of_original)
+{
+    auto ev = mev::make_event(device_id, timestamp, cookie, modifiers,
+        mir_pointer_action_motion, 0, 1.0f, 2.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+
+    auto const clone = mev::clone_event(*ev);
+    ev->to_input()->to_pointer()->set_x(100.0f);
+
+    EXPECT_THAT(clone->to_input()->to_pointer()->x(), Eq(1.0f));
+    EXPECT_THAT(clone->type(), Eq(mir_event_type_input));
+}
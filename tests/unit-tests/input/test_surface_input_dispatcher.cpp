@@ -547,3 +547,38 @@ TEST_F(SurfaceInputDispatcher, touch_gesture_target_may_vanish_but_things_contin
     EXPECT_FALSE(dispatcher.dispatch(toucher.release_at({0, 0})));
     EXPECT_TRUE(dispatcher.dispatch(toucher.touch_at({0, 0})));
 }
+
+TEST_F(SurfaceInputDispatcher, event_is_shared_with_surface_that_needs_no_changes)
+{
+    auto surface = scene.add_surface({{0, 0}, {5, 5}});
+
+    FakeToucher toucher;
+    std::shared_ptr<MirEvent const> const event = toucher.touch_at({1, 1});
+    std::shared_ptr<MirEvent const> consumed;
+
+    EXPECT_CALL(*surface, consume(_)).WillOnce(SaveArg<0>(&consumed));
+
+    dispatcher.start();
+    EXPECT_TRUE(dispatcher.dispatch(event));
+
+    EXPECT_THAT(consumed, Eq(event));
+}
+
+TEST_F(SurfaceInputDispatcher, event_is_copied_for_surface_that_needs_translated_coordinates)
+{
+    auto surface = scene.add_surface({{2, 2}, {5, 5}});
+
+    FakeToucher toucher;
+    std::shared_ptr<MirEvent const> const event = toucher.touch_at({3, 3});
+    std::shared_ptr<MirEvent const> consumed;
+
+    EXPECT_CALL(*surface, consume(_)).WillOnce(SaveArg<0>(&consumed));
+
+    dispatcher.start();
+    EXPECT_TRUE(dispatcher.dispatch(event));
+
+    ASSERT_THAT(consumed, NotNull());
+    EXPECT_THAT(consumed, Ne(event));
+    EXPECT_THAT(consumed.get(), mt::TouchEvent(1, 1));
+    EXPECT_THAT(event.get(), mt::TouchEvent(3, 3));
+}
@@ -0,0 +1,177 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/logging/async_console_logger.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+
+namespace ml = mir::logging;
+
+using namespace testing;
+
+namespace
+{
+// A stream buffer whose writes can be held up, to keep the logging thread busy
+class GatedBuffer : public std::stringbuf
+{
+public:
+    void close()
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        open = false;
+    }
+
+    void reopen()
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        open = true;
+        changed.notify_all();
+    }
+
+    void wait_until_writer_blocked()
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        changed.wait(lock, [this] { return writer_blocked; });
+    }
+
+protected:
+    std::streamsize xsputn(char const* s, std::streamsize n) override
+    {
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            writer_blocked = !open;
+            changed.notify_all();
+            changed.wait(lock, [this] { return open; });
+            writer_blocked = false;
+        }
+        return std::stringbuf::xsputn(s, n);
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool open{true};
+    bool writer_blocked{false};
+};
+
+struct AsyncConsoleLogger : Test
+{
+    GatedBuffer out_buffer;
+    std::ostream out{&out_buffer};
+    std::ostringstream err;
+};
+}
+
+TEST_F(AsyncConsoleLogger, writes_messages_in_order_once_flushed)
+{
+    ml::AsyncConsoleLogger logger{out, err, 16};
+
+    logger.log(ml::Severity::informational, "first", "test");
+    logger.log(ml::Severity::debug, "second", "test");
+    logger.flush();
+
+    auto const output = out_buffer.str();
+    auto const first = output.find("] <information> test: first\n");
+    auto const second = output.find("] < - debug - > test: second\n");
+    EXPECT_THAT(first, Ne(std::string::npos));
+    EXPECT_THAT(second, Ne(std::string::npos));
+    EXPECT_THAT(first, Lt(second));
+    EXPECT_THAT(err.str(), Eq(""));
+}
+
+TEST_F(AsyncConsoleLogger, writes_errors_to_error_stream)
+{
+    ml::AsyncConsoleLogger logger{out, err, 16};
+
+    logger.log(ml::Severity::error, "oops", "test");
+    logger.flush();
+
+    EXPECT_THAT(err.str(), HasSubstr("< - ERROR - > test: oops\n"));
+    EXPECT_THAT(out_buffer.str(), Eq(""));
+}
+
+TEST_F(AsyncConsoleLogger, writes_critical_messages_before_returning)
+{
+    ml::AsyncConsoleLogger logger{out, err, 16};
+
+    logger.log(ml::Severity::informational, "before", "test");
+    logger.log(ml::Severity::critical, "fatal", "test");
+
+    EXPECT_THAT(out_buffer.str(), HasSubstr("test: before\n"));
+    EXPECT_THAT(err.str(), HasSubstr("< CRITICAL! > test: fatal\n"));
+}
+
+TEST_F(AsyncConsoleLogger, writes_pending_messages_when_destroyed)
+{
+    {
+        ml::AsyncConsoleLogger logger{out, err, 16};
+        logger.log(ml::Severity::informational, "last words", "test");
+    }
+
+    EXPECT_THAT(out_buffer.str(), HasSubstr("test: last words\n"));
+}
+
+TEST_F(AsyncConsoleLogger, drops_and_reports_messages_when_full)
+{
+    ml::AsyncConsoleLogger logger{out, err, 4};
+
+    out_buffer.close();
+    logger.log(ml::Severity::informational, "blocks the writer", "test");
+    out_buffer.wait_until_writer_blocked();
+
+    for (auto i = 0; i != 10; ++i)
+        logger.log(ml::Severity::informational, "message", "test");
+
+    EXPECT_THAT(logger.dropped(), Eq(6u));
+
+    out_buffer.reopen();
+    logger.flush();
+
+    EXPECT_THAT(err.str(), HasSubstr("logging: 6 log messages dropped\n"));
+}
+
+TEST_F(AsyncConsoleLogger, truncates_messages_too_long_for_a_slot)
+{
+    ml::AsyncConsoleLogger logger{out, err, 16};
+
+    std::string const fits(ml::AsyncConsoleLogger::max_message_size, 'a');
+    logger.log(ml::Severity::informational, fits, "test");
+    logger.log(ml::Severity::informational, fits + "b", "test");
+    logger.flush();
+
+    auto const truncated = fits.substr(0, fits.size() - 3) + "...";
+    EXPECT_THAT(out_buffer.str(), HasSubstr("test: " + fits + "\n"));
+    EXPECT_THAT(out_buffer.str(), HasSubstr("test: " + truncated + "\n"));
+}
+
+TEST_F(AsyncConsoleLogger, does_not_truncate_in_the_middle_of_a_character)
+{
+    ml::AsyncConsoleLogger logger{out, err, 16};
+
+    // A two-byte character straddles the point where the message would be cut
+    std::string const message =
+        std::string(ml::AsyncConsoleLogger::max_message_size - 4, 'a') + "\u00e9" + "bbbb";
+    logger.log(ml::Severity::informational, message, "test");
+    logger.flush();
+
+    auto const truncated = std::string(ml::AsyncConsoleLogger::max_message_size - 4, 'a') + "...";
+    EXPECT_THAT(out_buffer.str(), HasSubstr("test: " + truncated + "\n"));
+}
@@ -59,6 +59,10 @@ struct MockKMSOutput : public graphics::gbm::KMSOutput
     MOCK_METHOD1(schedule_page_flip_thunk, bool(graphics::gbm::FBHandle const*));
     MOCK_METHOD0(wait_for_page_flip, void());
 
+    MOCK_CONST_METHOD0(supports_planes, bool());
+    MOCK_METHOD1(test_planes, bool(std::vector<graphics::gbm::PlaneLayer> const&));
+    MOCK_METHOD1(schedule_planes_flip, bool(std::vector<graphics::gbm::PlaneLayer> const&));
+
     MOCK_CONST_METHOD0(last_frame, graphics::Frame());
 
     MOCK_METHOD1(set_cursor, bool(gbm_bo*));
@@ -39,6 +39,8 @@
 #include <gmock/gmock.h>
 #include <gbm.h>
 
+#include <thread>
+
 using namespace testing;
 using namespace mir;
 using namespace std;
@@ -222,6 +224,85 @@ TEST_F(MesaDisplayBufferTest, predictive_bypass_is_throttled)
     }
 }
 
+TEST_F(MesaDisplayBufferTest, predictive_bypass_sleep_is_relative_to_last_vblank)
+{
+    using namespace std::chrono_literals;
+
+    graphics::gbm::DisplayBuffer db(
+        graphics::gbm::BypassOption::allowed,
+        null_display_report(),
+        {mock_kms_output},
+        make_output_surface(),
+        display_area,
+        identity);
+
+    // The last flip completed 10ms ago, so the next vblank is due in ~6ms
+    graphics::Frame vblank;
+    vblank.msc = 1;
+    vblank.ust = graphics::Frame::Timestamp::now(CLOCK_MONOTONIC) - 10ms;
+    ON_CALL(*mock_kms_output, last_frame())
+        .WillByDefault(Return(vblank));
+
+    ASSERT_TRUE(db.overlay(bypassable_list));
+    db.post();
+
+    int const milliseconds_per_frame = 1000 / mock_refresh_rate;
+    EXPECT_THAT(db.recommended_sleep().count(),
+                Lt(milliseconds_per_frame - 10));
+}
+
+TEST_F(MesaDisplayBufferTest, render_time_is_measured_from_begin_frame)
+{
+    using namespace std::chrono_literals;
+
+    graphics::gbm::DisplayBuffer db(
+        graphics::gbm::BypassOption::allowed,
+        null_display_report(),
+        {mock_kms_output},
+        make_output_surface(),
+        display_area,
+        identity);
+
+    // Sampling the scene takes longer than a frame, so there's no time to sleep
+    for (int frame = 0; frame < 30; ++frame)
+    {
+        db.begin_frame();
+        std::this_thread::sleep_for(20ms);
+        ASSERT_TRUE(db.overlay(bypassable_list));
+        db.post();
+    }
+
+    EXPECT_EQ(0, db.recommended_sleep().count());
+}
+
+TEST_F(MesaDisplayBufferTest, waiting_for_frame_deadline_sleeps_until_the_deadline)
+{
+    using namespace std::chrono_literals;
+
+    graphics::gbm::DisplayBuffer db(
+        graphics::gbm::BypassOption::allowed,
+        null_display_report(),
+        {mock_kms_output},
+        make_output_surface(),
+        display_area,
+        identity);
+
+    // The last flip has just completed, so the deadline is most of a frame away
+    graphics::Frame vblank;
+    vblank.msc = 1;
+    vblank.ust = graphics::Frame::Timestamp::now(CLOCK_MONOTONIC) - 1ms;
+    ON_CALL(*mock_kms_output, last_frame())
+        .WillByDefault(Return(vblank));
+
+    ASSERT_TRUE(db.overlay(bypassable_list));
+    db.post();
+    ASSERT_THAT(db.recommended_sleep().count(), Gt(0));
+
+    db.wait_for_frame_deadline();
+
+    EXPECT_EQ(0, db.recommended_sleep().count());
+}
+
 TEST_F(MesaDisplayBufferTest, frames_requiring_gl_are_not_throttled)
 {
     graphics::RenderableList non_bypassable_list{
@@ -440,6 +521,48 @@ TEST_F(MesaDisplayBufferTest, single_mode_first_post_flips_with_wait)
     db.post();
 }
 
+TEST_F(MesaDisplayBufferTest, single_mode_composited_post_waits_for_gpu_only_after_scheduling_flip)
+{
+    auto const render_fence = reinterpret_cast<EGLSyncKHR>(0xfe7ce);
+    ON_CALL(mock_egl, eglCreateSyncKHR(_, EGL_SYNC_FENCE_KHR, _))
+        .WillByDefault(Return(render_fence));
+
+    InSequence seq;
+    EXPECT_CALL(*mock_kms_output, schedule_page_flip_thunk(_));
+    EXPECT_CALL(mock_egl, eglClientWaitSyncKHR(_, render_fence, _, _));
+    EXPECT_CALL(*mock_kms_output, wait_for_page_flip());
+
+    graphics::gbm::DisplayBuffer db(
+        graphics::gbm::BypassOption::allowed,
+        null_display_report(),
+        {mock_kms_output},
+        make_output_surface(),
+        display_area,
+        identity);
+
+    db.swap_buffers();
+    db.post();
+}
+
+TEST_F(MesaDisplayBufferTest, clone_mode_does_not_wait_for_gpu)
+{
+    EXPECT_CALL(mock_egl, eglCreateSyncKHR(_, _, _))
+        .Times(0);
+    EXPECT_CALL(mock_egl, eglClientWaitSyncKHR(_, _, _, _))
+        .Times(0);
+
+    graphics::gbm::DisplayBuffer db(
+        graphics::gbm::BypassOption::allowed,
+        null_display_report(),
+        {mock_kms_output, mock_kms_output},
+        make_output_surface(),
+        display_area,
+        identity);
+
+    db.swap_buffers();
+    db.post();
+}
+
 TEST_F(MesaDisplayBufferTest, clone_mode_waits_for_page_flip_on_second_flip)
 {
     InSequence seq;
@@ -512,3 +635,156 @@ TEST_F(MesaDisplayBufferTest, skips_bypass_because_of_incompatible_bypass_buffer
 
     EXPECT_FALSE(db.overlay(list));
 }
+
+TEST_F(MesaDisplayBufferTest, overlay_ui_over_fullscreen_is_scanned_out_on_planes)
+{
+    auto const ui = std::make_shared<FakeRenderable>(geometry::Rectangle{{22, 44}, {10, 10}});
+    auto const ui_buffer = std::make_shared<NiceMock<MockBuffer>>();
+    ON_CALL(*ui_buffer, size())
+        .WillByDefault(Return(geometry::Size{10, 10}));
+    ON_CALL(*ui_buffer, native_buffer_base())
+        .WillByDefault(Return(&mock_dmabuf_buffer));
+    ui->set_buffer(ui_buffer);
+    graphics::RenderableList const list{fake_bypassable_renderable, ui};
+
+    ON_CALL(*mock_kms_output, supports_planes())
+        .WillByDefault(Return(true));
+    EXPECT_CALL(*mock_kms_output, test_planes(SizeIs(2)))
+        .WillOnce(
+            Invoke(
+                [](std::vector<PlaneLayer> const& layers)
+                {
+                    EXPECT_THAT(layers[0].destination, Eq(geometry::Rectangle{{0, 0}, {56, 78}}));
+                    EXPECT_THAT(layers[1].destination, Eq(geometry::Rectangle{{10, 10}, {10, 10}}));
+                    return true;
+                }));
+    EXPECT_CALL(*mock_kms_output, schedule_planes_flip(SizeIs(2)))
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mock_kms_output, schedule_page_flip_thunk(_))
+        .Times(0);
+
+    graphics::gbm::DisplayBuffer db(
+        graphics::gbm::BypassOption::allowed,
+        null_display_report(),
+        {mock_kms_output},
+        make_output_surface(),
+        display_area,
+        identity);
+
+    auto const original_count = ui_buffer.use_count();
+
+    EXPECT_TRUE(db.overlay(list));
+    db.post();
+
+    // The buffers stay held while they're on screen
+    EXPECT_EQ(original_count + 1, ui_buffer.use_count());
+}
+
+TEST_F(MesaDisplayBufferTest, rejected_plane_configuration_falls_back_to_gl)
+{
+    auto const ui = std::make_shared<FakeRenderable>(geometry::Rectangle{{22, 44}, {10, 10}});
+    ui->set_buffer(mock_bypassable_buffer);
+    graphics::RenderableList const list{fake_bypassable_renderable, ui};
+
+    ON_CALL(*mock_kms_output, supports_planes())
+        .WillByDefault(Return(true));
+    EXPECT_CALL(*mock_kms_output, test_planes(_))
+        .WillOnce(Return(false));
+    EXPECT_CALL(*mock_kms_output, schedule_planes_flip(_))
+        .Times(0);
+
+    graphics::gbm::DisplayBuffer db(
+        graphics::gbm::BypassOption::allowed,
+        null_display_report(),
+        {mock_kms_output},
+        make_output_surface(),
+        display_area,
+        identity);
+
+    EXPECT_FALSE(db.overlay(list));
+}
+
+TEST_F(MesaDisplayBufferTest, translucent_renderable_is_not_assigned_a_plane)
+{
+    auto const ui = std::make_shared<FakeRenderable>(geometry::Rectangle{{22, 44}, {10, 10}}, 0.5f);
+    ui->set_buffer(mock_bypassable_buffer);
+    graphics::RenderableList const list{fake_bypassable_renderable, ui};
+
+    ON_CALL(*mock_kms_output, supports_planes())
+        .WillByDefault(Return(true));
+    EXPECT_CALL(*mock_kms_output, test_planes(_))
+        .Times(0);
+
+    graphics::gbm::DisplayBuffer db(
+        graphics::gbm::BypassOption::allowed,
+        null_display_report(),
+        {mock_kms_output},
+        make_output_surface(),
+        display_area,
+        identity);
+
+    EXPECT_FALSE(db.overlay(list));
+}
+
+TEST_F(MesaDisplayBufferTest, clipped_renderable_is_scanned_out_cropped)
+{
+    auto const ui = std::make_shared<FakeRenderable>(geometry::Rectangle{{22, 44}, {10, 10}});
+    auto const ui_buffer = std::make_shared<NiceMock<MockBuffer>>();
+    ON_CALL(*ui_buffer, size())
+        .WillByDefault(Return(geometry::Size{10, 10}));
+    ON_CALL(*ui_buffer, native_buffer_base())
+        .WillByDefault(Return(&mock_dmabuf_buffer));
+    ui->set_buffer(ui_buffer);
+    ui->set_clip_area({{25, 40}, {20, 10}});
+    graphics::RenderableList const list{fake_bypassable_renderable, ui};
+
+    ON_CALL(*mock_kms_output, supports_planes())
+        .WillByDefault(Return(true));
+    EXPECT_CALL(*mock_kms_output, test_planes(SizeIs(2)))
+        .WillOnce(
+            Invoke(
+                [](std::vector<PlaneLayer> const& layers)
+                {
+                    EXPECT_THAT(layers[1].source, Eq(geometry::Rectangle{{3, 0}, {7, 6}}));
+                    EXPECT_THAT(layers[1].destination, Eq(geometry::Rectangle{{13, 10}, {7, 6}}));
+                    return true;
+                }));
+
+    graphics::gbm::DisplayBuffer db(
+        graphics::gbm::BypassOption::allowed,
+        null_display_report(),
+        {mock_kms_output},
+        make_output_surface(),
+        display_area,
+        identity);
+
+    EXPECT_TRUE(db.overlay(list));
+}
+
+TEST_F(MesaDisplayBufferTest, clipped_scaled_renderable_is_not_assigned_a_plane)
+{
+    auto const ui = std::make_shared<FakeRenderable>(geometry::Rectangle{{22, 44}, {10, 10}});
+    auto const ui_buffer = std::make_shared<NiceMock<MockBuffer>>();
+    ON_CALL(*ui_buffer, size())
+        .WillByDefault(Return(geometry::Size{20, 20}));
+    ON_CALL(*ui_buffer, native_buffer_base())
+        .WillByDefault(Return(&mock_dmabuf_buffer));
+    ui->set_buffer(ui_buffer);
+    ui->set_clip_area({{25, 40}, {20, 10}});
+    graphics::RenderableList const list{fake_bypassable_renderable, ui};
+
+    ON_CALL(*mock_kms_output, supports_planes())
+        .WillByDefault(Return(true));
+    EXPECT_CALL(*mock_kms_output, test_planes(_))
+        .Times(0);
+
+    graphics::gbm::DisplayBuffer db(
+        graphics::gbm::BypassOption::allowed,
+        null_display_report(),
+        {mock_kms_output},
+        make_output_surface(),
+        display_area,
+        identity);
+
+    EXPECT_FALSE(db.overlay(list));
+}
@@ -149,6 +149,68 @@ TEST_F(KMSPageFlipperTest, wait_for_flip_reports_vsync)
     page_flipper.wait_for_flip(crtc_id);
 }
 
+TEST_F(KMSPageFlipperTest, scheduled_flip_is_reported_as_posted_before_its_vsync)
+{
+    using namespace testing;
+    uint32_t const crtc_id{10};
+    uint32_t const fb_id{101};
+    uint32_t const connector_id{345};
+    void* user_data{nullptr};
+    ON_CALL(mock_drm, drmModePageFlip(_, _, _, _, _))
+        .WillByDefault(DoAll(SaveArg<4>(&user_data), Return(0)));
+    ON_CALL(mock_drm, drmHandleEvent(_, _))
+        .WillByDefault(DoAll(InvokePageFlipHandler(&user_data), Return(0)));
+
+    InSequence seq;
+    EXPECT_CALL(report, report_frame_posted(connector_id));
+    EXPECT_CALL(report, report_vsync(connector_id, _));
+
+    page_flipper.schedule_flip(crtc_id, fb_id, connector_id);
+    mock_drm.generate_event_on(drm_device);
+    page_flipper.wait_for_flip(crtc_id);
+}
+
+TEST_F(KMSPageFlipperTest, flip_completing_before_its_post_is_reported_has_its_vsync_reported_after)
+{
+    using namespace testing;
+    uint32_t const crtc_id{10};
+    uint32_t const fb_id{101};
+    uint32_t const connector_id{345};
+    void* user_data{nullptr};
+    ON_CALL(mock_drm, drmModePageFlip(_, _, _, _, _))
+        .WillByDefault(DoAll(SaveArg<4>(&user_data), Return(0)));
+    ON_CALL(mock_drm, drmHandleEvent(_, _))
+        .WillByDefault(DoAll(InvokePageFlipHandler(&user_data), Return(0)));
+
+    mock_drm.generate_event_on(drm_device);
+
+    InSequence seq;
+    // Another thread handles the flip event while the post is being reported
+    EXPECT_CALL(report, report_frame_posted(connector_id))
+        .WillOnce(InvokeWithoutArgs(
+            [&]
+            {
+                std::thread{[&]{ page_flipper.wait_for_flip(crtc_id); }}.join();
+            }));
+    EXPECT_CALL(report, report_vsync(connector_id, _));
+
+    page_flipper.schedule_flip(crtc_id, fb_id, connector_id);
+}
+
+TEST_F(KMSPageFlipperTest, failed_flip_is_not_reported_as_posted)
+{
+    using namespace testing;
+    uint32_t const crtc_id{10};
+    uint32_t const fb_id{101};
+    uint32_t const connector_id{345};
+    ON_CALL(mock_drm, drmModePageFlip(_, _, _, _, _))
+        .WillByDefault(Return(-EINVAL));
+
+    EXPECT_CALL(report, report_frame_posted(_)).Times(0);
+
+    EXPECT_FALSE(page_flipper.schedule_flip(crtc_id, fb_id, connector_id));
+}
+
 TEST_F(KMSPageFlipperTest, wait_for_non_scheduled_page_flip_doesnt_block)
 {
     using namespace testing;
@@ -46,6 +46,7 @@ class NullPageFlipper : public mgg::PageFlipper
 {
 public:
     bool schedule_flip(uint32_t,uint32_t,uint32_t) override { return true; }
+    bool schedule_atomic_flip(uint32_t,drmModeAtomicReq*,uint32_t) override { return true; }
     mg::Frame wait_for_flip(uint32_t) override { return {}; }
 };
 
@@ -53,6 +54,7 @@ class MockPageFlipper : public mgg::PageFlipper
 {
 public:
     MOCK_METHOD3(schedule_flip, bool(uint32_t,uint32_t,uint32_t));
+    MOCK_METHOD3(schedule_atomic_flip, bool(uint32_t,drmModeAtomicReq*,uint32_t));
     MOCK_METHOD1(wait_for_flip, mg::Frame(uint32_t));
 };
 
@@ -209,7 +211,8 @@ TEST_F(RealKMSOutputTest, operations_use_existing_crtc)
     mgg::RealKMSOutput output{
         drm_fd,
         mg::kms::get_connector(drm_fd, connector_ids[0]),
-        mt::fake_shared(mock_page_flipper)};
+        mt::fake_shared(mock_page_flipper),
+        false};
 
     auto fb = output.fb_for(fake_bo);
 
@@ -251,7 +254,8 @@ TEST_F(RealKMSOutputTest, operations_use_possible_crtc)
     mgg::RealKMSOutput output{
         drm_fd,
         mg::kms::get_connector(drm_fd, connector_ids[0]),
-        mt::fake_shared(mock_page_flipper)};
+        mt::fake_shared(mock_page_flipper),
+        false};
 
     auto fb = output.fb_for(fake_bo);
 
@@ -291,7 +295,8 @@ TEST_F(RealKMSOutputTest, set_crtc_failure_is_handled_gracefully)
     mgg::RealKMSOutput output{
         drm_fd,
         mg::kms::get_connector(drm_fd, connector_ids[0]),
-        mt::fake_shared(mock_page_flipper)};
+        mt::fake_shared(mock_page_flipper),
+        false};
 
     auto fb = output.fb_for(fake_bo);
 
@@ -314,7 +319,8 @@ TEST_F(RealKMSOutputTest, clear_crtc_gets_crtc_if_none_is_current)
     mgg::RealKMSOutput output{
         drm_fd,
         mg::kms::get_connector(drm_fd, connector_ids[0]),
-        mt::fake_shared(mock_page_flipper)};
+        mt::fake_shared(mock_page_flipper),
+        false};
 
     EXPECT_CALL(mock_drm, drmModeSetCrtc(_, crtc_ids[0], 0, 0, 0, nullptr, 0, nullptr))
         .Times(1)
@@ -351,7 +357,8 @@ TEST_F(RealKMSOutputTest, clear_crtc_does_not_throw_if_no_crtc_is_found)
     mgg::RealKMSOutput output{
         drm_fd,
         mg::kms::get_connector(drm_fd, connector_ids[0]),
-        mt::fake_shared(mock_page_flipper)};
+        mt::fake_shared(mock_page_flipper),
+        false};
 
     EXPECT_CALL(mock_drm, drmModeSetCrtc(_, _, 0, 0, 0, nullptr, 0, nullptr))
         .Times(0);
@@ -372,7 +379,8 @@ TEST_F(RealKMSOutputTest, cursor_move_permission_failure_is_non_fatal)
     mgg::RealKMSOutput output{
         drm_fd,
         mg::kms::get_connector(drm_fd, connector_ids[0]),
-        mt::fake_shared(mock_page_flipper)};
+        mt::fake_shared(mock_page_flipper),
+        false};
 
     auto fb = output.fb_for(fake_bo);
 
@@ -400,7 +408,8 @@ TEST_F(RealKMSOutputTest, cursor_set_permission_failure_is_non_fatal)
     mgg::RealKMSOutput output{
         drm_fd,
         mg::kms::get_connector(drm_fd, connector_ids[0]),
-        mt::fake_shared(mock_page_flipper)};
+        mt::fake_shared(mock_page_flipper),
+        false};
 
     auto fb = output.fb_for(fake_bo);
 
@@ -429,7 +438,8 @@ TEST_F(RealKMSOutputTest, has_no_cursor_if_no_hardware_support)
     mgg::RealKMSOutput output{
         drm_fd,
         mg::kms::get_connector(drm_fd, connector_ids[0]),
-        mt::fake_shared(mock_page_flipper)};
+        mt::fake_shared(mock_page_flipper),
+        false};
 
     auto fb = output.fb_for(fake_bo);
 
@@ -450,7 +460,8 @@ TEST_F(RealKMSOutputTest, clear_crtc_is_non_fatal_on_permission_error)
     mgg::RealKMSOutput output{
         drm_fd,
         mg::kms::get_connector(drm_fd, connector_ids[0]),
-        mt::fake_shared(mock_page_flipper)};
+        mt::fake_shared(mock_page_flipper),
+        false};
 
     EXPECT_CALL(mock_drm, drmModeSetCrtc(_, crtc_ids[0], 0, 0, 0, nullptr, 0, nullptr))
         .Times(2)
@@ -476,7 +487,8 @@ TEST_F(RealKMSOutputTest, clear_crtc_throws_if_drm_call_fails_for_non_permission
     mgg::RealKMSOutput output{
         drm_fd,
         mg::kms::get_connector(drm_fd, connector_ids[0]),
-        mt::fake_shared(mock_page_flipper)};
+        mt::fake_shared(mock_page_flipper),
+        false};
 
     EXPECT_CALL(mock_drm, drmModeSetCrtc(_, crtc_ids[0], 0, 0, 0, nullptr, 0, nullptr))
         .Times(1)
@@ -498,7 +510,8 @@ TEST_F(RealKMSOutputTest, drm_set_gamma)
     mgg::RealKMSOutput output{
         drm_fd,
         mg::kms::get_connector(drm_fd, connector_ids[0]),
-        mt::fake_shared(mock_page_flipper)};
+        mt::fake_shared(mock_page_flipper),
+        false};
 
     mg::GammaCurves gamma{{1}, {2}, {3}};
 
@@ -529,7 +542,8 @@ TEST_F(RealKMSOutputTest, drm_set_gamma_failure_does_not_throw)
     mgg::RealKMSOutput output{
         drm_fd,
         mg::kms::get_connector(drm_fd, connector_ids[0]),
-        mt::fake_shared(mock_page_flipper)};
+        mt::fake_shared(mock_page_flipper),
+        false};
 
     mg::GammaCurves gamma{{1}, {2}, {3}};
 
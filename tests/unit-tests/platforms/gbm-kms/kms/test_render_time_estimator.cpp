@@ -0,0 +1,85 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/platforms/gbm-kms/server/kms/render_time_estimator.h"
+
+#include <gtest/gtest.h>
+
+namespace mgg = mir::graphics::gbm;
+using namespace std::chrono_literals;
+
+TEST(RenderTimeEstimator, uses_fallback_until_enough_frames_are_recorded)
+{
+    mgg::RenderTimeEstimator estimator{50ms};
+
+    estimator.record(2ms);
+    estimator.record(3ms);
+
+    EXPECT_EQ(50ms, estimator.estimate());
+}
+
+TEST(RenderTimeEstimator, estimate_adapts_to_measured_render_times)
+{
+    mgg::RenderTimeEstimator estimator{50ms};
+
+    for (int i = 0; i != 120; ++i)
+        estimator.record(4ms);
+
+    EXPECT_LT(estimator.estimate(), 10ms);
+    EXPECT_GE(estimator.estimate(), 4ms);
+}
+
+TEST(RenderTimeEstimator, occasional_slow_frame_does_not_inflate_estimate)
+{
+    mgg::RenderTimeEstimator estimator{50ms};
+
+    for (int i = 0; i != 120; ++i)
+        estimator.record(i == 60 ? 30ms : 4ms);
+
+    EXPECT_LT(estimator.estimate(), 10ms);
+}
+
+TEST(RenderTimeEstimator, frequently_slow_frames_raise_estimate)
+{
+    mgg::RenderTimeEstimator estimator{50ms};
+
+    for (int i = 0; i != 120; ++i)
+        estimator.record(i % 10 == 0 ? 12ms : 4ms);
+
+    EXPECT_GE(estimator.estimate(), 12ms);
+}
+
+TEST(RenderTimeEstimator, estimate_rounds_partial_milliseconds_up)
+{
+    mgg::RenderTimeEstimator estimator{50ms};
+
+    for (int i = 0; i != 120; ++i)
+        estimator.record(4100us);
+
+    EXPECT_GE(estimator.estimate(), 5ms);
+}
+
+TEST(RenderTimeEstimator, old_frames_age_out_of_the_estimate)
+{
+    mgg::RenderTimeEstimator estimator{50ms};
+
+    for (int i = 0; i != 120; ++i)
+        estimator.record(20ms);
+    for (int i = 0; i != 120; ++i)
+        estimator.record(4ms);
+
+    EXPECT_LT(estimator.estimate(), 10ms);
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/platforms/gbm-kms/server/kms/vblank_clock.h"
+
+#include <gtest/gtest.h>
+
+namespace mg = mir::graphics;
+namespace mgg = mir::graphics::gbm;
+using namespace std::chrono_literals;
+
+namespace
+{
+auto vblank(int64_t msc, std::chrono::nanoseconds ust) -> mg::Frame
+{
+    mg::Frame frame;
+    frame.msc = msc;
+    frame.ust = {CLOCK_MONOTONIC, ust};
+    return frame;
+}
+
+auto at(std::chrono::nanoseconds ns) -> mg::Frame::Timestamp
+{
+    return {CLOCK_MONOTONIC, ns};
+}
+}
+
+TEST(VblankClock, predicts_nothing_before_any_flip)
+{
+    mgg::VblankClock clock;
+
+    clock.record(mg::Frame{}, 16ms);
+
+    EXPECT_FALSE(clock.next_after(at(1s)));
+}
+
+TEST(VblankClock, next_vblank_follows_last_flip_by_nominal_interval)
+{
+    mgg::VblankClock clock;
+
+    clock.record(vblank(100, 1s), 16ms);
+
+    EXPECT_EQ(at(1s + 16ms), clock.next_after(at(1s + 1ms)));
+}
+
+TEST(VblankClock, measures_interval_from_consecutive_flips)
+{
+    mgg::VblankClock clock;
+
+    clock.record(vblank(100, 1000us), 16ms);
+    clock.record(vblank(102, 1000us + 2 * 16667us), 16ms);
+
+    EXPECT_EQ(16667us, clock.interval());
+    EXPECT_EQ(at(1000us + 3 * 16667us), clock.next_after(at(1000us + 2 * 16667us)));
+}
+
+TEST(VblankClock, implausible_measurement_falls_back_to_nominal_interval)
+{
+    mgg::VblankClock clock;
+
+    clock.record(vblank(100, 1s), 16ms);
+    clock.record(vblank(101, 2s), 16ms);
+
+    EXPECT_EQ(16ms, clock.interval());
+}
+
+TEST(VblankClock, stays_in_phase_across_missed_vblanks)
+{
+    mgg::VblankClock clock;
+
+    clock.record(vblank(100, 1s), 10ms);
+
+    EXPECT_EQ(at(1s + 50ms), clock.next_after(at(1s + 45ms)));
+    EXPECT_EQ(at(1s + 60ms), clock.next_after(at(1s + 50ms)));
+}
+
+TEST(VblankClock, predicts_nothing_for_another_clock_domain)
+{
+    mgg::VblankClock clock;
+
+    clock.record(vblank(100, 1s), 16ms);
+
+    EXPECT_FALSE(clock.next_after({CLOCK_REALTIME, 1s}));
+}
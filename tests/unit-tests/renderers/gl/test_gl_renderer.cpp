@@ -316,6 +316,38 @@ TEST_F(GLRenderer, dont_set_scissor_test_when_unnecessary)
 }
 
 
+TEST_F(GLRenderer, redraws_everything_after_being_suspended)
+{
+    mir::geometry::Rectangle const view_area{{0,0}, {1920,1080}};
+
+    ON_CALL(mock_egl, eglQuerySurface(_,_,EGL_WIDTH,_))
+        .WillByDefault(DoAll(SetArgPointee<3>(view_area.size.width.as_int()),
+                             Return(EGL_TRUE)));
+    ON_CALL(mock_egl, eglQuerySurface(_,_,EGL_HEIGHT,_))
+        .WillByDefault(DoAll(SetArgPointee<3>(view_area.size.height.as_int()),
+                             Return(EGL_TRUE)));
+    ON_CALL(mock_display_buffer, view_area())
+        .WillByDefault(Return(view_area));
+    ON_CALL(mock_display_buffer, buffer_age())
+        .WillByDefault(Return(1));
+
+    mrg::Renderer renderer(mock_display_buffer);
+    mir::geometry::Rectangles const damage{{{10, 10}, {20, 20}}};
+
+    // Only the second frame knows what is in the back buffer, so only it is scissored
+    EXPECT_CALL(mock_gl, glEnable(GL_SCISSOR_TEST)).Times(1);
+
+    renderer.set_damage(damage);
+    renderer.render(renderable_list);
+    renderer.set_damage(damage);
+    renderer.render(renderable_list);
+
+    // An overlay frame put something else on screen, which the back buffer lacks
+    renderer.suspend();
+    renderer.set_damage(damage);
+    renderer.render(renderable_list);
+}
+
 TEST_F(GLRenderer, unchanged_viewport_avoids_gl_calls)
 {
     int const screen_width = 1920;
@@ -466,3 +498,32 @@ TEST_F(GLRenderer, sets_viewport_downscaled_wide)
 
     mrg::Renderer renderer(mock_display_buffer);
 }
+
+TEST_F(GLRenderer, uploads_all_vertices_of_a_frame_at_once)
+{
+    renderable_list.push_back(renderable);
+    renderable_list.push_back(renderable);
+
+    EXPECT_CALL(mock_gl, glBufferData(GL_ARRAY_BUFFER, 3 * 4 * sizeof(mgl::Vertex), _, _));
+    EXPECT_CALL(mock_gl, glDrawArrays(_, 0, 4));
+    EXPECT_CALL(mock_gl, glDrawArrays(_, 4, 4));
+    EXPECT_CALL(mock_gl, glDrawArrays(_, 8, 4));
+
+    mrg::Renderer renderer(display_buffer);
+
+    renderer.render(renderable_list);
+}
+
+TEST_F(GLRenderer, avoids_redundant_state_changes_between_similar_renderables)
+{
+    renderable_list.push_back(renderable);
+
+    EXPECT_CALL(mock_gl, glUseProgram(_)).Times(1);
+    EXPECT_CALL(mock_gl, glDisable(GL_BLEND)).Times(1);
+    EXPECT_CALL(mock_gl, glEnableVertexAttribArray(_)).Times(2);
+    EXPECT_CALL(mock_gl, glVertexAttribPointer(_, _, _, _, _, _)).Times(2);
+
+    mrg::Renderer renderer(display_buffer);
+
+    renderer.render(renderable_list);
+}
@@ -0,0 +1,195 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/renderers/gl/program_binary_cache.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <cstdint>
+#include <fstream>
+#include <system_error>
+
+namespace mrg = mir::renderer::gl;
+using namespace testing;
+
+namespace
+{
+char const* const vertex_src = "vertex shader";
+char const* const fragment_src = "fragment shader";
+char const* const driver = "Vendor\nRenderer\n1.2.3\n";
+
+class ProgramBinaryCache : public Test
+{
+public:
+    ProgramBinaryCache()
+    {
+        char tmp_name[] = "/tmp/mir_program_cache_XXXXXX";
+        if (mkdtemp(tmp_name) == nullptr)
+        {
+            throw std::system_error{errno, std::system_category(), "Failed to create temporary directory"};
+        }
+        temporary_directory = tmp_name;
+        cache_directory = temporary_directory + "/mir/gl-programs";
+    }
+
+    ~ProgramBinaryCache()
+    {
+        for (auto const& dir : {cache_directory, temporary_directory + "/mir"})
+        {
+            if (auto const d = opendir(dir.c_str()))
+            {
+                while (auto const entry = readdir(d))
+                    unlink((dir + "/" + entry->d_name).c_str());
+                closedir(d);
+            }
+            rmdir(dir.c_str());
+        }
+        rmdir(temporary_directory.c_str());
+    }
+
+    /// The one file in the cache directory
+    auto cache_file() const -> std::string
+    {
+        std::string path;
+        if (auto const d = opendir(cache_directory.c_str()))
+        {
+            while (auto const entry = readdir(d))
+            {
+                if (entry->d_name[0] != '.')
+                    path = cache_directory + "/" + entry->d_name;
+            }
+            closedir(d);
+        }
+        return path;
+    }
+
+    std::string temporary_directory;
+    std::string cache_directory;
+    mrg::ProgramBinaryCache::Binary const binary{0x1234, {'b', 'l', 'o', 'b'}};
+};
+}
+
+TEST_F(ProgramBinaryCache, has_nothing_before_storing)
+{
+    mrg::ProgramBinaryCache cache{cache_directory};
+
+    EXPECT_FALSE(cache.load(driver, vertex_src, fragment_src));
+}
+
+TEST_F(ProgramBinaryCache, loads_stored_binary)
+{
+    mrg::ProgramBinaryCache cache{cache_directory};
+
+    cache.store(driver, vertex_src, fragment_src, binary);
+    auto const loaded = cache.load(driver, vertex_src, fragment_src);
+
+    ASSERT_TRUE(loaded);
+    EXPECT_THAT(loaded.value().format, Eq(binary.format));
+    EXPECT_THAT(loaded.value().data, ContainerEq(binary.data));
+}
+
+TEST_F(ProgramBinaryCache, loads_binary_stored_by_another_instance)
+{
+    mrg::ProgramBinaryCache{cache_directory}.store(driver, vertex_src, fragment_src, binary);
+
+    mrg::ProgramBinaryCache cache{cache_directory};
+
+    EXPECT_TRUE(cache.load(driver, vertex_src, fragment_src));
+}
+
+TEST_F(ProgramBinaryCache, ignores_binary_from_another_driver)
+{
+    mrg::ProgramBinaryCache{cache_directory}.store(driver, vertex_src, fragment_src, binary);
+
+    mrg::ProgramBinaryCache cache{cache_directory};
+
+    EXPECT_FALSE(cache.load("Vendor\nRenderer\n1.2.4\n", vertex_src, fragment_src));
+}
+
+TEST_F(ProgramBinaryCache, ignores_binary_of_other_sources)
+{
+    mrg::ProgramBinaryCache cache{cache_directory};
+
+    cache.store(driver, vertex_src, fragment_src, binary);
+
+    EXPECT_FALSE(cache.load(driver, vertex_src, "another fragment shader"));
+    EXPECT_FALSE(cache.load(driver, "another vertex shader", fragment_src));
+}
+
+TEST_F(ProgramBinaryCache, ignores_file_claiming_an_oversized_binary)
+{
+    mrg::ProgramBinaryCache{cache_directory}.store(driver, vertex_src, fragment_src, binary);
+
+    {
+        // The size of the binary immediately precedes its data, at the end of the file
+        std::fstream file{cache_file(), std::ios::binary | std::ios::in | std::ios::out};
+        file.seekp(-static_cast<std::streamoff>(binary.data.size() + sizeof(uint64_t)), std::ios::end);
+        uint64_t const size = UINT64_MAX;
+        file.write(reinterpret_cast<char const*>(&size), sizeof size);
+    }
+
+    mrg::ProgramBinaryCache cache{cache_directory};
+
+    EXPECT_FALSE(cache.load(driver, vertex_src, fragment_src));
+}
+
+TEST_F(ProgramBinaryCache, ignores_truncated_file)
+{
+    mrg::ProgramBinaryCache{cache_directory}.store(driver, vertex_src, fragment_src, binary);
+
+    auto const path = cache_file();
+    auto const length = std::ifstream{path, std::ios::binary | std::ios::ate}.tellg();
+    ASSERT_THAT(truncate(path.c_str(), length - 1), Eq(0));
+
+    mrg::ProgramBinaryCache cache{cache_directory};
+
+    EXPECT_FALSE(cache.load(driver, vertex_src, fragment_src));
+}
+
+TEST_F(ProgramBinaryCache, forgets_discarded_binary)
+{
+    mrg::ProgramBinaryCache cache{cache_directory};
+
+    cache.store(driver, vertex_src, fragment_src, binary);
+    cache.discard(driver, vertex_src, fragment_src);
+
+    EXPECT_FALSE(cache.load(driver, vertex_src, fragment_src));
+}
+
+TEST_F(ProgramBinaryCache, keeps_binaries_in_memory_without_a_directory)
+{
+    mrg::ProgramBinaryCache cache{std::experimental::nullopt};
+
+    cache.store(driver, vertex_src, fragment_src, binary);
+
+    EXPECT_TRUE(cache.load(driver, vertex_src, fragment_src));
+    EXPECT_FALSE(cache.load("Vendor\nRenderer\n1.2.4\n", vertex_src, fragment_src));
+}
+
+TEST_F(ProgramBinaryCache, default_directory_can_be_overridden_or_disabled)
+{
+    setenv("MIR_GL_PROGRAM_CACHE_DIR", cache_directory.c_str(), true);
+    EXPECT_THAT(mrg::ProgramBinaryCache::default_directory().value_or(""), Eq(cache_directory));
+
+    setenv("MIR_GL_PROGRAM_CACHE_DIR", "", true);
+    EXPECT_FALSE(mrg::ProgramBinaryCache::default_directory());
+
+    unsetenv("MIR_GL_PROGRAM_CACHE_DIR");
+}
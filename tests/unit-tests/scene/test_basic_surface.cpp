@@ -23,6 +23,7 @@
 #include "mir/events/event_private.h"
 #include "mir/frontend/event_sink.h"
 #include "mir/geometry/rectangle.h"
+#include "mir/geometry/rectangles.h"
 #include "mir/geometry/displacement.h"
 #include "mir/scene/null_surface_observer.h"
 #include "mir/events/event_builders.h"
@@ -1545,6 +1546,30 @@ TEST_F(BasicSurfaceTest, renderables_of_transparent_buffer_streams_are_shaped)
     EXPECT_THAT(renderables[1]->shaped(), true);
 }
 
+TEST_F(BasicSurfaceTest, renderables_have_stream_opaque_region_in_screen_coordinates)
+{
+    using namespace testing;
+    auto buffer_stream = std::make_shared<NiceMock<mtd::MockBufferStream>>();
+    geom::Displacement d0{0,0};
+    geom::Displacement d1{19,99};
+    ON_CALL(*buffer_stream, stream_size())
+        .WillByDefault(Return(geom::Size{100, 100}));
+
+    std::list<ms::StreamInfo> streams = {
+        { mock_buffer_stream, d0, {} },
+        { buffer_stream, d1, {}, {{{10, 10}, {20, 20}}, {{90, 90}, {20, 20}}} },
+    };
+    surface.set_streams(streams);
+
+    auto renderables = surface.generate_renderables(this);
+    ASSERT_THAT(renderables.size(), Eq(2));
+    auto const top_left = renderables[1]->screen_position().top_left;
+    EXPECT_THAT(renderables[0]->opaque_region(), Eq(geom::Rectangles{}));
+    EXPECT_THAT(renderables[1]->opaque_region(), Eq(geom::Rectangles{
+        {top_left + geom::Displacement{10, 10}, {20, 20}},
+        {top_left + geom::Displacement{90, 90}, {10, 10}}}));
+}
+
 namespace
 {
 struct VisibilityObserver : ms::NullSurfaceObserver
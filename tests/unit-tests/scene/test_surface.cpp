@@ -320,10 +320,12 @@ TEST_F(SurfaceCreation, consume_calls_send_event)
         std::shared_ptr<mg::CursorImage>(),
         report);
 
-    auto key_event = mev::make_event(MirInputDeviceId(0), std::chrono::nanoseconds(0), std::vector<uint8_t>{},
-                                     mir_keyboard_action_down, 0, 0, mir_input_event_modifier_none);
-    auto touch_event = mev::make_event(MirInputDeviceId(0), std::chrono::nanoseconds(0), std::vector<uint8_t>{},
-                                       mir_input_event_modifier_none);
+    std::shared_ptr<MirEvent> key_event = mev::make_event(
+        MirInputDeviceId(0), std::chrono::nanoseconds(0), std::vector<uint8_t>{},
+        mir_keyboard_action_down, 0, 0, mir_input_event_modifier_none);
+    std::shared_ptr<MirEvent> touch_event = mev::make_event(
+        MirInputDeviceId(0), std::chrono::nanoseconds(0), std::vector<uint8_t>{},
+        mir_input_event_modifier_none);
     mev::add_touch(*touch_event, 0, mir_touch_action_down, mir_touch_tooltype_finger, 0, 0,
         0, 0, 0, 0);
 
@@ -336,6 +338,6 @@ TEST_F(SurfaceCreation, consume_calls_send_event)
     EXPECT_CALL(*mock_event_sink, handle_event(mt::MirKeyboardEventMatches(key_event.get()))).Times(1);
     EXPECT_CALL(*mock_event_sink, handle_event(mt::MirTouchEventMatches(touch_event.get()))).Times(1);
 
-    surface.consume(key_event.get());
-    surface.consume(touch_event.get());
+    surface.consume(key_event);
+    surface.consume(touch_event);
 }
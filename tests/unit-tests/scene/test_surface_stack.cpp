@@ -342,6 +342,80 @@ TEST_F(SurfaceStack, scene_doesnt_count_pending_frames_from_partially_exposed_su
     EXPECT_EQ(0, stack.frames_pending(comp2));
 }
 
+TEST_F(SurfaceStack, scene_counts_pending_frames_posted_before_surface_was_added)
+{
+    using namespace testing;
+
+    ms::SurfaceStack stack{report};
+    stack.register_compositor(this);
+    auto stream = std::make_shared<mtd::StubBufferStream>();
+    auto surface = std::make_shared<ms::BasicSurface>(
+        nullptr /* session */,
+        std::string("stub"),
+        geom::Rectangle{{},{}},
+        mir_pointer_unconfined,
+        std::list<ms::StreamInfo> { { stream, {}, {} } },
+        std::shared_ptr<mg::CursorImage>(),
+        report);
+
+    post_a_frame(*stream);
+    stack.add_surface(surface, default_params.input_mode);
+
+    EXPECT_EQ(1, stack.frames_pending(this));
+}
+
+TEST_F(SurfaceStack, scene_counts_pending_frames_of_surface_once_shown)
+{
+    using namespace testing;
+
+    ms::SurfaceStack stack{report};
+    stack.register_compositor(this);
+    auto stream = std::make_shared<mtd::StubBufferStream>();
+    auto surface = std::make_shared<ms::BasicSurface>(
+        nullptr /* session */,
+        std::string("stub"),
+        geom::Rectangle{{},{}},
+        mir_pointer_unconfined,
+        std::list<ms::StreamInfo> { { stream, {}, {} } },
+        std::shared_ptr<mg::CursorImage>(),
+        report);
+
+    stack.add_surface(surface, default_params.input_mode);
+    surface->hide();
+    post_a_frame(*stream);
+
+    EXPECT_EQ(0, stack.frames_pending(this));
+
+    surface->show();
+
+    EXPECT_EQ(1, stack.frames_pending(this));
+}
+
+TEST_F(SurfaceStack, scene_does_not_ask_idle_surfaces_for_pending_frames)
+{
+    using namespace testing;
+
+    ms::SurfaceStack stack{report};
+    stack.register_compositor(this);
+    auto stream = std::make_shared<NiceMock<mtd::MockBufferStream>>();
+    ON_CALL(*stream, buffers_ready_for_compositor(_)).WillByDefault(Return(0));
+    auto surface = std::make_shared<ms::BasicSurface>(
+        nullptr /* session */,
+        std::string("stub"),
+        geom::Rectangle{{},{}},
+        mir_pointer_unconfined,
+        std::list<ms::StreamInfo> { { stream, {}, {} } },
+        std::shared_ptr<mg::CursorImage>(),
+        report);
+
+    stack.add_surface(surface, default_params.input_mode);
+    EXPECT_EQ(0, stack.frames_pending(this));
+
+    EXPECT_CALL(*stream, buffers_ready_for_compositor(_)).Times(0);
+    EXPECT_EQ(0, stack.frames_pending(this));
+    EXPECT_EQ(0, stack.frames_pending(this));
+}
+
 TEST_F(SurfaceStack, surfaces_are_emitted_by_layer)
 {
     using namespace testing;
@@ -646,6 +720,25 @@ TEST_F(SurfaceStack, scene_elements_hold_snapshot_of_positioning_info)
         EXPECT_THAT(changed_position, testing::Ne(element->renderable()->screen_position().top_left));
 }
 
+TEST_F(SurfaceStack, released_scene_elements_release_renderables)
+{
+    using namespace testing;
+
+    stack.add_surface(stub_surface1, default_params.input_mode);
+    stack.register_compositor(compositor_id);
+
+    std::weak_ptr<mg::Renderable> renderable;
+    {
+        auto const elements = stack.scene_elements_for(compositor_id);
+        ASSERT_THAT(elements.size(), Eq(1u));
+        renderable = elements.front()->renderable();
+    }
+
+    EXPECT_TRUE(renderable.expired());
+
+    stack.unregister_compositor(compositor_id);
+}
+
 TEST_F(SurfaceStack, generates_scene_elements_that_delay_buffer_acquisition)
 {
     using namespace testing;
@@ -717,6 +810,48 @@ struct MockConfigureSurface : public ms::BasicSurface
     }
     MOCK_METHOD2(configure, int(MirWindowAttrib, int));
 };
+
+struct SurfaceWithAddObserverHook : public ms::BasicSurface
+{
+    SurfaceWithAddObserverHook() :
+        ms::BasicSurface(
+            {},
+            {},
+            {{},{}},
+            mir_pointer_unconfined,
+            std::list<ms::StreamInfo> { { std::make_shared<mtd::StubBufferStream>(), {}, {} } },
+            {},
+            mir::report::null_scene_report())
+    {
+    }
+
+    void add_observer(std::shared_ptr<ms::SurfaceObserver> const& observer) override
+    {
+        ms::BasicSurface::add_observer(observer);
+        on_add_observer();
+    }
+
+    std::function<void()> on_add_observer = []{};
+};
+}
+
+TEST_F(SurfaceStack, compositor_is_not_blocked_while_the_stack_is_changing)
+{
+    using namespace testing;
+
+    auto const surface = std::make_shared<SurfaceWithAddObserverHook>();
+    std::future<mc::SceneElementSequence> elements;
+
+    // SurfaceStack adds its observer while it is changing the stack
+    surface->on_add_observer = [&]
+        {
+            elements = std::async(std::launch::async, [&]{ return stack.scene_elements_for(compositor_id); });
+            EXPECT_THAT(elements.wait_for(std::chrono::seconds{5}), Eq(std::future_status::ready));
+        };
+
+    stack.add_surface(surface, default_params.input_mode);
+
+    EXPECT_THAT(elements.get().size(), Eq(1u));
 }
 
 TEST_F(SurfaceStack, occludes_not_rendered_surface)
@@ -1019,6 +1154,79 @@ TEST_F(SurfaceStack, returns_top_visible_surface_under_cursor)
     EXPECT_THAT(stack.surface_at(cursor_over_none).get(), IsNull());
 }
 
+TEST_F(SurfaceStack, surface_under_cursor_follows_moves)
+{
+    stack.add_surface(stub_surface1, default_params.input_mode);
+    stack.add_surface(stub_surface2, default_params.input_mode);
+
+    stub_surface1->resize({100, 100});
+    stub_surface2->resize({100, 100});
+
+    stub_surface2->move_to({1000, 1000});
+
+    EXPECT_THAT(stack.surface_at({50, 50}), Eq(stub_surface1));
+    EXPECT_THAT(stack.surface_at({1050, 1050}), Eq(stub_surface2));
+
+    stub_surface2->move_to({0, 0});
+
+    EXPECT_THAT(stack.surface_at({50, 50}), Eq(stub_surface2));
+    EXPECT_THAT(stack.surface_at({1050, 1050}).get(), IsNull());
+}
+
+TEST_F(SurfaceStack, surface_under_cursor_follows_raise)
+{
+    stack.add_surface(stub_surface1, default_params.input_mode);
+    stack.add_surface(stub_surface2, default_params.input_mode);
+
+    stub_surface1->resize({100, 100});
+    stub_surface2->resize({100, 100});
+
+    EXPECT_THAT(stack.surface_at({50, 50}), Eq(stub_surface2));
+
+    stack.raise(stub_surface1);
+
+    EXPECT_THAT(stack.surface_at({50, 50}), Eq(stub_surface1));
+}
+
+TEST_F(SurfaceStack, surface_under_cursor_respects_input_region)
+{
+    stack.add_surface(stub_surface1, default_params.input_mode);
+    stack.add_surface(stub_surface2, default_params.input_mode);
+
+    stub_surface1->resize({600, 600});
+    stub_surface2->resize({600, 600});
+
+    stub_surface2->set_input_region({{{500, 500}, {100, 100}}});
+
+    EXPECT_THAT(stack.surface_at({50, 50}), Eq(stub_surface1));
+    EXPECT_THAT(stack.surface_at({550, 550}), Eq(stub_surface2));
+}
+
+TEST_F(SurfaceStack, removed_surface_is_not_under_cursor)
+{
+    stack.add_surface(stub_surface1, default_params.input_mode);
+    stub_surface1->resize({100, 100});
+
+    stack.remove_surface(stub_surface1);
+
+    EXPECT_THAT(stack.surface_at({50, 50}).get(), IsNull());
+}
+
+TEST_F(SurfaceStack, input_surface_at_matches_surface_at)
+{
+    stack.add_surface(stub_surface1, default_params.input_mode);
+    stack.add_surface(stub_surface2, default_params.input_mode);
+
+    stub_surface1->resize({900, 900});
+    stub_surface2->resize({500, 200});
+
+    mi::Scene& input_scene = stack;
+
+    EXPECT_THAT(input_scene.input_surface_at({100, 100}), Eq(stub_surface2));
+    EXPECT_THAT(input_scene.input_surface_at({600, 600}), Eq(stub_surface1));
+    EXPECT_THAT(input_scene.input_surface_at({999, 999}).get(), IsNull());
+}
+
 TEST_F(SurfaceStack, raise_surfaces_to_top)
 {
     stack.add_surface(stub_surface1, default_params.input_mode);
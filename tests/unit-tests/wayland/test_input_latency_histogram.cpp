@@ -0,0 +1,94 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/frontend_wayland/input_latency_tracker.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace mf = mir::frontend;
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+TEST(InputLatencyHistogram, is_empty_initially)
+{
+    mf::InputLatencyHistogram histogram;
+
+    EXPECT_THAT(histogram.count(), Eq(0u));
+    EXPECT_THAT(histogram.max(), Eq(0ns));
+}
+
+TEST(InputLatencyHistogram, percentiles_are_bucket_upper_bounds)
+{
+    mf::InputLatencyHistogram histogram;
+
+    for (int i = 0; i != 90; ++i)
+        histogram.record(5500us);
+    for (int i = 0; i != 9; ++i)
+        histogram.record(20200us);
+    histogram.record(48ms);
+
+    EXPECT_THAT(histogram.count(), Eq(100u));
+    EXPECT_THAT(histogram.percentile(50), Eq(6ms));
+    EXPECT_THAT(histogram.percentile(90), Eq(6ms));
+    EXPECT_THAT(histogram.percentile(99), Eq(21ms));
+    EXPECT_THAT(histogram.percentile(100), Eq(49ms));
+    EXPECT_THAT(histogram.max(), Eq(48ms));
+}
+
+TEST(InputLatencyHistogram, long_latencies_land_in_the_last_bucket)
+{
+    mf::InputLatencyHistogram histogram;
+
+    histogram.record(3s);
+
+    EXPECT_THAT(histogram.percentile(50), Eq(100ms));
+    EXPECT_THAT(histogram.max(), Eq(3s));
+}
+
+TEST(InputLatencyHistogram, summary_reports_percentiles)
+{
+    mf::InputLatencyHistogram histogram;
+
+    histogram.record(7300us);
+
+    EXPECT_THAT(histogram.summary(), HasSubstr("1 responses"));
+    EXPECT_THAT(histogram.summary(), HasSubstr("p50 <8ms"));
+    EXPECT_THAT(histogram.summary(), HasSubstr("max 7.3ms"));
+}
+
+TEST(InputLatencyHistogram, summary_reports_last_bucket_without_an_upper_bound)
+{
+    mf::InputLatencyHistogram histogram;
+
+    histogram.record(99500us);
+    histogram.record(3s);
+
+    EXPECT_THAT(histogram.summary(), HasSubstr("p50 ≥99ms"));
+    EXPECT_THAT(histogram.summary(), Not(HasSubstr("<100ms")));
+}
+
+TEST(InputLatencyHistogram, reset_clears_everything)
+{
+    mf::InputLatencyHistogram histogram;
+
+    histogram.record(12ms);
+    histogram.reset();
+
+    EXPECT_THAT(histogram.count(), Eq(0u));
+    EXPECT_THAT(histogram.max(), Eq(0ns));
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/frontend_wayland/keymap_cache.h"
+#include "mir/input/keymap.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <unistd.h>
+
+namespace mf = mir::frontend;
+namespace mi = mir::input;
+
+using namespace testing;
+
+TEST(KeymapCache, compiles_each_keymap_once)
+{
+    mf::KeymapCache cache;
+
+    auto const first = cache.get(mi::Keymap{});
+    auto const second = cache.get(mi::Keymap{});
+
+    EXPECT_THAT(second, Eq(first));
+}
+
+TEST(KeymapCache, compiles_different_keymaps_separately)
+{
+    mf::KeymapCache cache;
+
+    auto const us = cache.get(mi::Keymap{"pc105", "us", "", ""});
+    auto const gb = cache.get(mi::Keymap{"pc105", "gb", "", ""});
+
+    EXPECT_THAT(gb, Ne(us));
+    EXPECT_THAT(gb->keymap, Ne(us->keymap));
+}
+
+TEST(KeymapCache, provides_keymap_text)
+{
+    mf::KeymapCache cache;
+
+    auto const compiled = cache.get(mi::Keymap{});
+
+    EXPECT_THAT(compiled->text, HasSubstr("xkb_keymap"));
+}
+
+TEST(KeymapCache, sealed_file_holds_keymap_text_and_cannot_be_written)
+{
+    mf::KeymapCache cache;
+
+    auto const compiled = cache.get(mi::Keymap{});
+    ASSERT_THAT(compiled->sealed_file, Ne(mir::Fd::invalid));
+
+    std::string contents(compiled->text.size(), '\0');
+    ASSERT_THAT(pread(compiled->sealed_file, &contents[0], contents.size(), 0), Eq(ssize_t(contents.size())));
+    EXPECT_THAT(contents, Eq(compiled->text));
+
+    EXPECT_THAT(pwrite(compiled->sealed_file, "x", 1, 0), Eq(-1));
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/frontend_wayland/pointer_motion_coalescer.h"
+
+#include "mir/events/event_builders.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace mf = mir::frontend;
+namespace mev = mir::events;
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+auto pointer_event(
+    MirPointerAction action,
+    float x, float y,
+    float dx, float dy,
+    MirPointerButtons buttons = 0,
+    float vscroll = 0) -> std::shared_ptr<MirEvent const>
+{
+    static std::chrono::nanoseconds time{0};
+    time += 1ms;
+    return mev::make_event(
+        MirInputDeviceId{0}, time, std::vector<uint8_t>{},
+        mir_input_event_modifier_none, action, buttons,
+        x, y, 0.0f, vscroll, dx, dy);
+}
+
+auto motion(float x, float y, float dx, float dy) -> std::shared_ptr<MirEvent const>
+{
+    return pointer_event(mir_pointer_action_motion, x, y, dx, dy);
+}
+
+auto pointer_of(std::shared_ptr<MirEvent const> const& event) -> MirPointerEvent const*
+{
+    return mir_input_event_get_pointer_event(mir_event_get_input_event(event.get()));
+}
+
+auto axis(std::shared_ptr<MirEvent const> const& event, MirPointerAxis axis) -> float
+{
+    return mir_pointer_event_axis_value(pointer_of(event), axis);
+}
+
+auto event_time(std::shared_ptr<MirEvent const> const& event) -> int64_t
+{
+    return mir_input_event_get_event_time(mir_event_get_input_event(event.get()));
+}
+
+struct PointerMotionCoalescer : Test
+{
+    mf::PointerMotionCoalescer coalescer;
+};
+}
+
+TEST_F(PointerMotionCoalescer, first_motion_is_queued)
+{
+    auto const queued = coalescer.queue(motion(1, 1, 1, 1));
+
+    ASSERT_THAT(queued, NotNull());
+    EXPECT_THAT(axis(queued, mir_pointer_axis_x), Eq(1));
+}
+
+TEST_F(PointerMotionCoalescer, motion_is_merged_into_queued_motion)
+{
+    auto const queued = coalescer.queue(motion(1, 1, 1, 1));
+    auto const latest = motion(4, 6, 3, 5);
+
+    EXPECT_THAT(coalescer.queue(latest), IsNull());
+
+    EXPECT_THAT(axis(queued, mir_pointer_axis_x), Eq(4));
+    EXPECT_THAT(axis(queued, mir_pointer_axis_y), Eq(6));
+    EXPECT_THAT(axis(queued, mir_pointer_axis_relative_x), Eq(4));
+    EXPECT_THAT(axis(queued, mir_pointer_axis_relative_y), Eq(6));
+    EXPECT_THAT(event_time(queued), Eq(event_time(latest)));
+}
+
+TEST_F(PointerMotionCoalescer, motion_is_not_merged_into_dequeued_motion)
+{
+    auto const first = coalescer.queue(motion(1, 1, 1, 1));
+    coalescer.dequeue(first);
+
+    auto const second = coalescer.queue(motion(2, 2, 1, 1));
+
+    ASSERT_THAT(second, NotNull());
+    EXPECT_THAT(axis(first, mir_pointer_axis_x), Eq(1));
+    EXPECT_THAT(axis(first, mir_pointer_axis_relative_x), Eq(1));
+}
+
+TEST_F(PointerMotionCoalescer, motion_is_not_merged_across_button_events)
+{
+    auto const first = coalescer.queue(motion(1, 1, 1, 1));
+    auto const button = pointer_event(mir_pointer_action_button_down, 1, 1, 0, 0, mir_pointer_button_primary);
+
+    EXPECT_THAT(coalescer.queue(button), Eq(button));
+    EXPECT_THAT(coalescer.queue(motion(2, 2, 1, 1)), NotNull());
+    EXPECT_THAT(axis(first, mir_pointer_axis_x), Eq(1));
+}
+
+TEST_F(PointerMotionCoalescer, scroll_events_are_not_merged)
+{
+    coalescer.queue(motion(1, 1, 1, 1));
+    auto const scroll = pointer_event(mir_pointer_action_motion, 1, 1, 0, 0, 0, 1.0f);
+
+    EXPECT_THAT(coalescer.queue(scroll), Eq(scroll));
+}
+
+TEST_F(PointerMotionCoalescer, motion_with_different_buttons_is_not_merged)
+{
+    coalescer.queue(motion(1, 1, 1, 1));
+    auto const drag = pointer_event(mir_pointer_action_motion, 2, 2, 1, 1, mir_pointer_button_primary);
+
+    EXPECT_THAT(coalescer.queue(drag), NotNull());
+}
+
+TEST_F(PointerMotionCoalescer, queued_motion_is_a_copy)
+{
+    auto const original = motion(1, 1, 1, 1);
+    auto const queued = coalescer.queue(original);
+    coalescer.queue(motion(2, 2, 1, 1));
+
+    EXPECT_THAT(queued, Ne(original));
+    EXPECT_THAT(axis(original, mir_pointer_axis_x), Eq(1));
+}
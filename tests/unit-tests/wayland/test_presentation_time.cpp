@@ -0,0 +1,309 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/frontend_wayland/presentation_time.h"
+
+#include "mir/executor.h"
+#include "mir/graphics/frame.h"
+
+#include <wayland-server-core.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <deque>
+#include <string>
+#include <thread>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace mir
+{
+namespace wayland
+{
+extern struct wl_interface const wp_presentation_feedback_interface_data;
+}
+}
+
+namespace mf = mir::frontend;
+namespace mg = mir::graphics;
+namespace mw = mir::wayland;
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+class QueuedExecutor : public mir::Executor
+{
+public:
+    void spawn(std::function<void()>&& work) override
+    {
+        queue.push_back(std::move(work));
+    }
+
+    void run_queued()
+    {
+        while (!queue.empty())
+        {
+            auto const work = std::move(queue.front());
+            queue.pop_front();
+            work();
+        }
+    }
+
+private:
+    std::deque<std::function<void()>> queue;
+};
+
+struct Event
+{
+    wl_resource* resource;
+    std::string name;
+    std::vector<uint32_t> args;
+};
+
+MATCHER_P2(EventFor, resource, name, "")
+{
+    return arg.resource == resource && arg.name == name;
+}
+
+MATCHER_P2(PresentedWith, refresh_ns, msc, "")
+{
+    // presented(tv_sec_hi, tv_sec_lo, tv_nsec, refresh, seq_hi, seq_lo, flags)
+    return arg.name == "presented" && arg.args.size() == 7 && arg.args[3] == refresh_ns && arg.args[5] == msc;
+}
+
+auto another_thread_id() -> std::thread::id
+{
+    std::thread thread{[]{}};
+    auto const id = thread.get_id();
+    thread.join();
+    return id;
+}
+
+auto frame_at(int64_t msc, std::chrono::nanoseconds ust) -> mg::Frame
+{
+    mg::Frame frame;
+    frame.msc = msc;
+    frame.ust = {CLOCK_MONOTONIC, ust};
+    return frame;
+}
+
+struct PresentationTime : Test
+{
+    PresentationTime()
+    {
+        socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds);
+        client = wl_client_create(display, fds[0]);
+        logger = wl_display_add_protocol_logger(display, &log_event, this);
+    }
+
+    ~PresentationTime()
+    {
+        wl_protocol_logger_destroy(logger);
+        wl_client_destroy(client);
+        wl_display_destroy(display);
+        close(fds[1]);
+    }
+
+    auto make_feedback() -> std::shared_ptr<mf::WpPresentationFeedback>
+    {
+        auto const resource = wl_resource_create(client, &mw::wp_presentation_feedback_interface_data, 1, 0);
+        return std::make_shared<mf::WpPresentationFeedback>(resource, tracker);
+    }
+
+    auto events_for(std::shared_ptr<mf::WpPresentationFeedback> const& feedback) const -> std::vector<Event>
+    {
+        std::vector<Event> result;
+        for (auto const& event : events)
+        {
+            if (event.resource == feedback->resource)
+            {
+                result.push_back(event);
+            }
+        }
+        return result;
+    }
+
+    static void log_event(void* data, wl_protocol_logger_type type, wl_protocol_logger_message const* message)
+    {
+        if (type != WL_PROTOCOL_LOGGER_EVENT)
+            return;
+
+        Event event{message->resource, message->message->name, {}};
+        for (int i = 0; i != message->arguments_count; ++i)
+        {
+            event.args.push_back(message->arguments[i].u);
+        }
+        static_cast<PresentationTime*>(data)->events.push_back(event);
+    }
+
+    wl_display* const display{wl_display_create()};
+    int fds[2];
+    wl_client* client;
+    wl_protocol_logger* logger;
+    std::vector<Event> events;
+
+    std::shared_ptr<mf::PresentationTracker> const tracker{std::make_shared<mf::PresentationTracker>()};
+    std::shared_ptr<QueuedExecutor> const executor{std::make_shared<QueuedExecutor>()};
+
+    std::thread::id const compositor{std::this_thread::get_id()};
+    std::thread::id const other_compositor{another_thread_id()};
+    unsigned int const output{1};
+    unsigned int const other_output{2};
+    mg::Frame const frame{frame_at(100, 10s)};
+};
+}
+
+TEST_F(PresentationTime, feedback_is_presented_by_flip_of_output_its_content_was_posted_to)
+{
+    auto const feedback = make_feedback();
+
+    feedback->content_consumed(compositor);
+    tracker->frame_posted(output, compositor);
+    tracker->frame_presented(other_output, frame);
+
+    EXPECT_THAT(events_for(feedback), IsEmpty());
+
+    tracker->frame_presented(output, frame);
+
+    EXPECT_THAT(events_for(feedback), ElementsAre(EventFor(feedback->resource, "presented")));
+}
+
+TEST_F(PresentationTime, feedback_is_not_presented_by_flip_before_its_content_was_posted)
+{
+    auto const feedback = make_feedback();
+
+    feedback->content_consumed(compositor);
+    tracker->frame_presented(output, frame);
+
+    EXPECT_THAT(events_for(feedback), IsEmpty());
+
+    tracker->frame_posted(output, compositor);
+    tracker->frame_presented(output, frame_at(101, 10s + 16ms));
+
+    EXPECT_THAT(events_for(feedback), ElementsAre(PresentedWith(16000000u, 101u)));
+}
+
+TEST_F(PresentationTime, feedback_is_not_presented_by_post_of_another_compositor_thread)
+{
+    auto const feedback = make_feedback();
+
+    feedback->content_consumed(compositor);
+    tracker->frame_posted(output, other_compositor);
+    tracker->frame_presented(output, frame);
+
+    EXPECT_THAT(events_for(feedback), IsEmpty());
+}
+
+TEST_F(PresentationTime, content_consumed_after_a_post_waits_for_the_next_post)
+{
+    auto const first = make_feedback();
+    auto const second = make_feedback();
+
+    first->content_consumed(compositor);
+    tracker->frame_posted(output, compositor);
+    second->content_consumed(compositor);
+    tracker->frame_presented(output, frame);
+
+    EXPECT_THAT(events_for(first), SizeIs(1));
+    EXPECT_THAT(events_for(second), IsEmpty());
+
+    tracker->frame_posted(output, compositor);
+    tracker->frame_presented(output, frame_at(101, 10s + 16ms));
+
+    EXPECT_THAT(events_for(second), SizeIs(1));
+}
+
+TEST_F(PresentationTime, content_posted_to_several_outputs_is_presented_once)
+{
+    auto const feedback = make_feedback();
+
+    feedback->content_consumed(compositor);
+    tracker->frame_posted(output, compositor);
+    tracker->frame_posted(other_output, compositor);
+    tracker->frame_presented(other_output, frame);
+    tracker->frame_presented(output, frame);
+
+    EXPECT_THAT(events_for(feedback), ElementsAre(EventFor(feedback->resource, "presented")));
+}
+
+TEST_F(PresentationTime, refresh_is_only_known_after_consecutive_flips_of_the_same_output)
+{
+    auto const first = make_feedback();
+    auto const second = make_feedback();
+
+    tracker->frame_presented(other_output, frame_at(41, 10s - 8ms));
+
+    first->content_consumed(compositor);
+    tracker->frame_posted(output, compositor);
+    tracker->frame_presented(output, frame_at(100, 10s));
+
+    second->content_consumed(compositor);
+    tracker->frame_posted(output, compositor);
+    tracker->frame_presented(output, frame_at(101, 10s + 16ms));
+
+    EXPECT_THAT(events_for(first), ElementsAre(PresentedWith(0u, 100u)));
+    EXPECT_THAT(events_for(second), ElementsAre(PresentedWith(16000000u, 101u)));
+}
+
+TEST_F(PresentationTime, feedback_is_discarded_when_commit_is_released_unconsumed)
+{
+    auto const feedback = make_feedback();
+
+    std::make_shared<mf::CommitPresentationFeedback>(
+        std::vector<std::shared_ptr<mf::WpPresentationFeedback>>{feedback}, executor).reset();
+    executor->run_queued();
+
+    EXPECT_THAT(events_for(feedback), ElementsAre(EventFor(feedback->resource, "discarded")));
+}
+
+TEST_F(PresentationTime, feedback_is_presented_when_consumed_commit_is_released_before_the_flip)
+{
+    auto const feedback = make_feedback();
+    auto commit = std::make_shared<mf::CommitPresentationFeedback>(
+        std::vector<std::shared_ptr<mf::WpPresentationFeedback>>{feedback}, executor);
+
+    commit->buffer_consumed(compositor);
+    tracker->frame_posted(output, compositor);
+    commit.reset();
+    executor->run_queued();
+
+    EXPECT_THAT(events_for(feedback), IsEmpty());
+
+    tracker->frame_presented(output, frame);
+
+    EXPECT_THAT(events_for(feedback), ElementsAre(EventFor(feedback->resource, "presented")));
+}
+
+TEST_F(PresentationTime, commit_is_presented_by_the_first_output_to_flip_after_any_consumption)
+{
+    auto const feedback = make_feedback();
+    mf::CommitPresentationFeedback commit{{feedback}, executor};
+
+    commit.buffer_consumed(compositor);
+    commit.buffer_consumed(other_compositor);
+    tracker->frame_posted(other_output, other_compositor);
+    tracker->frame_presented(other_output, frame);
+
+    EXPECT_THAT(events_for(feedback), ElementsAre(EventFor(feedback->resource, "presented")));
+
+    tracker->frame_posted(output, compositor);
+    tracker->frame_presented(output, frame);
+
+    EXPECT_THAT(events_for(feedback), SizeIs(1));
+}
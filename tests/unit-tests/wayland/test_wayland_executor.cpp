@@ -159,3 +159,24 @@ TEST_F(WaylandExecutorTest, spawning_is_threadsafe)
 
     EXPECT_THAT(counter, Eq(thread_count));
 }
+
+TEST_F(WaylandExecutorTest, one_dispatch_runs_all_pending_tasks_in_order)
+{
+    mf::WaylandExecutor executor{the_event_loop};
+
+    int const task_count{100};
+    std::vector<int> executed;
+    for (auto i = 0; i < task_count; ++i)
+    {
+        executor.spawn([&executed, i]() { executed.push_back(i); });
+    }
+
+    wl_event_loop_dispatch(the_event_loop, 0);
+
+    ASSERT_THAT(executed.size(), Eq(task_count));
+    for (auto i = 0; i < task_count; ++i)
+    {
+        EXPECT_THAT(executed[i], Eq(i));
+    }
+    EXPECT_THAT(event_loop_fd, Not(FdIsReadable()));
+}